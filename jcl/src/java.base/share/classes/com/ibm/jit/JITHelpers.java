@@ -1237,7 +1237,102 @@ public final class JITHelpers {
 
 	public static native void setForceUsePreexistence();
 
-	private native static final void debugAgentRun(MethodAccessor ma, Object obj, Object[] args);
+	private native static final void debugAgentRun(MethodAccessor ma, Object obj, Object[] args, Throwable failure);
+
+	private native static final String debugAgentFingerprint(Throwable failure);
+
+	/**
+	 * An investigation of the debug agent, shared by every failure with the same fingerprint.
+	 */
+	private static final class DebugAgentInvestigation {
+		/* Investigations run one at a time in the order their failures were caught */
+		final long ticket;
+		boolean done;
+
+		DebugAgentInvestigation(long ticket) {
+			this.ticket = ticket;
+		}
+	}
+
+	private static final Object debugAgentLock = new Object();
+	private static final java.util.HashMap<String, DebugAgentInvestigation> debugAgentInvestigations = new java.util.HashMap<>();
+	private static long debugAgentNextTicket;
+	private static long debugAgentRunningTicket;
+	/* Thread running the investigation in progress, whose test runs may fail through this method again */
+	private static Thread debugAgentInvestigatingThread;
+
+	/**
+	 * Investigates a failure with the debug agent. A failure matching an investigation which is queued, in progress or
+	 * done waits for that investigation rather than starting its own. Other failures are queued and investigated one
+	 * at a time, and the JVM exits once the last queued investigation is done. Failures caught while the test is rerun
+	 * by the investigation in progress are left to that investigation.
+	 *
+	 * @param ma the method to run the debug agent on.
+	 * @param obj the underlying object.
+	 * @param args the arguments for the method
+	 * @param failure the exception the method failed with
+	 */
+	private static void debugAgentInvestigate(MethodAccessor ma, Object obj, Object[] args, Throwable failure) {
+		String fingerprint = debugAgentFingerprint(failure);
+		String threadName = Thread.currentThread().getName();
+		DebugAgentInvestigation investigation;
+		boolean investigate = false;
+		boolean interrupted = false;
+		boolean exit = false;
+
+		synchronized (debugAgentLock) {
+			if (debugAgentInvestigatingThread == Thread.currentThread()) {
+				/* Waiting here would deadlock, the rerun fails back into the investigation in progress instead */
+				return;
+			}
+			investigation = debugAgentInvestigations.get(fingerprint);
+			if (investigation == null) {
+				investigation = new DebugAgentInvestigation(debugAgentNextTicket++);
+				debugAgentInvestigations.put(fingerprint, investigation);
+				investigate = true;
+				System.err.println("Caught " + failure.getClass().getName() + " inside JITHelpers, thread " + threadName
+						+ ", queued investigation " + investigation.ticket + " of failure " + fingerprint);
+			} else {
+				System.err.println("Caught " + failure.getClass().getName() + " inside JITHelpers, thread " + threadName
+						+ ", waiting for investigation " + investigation.ticket + " of the same failure");
+			}
+			while (investigate ? (investigation.ticket != debugAgentRunningTicket) : !investigation.done) {
+				try {
+					debugAgentLock.wait();
+				} catch (InterruptedException e) {
+					interrupted = true;
+				}
+			}
+			if (investigate) {
+				debugAgentInvestigatingThread = Thread.currentThread();
+			}
+		}
+
+		if (investigate) {
+			System.err.println("Starting investigation " + investigation.ticket + " on thread " + threadName);
+			failure.printStackTrace();
+			try {
+				debugAgentRun(ma, obj, args, failure);
+			} finally {
+				/* Let the waiting failures proceed even if the investigation failed */
+				synchronized (debugAgentLock) {
+					investigation.done = true;
+					debugAgentInvestigatingThread = null;
+					debugAgentRunningTicket += 1;
+					exit = (debugAgentRunningTicket == debugAgentNextTicket);
+					debugAgentLock.notifyAll();
+				}
+			}
+			if (exit) {
+				System.err.println("Aborting JVM");
+				System.exit(1);
+			}
+		}
+
+		if (interrupted) {
+			Thread.currentThread().interrupt();
+		}
+	}
 
 	/**
 	 * Invokes the method on the object with the given MethodAccessor and arguments.
@@ -1268,14 +1363,7 @@ public final class JITHelpers {
 					}
 				}
 				if (runDebugAgent) {
-					synchronized (JITHelpers.class) {
-						System.err.println("Caught java.lang.NullPointerException inside JITHelpers, thread "+Thread.currentThread().getName());
-						e.getCause().printStackTrace();
-						debugAgentRun(ma, obj, args);
-				
-						System.err.println("Aborting JVM");
-						System.exit(1);
-					}
+					debugAgentInvestigate(ma, obj, args, e.getCause());
 				}
 			}
 
@@ -220,7 +220,8 @@ void J9::Recompilation::methodCannotBeRecompiled(void *oldStartPC, TR_FrontEnd *
    if (bodyInfo->getUsesPreexistence()
        || methodInfo->hasBeenReplaced()
        || (linkageInfo->isSamplingMethodBody() && !fej9->isAsyncCompilation()) // go interpreted for failed recomps in sync mode
-       || methodInfo->isExcludedPostRestore()) // go interpreted if method is excluded post restore
+       || methodInfo->isExcludedPostRestore() // go interpreted if method is excluded post restore
+       || methodInfo->isRevertedByDebugAgent()) // go interpreted if the JIT debug agent is reverting the method
       {
       // Patch the first instruction regardless of counting or sampling
       patchAddr = (int32_t *)((uint8_t *)oldStartPC + getJitEntryOffset(linkageInfo));
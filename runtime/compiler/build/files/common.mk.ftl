@@ -400,6 +400,7 @@ JIT_PRODUCT_SOURCE_FILES+=\
     compiler/control/JITClientCompilationThread.cpp \
     compiler/control/JITServerCompilationThread.cpp \
     compiler/control/JITServerHelpers.cpp \
+    compiler/control/JITServerLatencyEstimator.cpp \
     compiler/env/j9methodServer.cpp \
     compiler/env/JITServerCHTable.cpp \
     compiler/env/JITServerPersistentCHTable.cpp \
@@ -417,6 +418,7 @@ JIT_PRODUCT_SOURCE_FILES+=\
     compiler/runtime/JITServerAOTDeserializer.cpp \
     compiler/runtime/JITServerIProfiler.cpp \
     compiler/runtime/JITServerROMClassHash.cpp \
+    compiler/runtime/JITServerSharedProfileCache.cpp \
     compiler/runtime/JITServerSharedROMClassCache.cpp \
     compiler/runtime/JITServerStatisticsThread.cpp \
     compiler/runtime/Listener.cpp \
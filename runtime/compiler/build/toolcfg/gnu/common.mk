@@ -538,4 +538,9 @@ ifneq ($(J9VM_OPT_JITSERVER),)
         C_INCLUDES+=$(OPENSSL_DIR)
         CXX_INCLUDES+=$(OPENSSL_DIR)
     endif
+
+    # Needed for JITServer message compression
+    ifneq ($(HOST_ARCH),z)
+        SOLINK_SLINK+=j9zlib$(J9_VERSION)
+    endif
 endif # J9VM_OPT_JITSERVER
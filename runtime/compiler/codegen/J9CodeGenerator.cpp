@@ -4802,7 +4802,8 @@ J9::CodeGenerator::mustGenerateSwitchToInterpreterPrePrologue()
    return comp->usesPreexistence() ||
       comp->getOption(TR_EnableHCR) ||
       !comp->fej9()->isAsyncCompilation() ||
-      comp->getOption(TR_FullSpeedDebug);
+      comp->getOption(TR_FullSpeedDebug) ||
+      TR::Options::_enableDebugAgentRevert;
    }
 
 extern void VMgenerateCatchBlockBBStartPrologue(TR::Node *node, TR::Instruction *fenceInstruction, TR::CodeGenerator *cg);
@@ -73,6 +73,8 @@ public:
          _word |= HasFailedRecompilation;
          }
 
+      void resetHasFailedRecompilation() { _word &= ~HasFailedRecompilation; }
+
       void setIsBeingRecompiled() { _word |= IsBeingRecompiled; }
       void resetIsBeingRecompiled() { _word &= ~IsBeingRecompiled; }
 
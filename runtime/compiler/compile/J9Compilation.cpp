@@ -49,12 +49,15 @@
 #include "exceptions/PersistenceFailure.hpp"
 #include "il/Node.hpp"
 #include "il/Node_inlines.hpp"
+#include "il/TreeTop.hpp"
+#include "il/TreeTop_inlines.hpp"
 #include "ilgen/IlGenRequest.hpp"
 #include "infra/List.hpp"
 #include "optimizer/Inliner.hpp"
 #include "optimizer/OptimizationManager.hpp"
 #include "optimizer/Optimizer.hpp"
 #include "optimizer/TransformUtil.hpp"
+#include "ras/Debug.hpp"
 #include "runtime/RuntimeAssumptions.hpp"
 #include "runtime/J9Profiler.hpp"
 #include "OMR/Bytes.hpp"
@@ -170,6 +173,7 @@ J9::Compilation::Compilation(int32_t id,
    _needsClassLookahead(true),
    _reservedDataCache(NULL),
    _totalNeededDataCacheSpace(0),
+   _numInliningAttempts(0),
    _aotMethodDataStart(NULL),
    _curMethodMetadata(NULL),
    _getImplAndRefersToInlineable(false),
@@ -1297,10 +1301,61 @@ J9::Compilation::reportAnalysisPhase(uint8_t id)
    }
 
 
+// Test only: corrupt the value returned by every ireturn of the method, a deterministic miscompilation the JIT debug
+// agent must trace back to the method and to the optimization index it was planted at
+static void
+plantDebugAgentFault(TR::Compilation *comp)
+   {
+   TR_Debug *debug = TR::Options::getDebug();
+   TR_FilterBST *filter = NULL;
+   if (!debug || !debug->methodSigCanBeFound(comp->signature(), TR::Options::_debugAgentFaultFilters, filter,
+         comp->getMethodBeingCompiled()->convertToMethod()->methodType()))
+      return;
+
+   for (TR::TreeTop *tt = comp->getStartTree(); tt; tt = tt->getNextTreeTop())
+      {
+      TR::Node *node = tt->getNode();
+      if (node->getOpCodeValue() != TR::ireturn)
+         continue;
+
+      TR::Node *value = node->getFirstChild();
+      TR::Node *corrupted = TR::Node::create(TR::iadd, 2, value, TR::Node::iconst(value, 1));
+      value->decReferenceCount();
+      node->setAndIncChild(0, corrupted);
+
+      if (comp->getOutFile() != NULL)
+         traceMsg(comp, "Debug agent fault planted at optimization index %d in ireturn n%dn\n", comp->getOptIndex(), node->getGlobalIndex());
+      }
+   }
+
 void
 J9::Compilation::reportOptimizationPhase(OMR::Optimizations opts)
    {
    self()->fej9()->reportOptimizationPhase(opts);
+
+   if (TR::Options::_debugAgentRecompiling && opts < OMR::numOpts)
+      {
+      TR::Options::_debugAgentPerformedOptimizations[opts] = true;
+      }
+
+   // The JIT debug agent only traces the optimizations around the one it is investigating rather than the whole
+   // compilation, which keeps its logs small enough to be usable on large methods
+   TR::Options *options = self()->getOptions();
+   if (options->getDebugAgentTraceFirstOptIndex() >= 0 && self()->getOutFile() != NULL)
+      {
+      int32_t optIndex = self()->getOptIndex();
+      bool traceOpt = optIndex >= options->getDebugAgentTraceFirstOptIndex() && optIndex <= options->getDebugAgentTraceLastOptIndex();
+      if (traceOpt)
+         {
+         self()->findOrCreateDebug();
+         }
+      options->setOption(TR_TraceAll, traceOpt);
+      }
+
+   if (TR::Options::_debugAgentFaultFilters != NULL && self()->getOptIndex() == TR::Options::_debugAgentFaultOptIndex)
+      {
+      plantDebugAgentFault(self());
+      }
    }
 
 
@@ -146,6 +146,10 @@ class OMR_EXTENSIBLE Compilation : public OMR::CompilationConnector
    uint32_t getTotalNeededDataCacheSpace() { return _totalNeededDataCacheSpace; }
    void incrementTotalNeededDataCacheSpace(uint32_t size) { _totalNeededDataCacheSpace += size; }
 
+   // Number of callees the inliner has tried to generate IL for, used by the JIT debug agent to identify call sites
+   int32_t getNumInliningAttempts() const { return _numInliningAttempts; }
+   int32_t incNumInliningAttempts() { return _numInliningAttempts++; }
+
    void * getAotMethodDataStart() const { return _aotMethodDataStart; }
    void setAotMethodDataStart(void *p) { _aotMethodDataStart = p; }
 
@@ -480,6 +484,8 @@ private:
 
    uint32_t _totalNeededDataCacheSpace;
 
+   int32_t _numInliningAttempts;
+
    void * _aotMethodDataStart; // used at relocation time
 
    void * _curMethodMetadata;
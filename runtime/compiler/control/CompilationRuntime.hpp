@@ -41,6 +41,7 @@
 #include "runtime/RelocationRuntime.hpp"
 #if defined(J9VM_OPT_JITSERVER)
 #include "control/JITServerHelpers.hpp"
+#include "control/JITServerLatencyEstimator.hpp"
 #include "env/PersistentCollections.hpp"
 #include "net/ServerStream.hpp"
 #endif /* defined(J9VM_OPT_JITSERVER) */
@@ -78,6 +79,7 @@ typedef J9JITExceptionTable TR_MethodMetaData;
 class ClientSessionHT;
 class JITServerAOTCacheMap;
 class JITServerAOTDeserializer;
+class JITServerSharedProfileCache;
 class JITServerSharedROMClassCache;
 #endif /* defined(J9VM_OPT_JITSERVER) */
 #if defined(J9VM_OPT_CRIU_SUPPORT)
@@ -710,6 +712,8 @@ public:
       bool async, TR_OptimizationPlan *optPlan, bool *queued, TR_YesNoMaybe methodIsInSharedCache);
 #if defined(J9VM_OPT_JITSERVER)
    TR_MethodToBeCompiled *addOutOfProcessMethodToBeCompiled(JITServer::ServerStream *stream);
+   TR_MethodToBeCompiled *getNextOutOfProcessEntry();
+   TR_MethodToBeCompiled *unlinkOutOfProcessEntry(TR_MethodToBeCompiled *entry, TR_MethodToBeCompiled *prev);
 #endif /* defined(J9VM_OPT_JITSERVER) */
    void                   queueEntry(TR_MethodToBeCompiled *entry);
    void                   recycleCompilationEntry(TR_MethodToBeCompiled *cur);
@@ -1122,11 +1126,15 @@ public:
 
    void setCompThreadActivationPolicy(JITServer::CompThreadActivationPolicy newPolicy) { _activationPolicy = newPolicy; }
    JITServer::CompThreadActivationPolicy getCompThreadActivationPolicy() const { return _activationPolicy; }
+   JITServerLatencyEstimator &getJITServerLatencyEstimator() { return _latencyEstimator; }
    uint64_t getCachedFreePhysicalMemoryB() const { return _cachedFreePhysicalMemoryB; }
 
    JITServerSharedROMClassCache *getJITServerSharedROMClassCache() const { return _sharedROMClassCache; }
    void setJITServerSharedROMClassCache(JITServerSharedROMClassCache *cache) { _sharedROMClassCache = cache; }
 
+   JITServerSharedProfileCache *getJITServerSharedProfileCache() const { return _sharedProfileCache; }
+   void setJITServerSharedProfileCache(JITServerSharedProfileCache *cache) { _sharedProfileCache = cache; }
+
    JITServerAOTCacheMap *getJITServerAOTCacheMap() const { return _JITServerAOTCacheMap; }
    void setJITServerAOTCacheMap(JITServerAOTCacheMap *map) { _JITServerAOTCacheMap = map; }
 
@@ -1364,6 +1372,8 @@ private:
 
 #if defined(J9VM_OPT_JITSERVER)
    ClientSessionHT               *_clientSessionHT; // JITServer hashtable that holds session information about JITClients
+   uint64_t                       _lastScheduledClientUID; // Client whose request was dequeued last by the fair scheduler
+   uint64_t                       _schedulingMark; // Incremented by every pass of the fair scheduler over the queue
    PersistentUnorderedSet<J9Class*> _classesCachedAtServer;
    TR::Monitor *_classesCachedAtServerMonitor;
    PersistentVector<TR_OpaqueClassBlock*> *_unloadedClassesTempList; // JITServer list of classes unloaded
@@ -1380,7 +1390,9 @@ private:
    PersistentVector<std::string> _metricsSslKeys;
    PersistentVector<std::string> _metricsSslCerts;
    JITServer::CompThreadActivationPolicy _activationPolicy;
+   JITServerLatencyEstimator     _latencyEstimator; // Used at the client for latency-aware routing of compilations
    JITServerSharedROMClassCache *_sharedROMClassCache;
+   JITServerSharedProfileCache *_sharedProfileCache;
    JITServerAOTCacheMap *_JITServerAOTCacheMap;
    JITServerAOTDeserializer *_JITServerAOTDeserializer;
 #endif /* defined(J9VM_OPT_JITSERVER) */
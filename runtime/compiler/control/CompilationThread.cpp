@@ -1043,6 +1043,9 @@ TR::CompilationInfoPerThreadBase::CompilationInfoPerThreadBase(TR::CompilationIn
    _timeWhenCompStarted(),
    _numJITCompilations(),
    _qszWhenCompStarted(),
+   _lastPerformedOptIndex(-1),
+   _lastPerformedOptSubIndex(-1),
+   _lastNumInliningAttempts(-1),
    _compilationCanBeInterrupted(false),
    _uninterruptableOperationDepth(0),
    _compilationThreadState(COMPTHREAD_UNINITIALIZED),
@@ -1254,6 +1257,8 @@ TR::CompilationInfo::CompilationInfo(J9JITConfig *jitConfig) :
    _interpSamplTrackingInfo = new (PERSISTENT_NEW) TR_InterpreterSamplingTracking(this);
 #if defined(J9VM_OPT_JITSERVER)
    _clientSessionHT = NULL; // This will be set later when options are processed
+   _lastScheduledClientUID = 0;
+   _schedulingMark = 0;
    _unloadedClassesTempList = NULL;
    _illegalFinalFieldModificationList = NULL;
    _newlyExtendedClasses = NULL;
@@ -1264,6 +1269,7 @@ TR::CompilationInfo::CompilationInfo(J9JITConfig *jitConfig) :
    _localGCCounter = 0;
    _activationPolicy = JITServer::CompThreadActivationPolicy::AGGRESSIVE;
    _sharedROMClassCache = NULL;
+   _sharedProfileCache = NULL;
    _JITServerAOTCacheMap = NULL;
    _JITServerAOTDeserializer = NULL;
 #endif /* defined(J9VM_OPT_JITSERVER) */
@@ -3549,6 +3555,8 @@ void TR::CompilationInfo::stopCompilationThreads()
          {
          fprintf(stderr, "Number of connections opened = %u\n", JITServer::ClientStream::getNumConnectionsOpened());
          fprintf(stderr, "Number of connections closed = %u\n", JITServer::ClientStream::getNumConnectionsClosed());
+         if (getPersistentInfo()->getJITServerLatencyAwareRouting())
+            _latencyEstimator.printStats(stderr);
          }
       }
 
@@ -5500,8 +5508,17 @@ TR::CompilationInfo::getNextMethodToBeCompiled(TR::CompilationInfoPerThread *com
    #endif
             )
             {
-            nextMethodToBeCompiled = _methodQueue;
-            _methodQueue = _methodQueue->_next;
+   #if defined(J9VM_OPT_JITSERVER)
+            if (getPersistentInfo()->getRemoteCompilationMode() == JITServer::SERVER)
+               {
+               nextMethodToBeCompiled = getNextOutOfProcessEntry();
+               }
+            else
+   #endif
+               {
+               nextMethodToBeCompiled = _methodQueue;
+               _methodQueue = _methodQueue->_next;
+               }
             }
          // Check if we need to throttle
          else if (exceedsCompCpuEntitlement() == TR_yes &&
@@ -7248,6 +7265,32 @@ TR::CompilationInfoPerThreadBase::preferLocalComp(const TR_MethodToBeCompiled *e
    return false;
    }
 
+bool
+TR::CompilationInfoPerThreadBase::isLocalCompFaster(const TR_MethodToBeCompiled *entry)
+   {
+   if (!_compInfo.getPersistentInfo()->getJITServerLatencyAwareRouting())
+      return false;
+
+   TR_Hotness optLevel = entry->_optimizationPlan->getOptLevel();
+   J9Method *method = entry->getMethodDetails().getMethod();
+   uint32_t bcsz = TR::CompilationInfo::getMethodBytecodeSize(method);
+   if (!_compInfo.getJITServerLatencyEstimator().preferLocalCompilation(optLevel, bcsz))
+      return false;
+
+   if (TR::Options::isAnyVerboseOptionSet(TR_VerboseJITServer, TR_VerboseCompilationDispatch))
+      TR_VerboseLog::writeLineLocked(TR_Vlog_DISPATCH, "t=%u Keeping %s compilation of j9method=%p local because it is expected to be installed sooner",
+         (uint32_t)_compInfo.getPersistentInfo()->getElapsedTime(), TR::Compilation::getHotnessName(optLevel), method);
+   return true;
+   }
+
+bool
+TR::CompilationInfoPerThreadBase::isDebugAgentTracedRecompilation(const TR_MethodToBeCompiled *entry)
+   {
+   return entry->getMethodDetails().isJitDumpMethod() &&
+          entry->_optimizationPlan->isLogCompilation() &&
+          (TR::Options::getCmdLineOptions()->getDebugAgentTraceFirstOptIndex() >= 0);
+   }
+
 void
 TR::CompilationInfoPerThreadBase::enterPerClientAllocationRegion()
    {
@@ -7352,6 +7395,7 @@ TR::CompilationInfoPerThreadBase::preCompilationTasks(J9VMThread * vmThread,
 #if defined(J9VM_INTERP_AOT_RUNTIME_SUPPORT) && defined(J9VM_OPT_SHARED_CLASSES) && (defined(TR_HOST_X86) || defined(TR_HOST_POWER) || defined(TR_HOST_S390) || defined(TR_HOST_ARM) || defined(TR_HOST_ARM64))
    if (entry->_methodIsInSharedCache == TR_yes     // possible AOT load
        && !TR::CompilationInfo::isCompiled(method)
+       && !entry->getMethodDetails().isJitDumpMethod() // JitDump recompilations must compile the method
        && !entry->_doNotAOTCompile
        && !TR::Options::getAOTCmdLineOptions()->getOption(TR_NoLoadAOT)
        && !(_jitConfig->runtimeFlags & J9JIT_TOSS_CODE)
@@ -7742,13 +7786,16 @@ TR::CompilationInfoPerThreadBase::preCompilationTasks(J9VMThread * vmThread,
       if ((persistentInfo->getRemoteCompilationMode() == JITServer::CLIENT) &&
           TR::Options::canJITCompile())
          {
-         bool doLocalCompilation = entry->isAotLoad() || cannotDoRemoteCompilation || preferLocalComp(entry);
+         bool offloadTracing = isDebugAgentTracedRecompilation(entry);
+         bool doLocalCompilation = entry->isAotLoad() || cannotDoRemoteCompilation ||
+                                   (!offloadTracing && (preferLocalComp(entry) || isLocalCompFaster(entry)));
 
          // If this is a remote sync compilation, change it to a local sync compilation.
          // After the local compilation is completed successfully, a remote async compilation
          // will be scheduled in compileOnSeparateThread().
          TR::IlGeneratorMethodDetails & details = entry->getMethodDetails();
          if (!doLocalCompilation &&
+             !offloadTracing &&
              !entry->_async &&
              !entry->isJNINative() &&
              entry->_optimizationPlan->getOptLevel() > cold &&
@@ -7778,6 +7825,7 @@ TR::CompilationInfoPerThreadBase::preCompilationTasks(J9VMThread * vmThread,
          // be important for performance.
          // Cold-->warm recompilations are already buffered in LPQ in compileOnSeparateThread()
          if (!doLocalCompilation &&
+             !offloadTracing &&
              (_compInfo.getLowCompDensityMode() || _compInfo.hasEnteredLowCompDensityModeInThePast() && _jitConfig->javaVM->internalVMFunctions->getVMRuntimeState(_jitConfig->javaVM) == J9VM_RUNTIME_STATE_IDLE) &&
               entry->_optimizationPlan->getOptLevel() <= warm)
             {
@@ -10075,6 +10123,10 @@ TR::CompilationInfoPerThreadBase::compile(
             }
          }
 
+      _lastPerformedOptIndex = compiler->getLastPerformedOptIndex();
+      _lastPerformedOptSubIndex = compiler->getLastPerformedOptSubIndex();
+      _lastNumInliningAttempts = compiler->getNumInliningAttempts();
+
       logCompilationSuccess(vmThread, vm, method, scratchSegmentProvider, compilee, compiler, metaData, optimizationPlan);
 
       TRIGGER_J9HOOK_JIT_COMPILING_END(_jitConfig->hookInterface, vmThread, method);
@@ -10351,17 +10403,21 @@ TR::CompilationInfo::compilationEnd(J9VMThread * vmThread, TR::IlGeneratorMethod
 
                J9ROMMethod *romMethod = comp->fej9()->getROMMethodFromRAMMethod(method);
 
-               TR::CompilationInfo::storeAOTInSharedCache(
-                  vmThread,
-                  romMethod,
-                  dataStart,
-                  dataSize,
-                  codeStart,
-                  codeSize,
-                  comp,
-                  jitConfig,
-                  entry
-                  );
+               // JitDump recompilations reproduce a body for diagnostic purposes, it must not be shared with other JVMs
+               if (!details.isJitDumpMethod())
+                  {
+                  TR::CompilationInfo::storeAOTInSharedCache(
+                     vmThread,
+                     romMethod,
+                     dataStart,
+                     dataSize,
+                     codeStart,
+                     codeSize,
+                     comp,
+                     jitConfig,
+                     entry
+                     );
+                  }
 
 #if defined(J9VM_INTERP_AOT_RUNTIME_SUPPORT)
 
@@ -10809,6 +10865,18 @@ void TR::CompilationInfoPerThreadBase::logCompilationSuccess(
          cipt->setLastCompilationDuration(translationTime / 1000);
          }
 
+#if defined(J9VM_OPT_JITSERVER)
+      // Remote compilations are sampled in remoteCompile(), where the processing time reported by the server is known
+      if (_compInfo.getPersistentInfo()->getJITServerLatencyAwareRouting() &&
+          (_compInfo.getPersistentInfo()->getRemoteCompilationMode() == JITServer::CLIENT) &&
+          !compiler->isRemoteCompilation() &&
+          !_methodBeingCompiled->_useAotCompilation)
+         {
+         _compInfo.getJITServerLatencyEstimator().recordLocalCompilation(
+            optimizationPlan->getOptLevel(), TR::CompilationInfo::getMethodBytecodeSize(method), translationTime);
+         }
+#endif /* defined(J9VM_OPT_JITSERVER) */
+
       uintptr_t gcDataBytes = _jitConfig->lastGCDataAllocSize;
       uintptr_t atlasBytes = _jitConfig->lastExceptionTableAllocSize;
 
@@ -13155,6 +13223,11 @@ TR::CompilationInfo::addOutOfProcessMethodToBeCompiled(JITServer::ServerStream *
       incrementMethodQueueSize(); // One more method added to the queue
       _numQueuedFirstTimeCompilations++; // Otherwise an assert triggers when we dequeue
       queueEntry(entry);
+      // A new connection is attributed to its client once its first request is read
+      uint64_t clientUID = entry->getClientUID();
+      ClientSessionData *clientSession = (clientUID && _clientSessionHT) ? _clientSessionHT->peekClientSession(clientUID) : NULL;
+      if (clientSession)
+         clientSession->incNumQueuedConnections();
 
       // Determine whether we need to activate another compilation thread from the pool
       TR_YesNoMaybe activate = TR_maybe;
@@ -13193,6 +13266,182 @@ TR::CompilationInfo::addOutOfProcessMethodToBeCompiled(JITServer::ServerStream *
    return entry;
    }
 
+// Find out which of the queued connections with the same priority as the head of the queue already
+// carry a request. A connection is known to carry a request until it is dequeued, so only the other
+// connections are checked, with one poll() for up to MAX_STREAMS_PER_POLL of them. Connections after
+// the first one not attributed to a client are not checked, since that one is served first.
+// Must be called with the compilation monitor in hand and a non-empty queue.
+static void
+checkPendingOutOfProcessEntries(TR_MethodToBeCompiled *head, J9JITConfig *jitConfig)
+   {
+   const int maxStreams = JITServer::ServerStream::MAX_STREAMS_PER_POLL;
+   TR_MethodToBeCompiled *entries[maxStreams];
+   JITServer::ServerStream *streams[maxStreams];
+   bool ready[maxStreams];
+   PORT_ACCESS_FROM_JITCONFIG(jitConfig);
+   uint64_t nowUs = j9time_usec_clock();
+   TR_MethodToBeCompiled *cur = head;
+   while (cur && cur->_priority == head->_priority && cur->getClientUID())
+      {
+      int numStreams = 0;
+      for (; cur && cur->_priority == head->_priority && cur->getClientUID() && numStreams < maxStreams; cur = cur->_next)
+         {
+         if (!cur->_requestPendingTimeUs)
+            {
+            entries[numStreams] = cur;
+            streams[numStreams] = cur->_stream;
+            numStreams++;
+            }
+         }
+      if (numStreams == 0)
+         break;
+      JITServer::ServerStream::checkPendingRequests(streams, ready, numStreams);
+      for (int i = 0; i < numStreams; ++i)
+         {
+         if (ready[i])
+            entries[i]->_requestPendingTimeUs = nowUs;
+         }
+      }
+   }
+
+// Position of a client in the order in which the fair scheduler visits clients. The client
+// served last keeps being served while its deficit is positive and is otherwise visited last.
+static uint64_t
+schedulingDistance(const ClientSessionData *session, uint64_t lastScheduledClientUID)
+   {
+   uint64_t distance = session->getClientUID() - lastScheduledClientUID;
+   if (distance == 0 && session->getSchedulingDeficit() <= 0)
+      distance = (uint64_t)-1;
+   return distance;
+   }
+
+// Select the next request to be processed at the server, so that clients with a burst
+// of requests do not delay the requests of other clients.
+//
+// Requests with the same priority as the head of the queue are grouped per client and served
+// in deficit round robin order. Clients are visited in the order of their UIDs, starting after
+// the client served last. A visited client with a positive deficit has its oldest request
+// served; otherwise its deficit grows by the quantum times its weight and the next client is
+// visited. When a request is dequeued its client is charged the average compilation time of its
+// requests; the charge is replaced with the actual compilation time when the compilation ends
+// (see ClientSessionData::settleSchedulingCharge). Rather than simulating the rounds, the number
+// of rounds after which each client would be served is computed directly.
+//
+// Requests that cannot be attributed to a client yet (the first request on a new connection)
+// and special requests are served in queue order ahead of the others.
+//
+// Queued entries are connections, which are queued again as soon as their previous request is
+// done. Only the connections on which the client has already sent a request take part in the
+// scheduling: serving an idle connection would block a compilation thread in a read while the
+// requests of other clients wait. When no connection has a request yet, they are served in queue
+// order and their clients are only charged once the request is read and compiled. Whether a
+// connection has a request is checked by checkPendingOutOfProcessEntries, so the scheduling
+// itself does not make any system calls.
+// Must be called with the compilation monitor in hand and a non-empty queue.
+TR_MethodToBeCompiled *
+TR::CompilationInfo::getNextOutOfProcessEntry()
+   {
+   TR_MethodToBeCompiled *head = _methodQueue;
+   int64_t quantum = TR::Options::_jitserverFairSchedulingQuantum;
+   if (quantum <= 0 || !_clientSessionHT)
+      return unlinkOutOfProcessEntry(head, NULL);
+
+   checkPendingOutOfProcessEntries(head, _jitConfig);
+
+   // First pass: find the client that would be served first
+   uint64_t mark = ++_schedulingMark;
+   ClientSessionData *winner = NULL;
+   TR_MethodToBeCompiled *winnerEntry = NULL;
+   TR_MethodToBeCompiled *winnerPrev = NULL;
+   uint64_t winnerRounds = 0;
+   uint64_t winnerDistance = 0;
+   bool winnerHasMoreEntries = false;
+   for (TR_MethodToBeCompiled *prev = NULL, *cur = head; cur && cur->_priority == head->_priority; prev = cur, cur = cur->_next)
+      {
+      uint64_t clientUID = cur->getClientUID();
+      ClientSessionData *session = clientUID ? _clientSessionHT->peekClientSession(clientUID) : NULL;
+      if (!session)
+         return unlinkOutOfProcessEntry(cur, prev);
+      if (session->getSchedulingMark() == mark)
+         {
+         // Not the oldest pending request of this client
+         if (session == winner && !winnerHasMoreEntries && cur->_requestPendingTimeUs)
+            winnerHasMoreEntries = true;
+         continue;
+         }
+      if (!cur->_requestPendingTimeUs)
+         continue;
+      session->setSchedulingMark(mark);
+
+      int64_t deficit = session->getSchedulingDeficit();
+      int64_t credit = quantum * session->getSchedulingWeight();
+      uint64_t rounds = (deficit > 0) ? 0 : (uint64_t)((credit - deficit) / credit);
+      uint64_t distance = schedulingDistance(session, _lastScheduledClientUID);
+      if (!winner || rounds < winnerRounds || (rounds == winnerRounds && distance < winnerDistance))
+         {
+         winner = session;
+         winnerEntry = cur;
+         winnerPrev = prev;
+         winnerRounds = rounds;
+         winnerDistance = distance;
+         winnerHasMoreEntries = false;
+         }
+      }
+
+   if (!winner)
+      return unlinkOutOfProcessEntry(head, NULL);
+
+   // Second pass: credit the clients for the rounds that have gone by
+   ++_schedulingMark;
+   for (TR_MethodToBeCompiled *cur = head; cur && cur->_priority == head->_priority; cur = cur->_next)
+      {
+      ClientSessionData *session = _clientSessionHT->peekClientSession(cur->getClientUID());
+      if (session->getSchedulingMark() != mark)
+         continue;
+      session->setSchedulingMark(_schedulingMark);
+
+      int64_t deficit = session->getSchedulingDeficit();
+      if (deficit > 0)
+         continue;
+      uint64_t rounds = winnerRounds;
+      if (session != winner)
+         {
+         // Clients ahead of the winner in the visiting order are visited once more in the last round
+         if (schedulingDistance(session, _lastScheduledClientUID) < winnerDistance)
+            rounds++;
+         }
+      session->setSchedulingDeficit(deficit + (int64_t)rounds * quantum * session->getSchedulingWeight());
+      }
+
+   unlinkOutOfProcessEntry(winnerEntry, winnerPrev);
+
+   winnerEntry->_schedulingChargeUs = winner->getAvgCompTimeUs();
+   int64_t deficit = winner->getSchedulingDeficit() - (int64_t)winnerEntry->_schedulingChargeUs;
+   // As in deficit round robin, a client does not keep its unused credit when it has nothing left to compile
+   if (!winnerHasMoreEntries && deficit > 0)
+      deficit = 0;
+   winner->setSchedulingDeficit(deficit);
+   _lastScheduledClientUID = winner->getClientUID();
+   return winnerEntry;
+   }
+
+// Remove an entry from the compilation queue at the server, given the entry that precedes it
+// (NULL for the head of the queue). Must be called with the compilation monitor in hand.
+TR_MethodToBeCompiled *
+TR::CompilationInfo::unlinkOutOfProcessEntry(TR_MethodToBeCompiled *entry, TR_MethodToBeCompiled *prev)
+   {
+   if (prev)
+      prev->_next = entry->_next;
+   else
+      _methodQueue = entry->_next;
+
+   uint64_t clientUID = entry->getClientUID();
+   ClientSessionData *clientSession = (clientUID && _clientSessionHT) ? _clientSessionHT->peekClientSession(clientUID) : NULL;
+   if (clientSession)
+      clientSession->decNumQueuedConnections();
+   return entry;
+   }
+
 void
 TR::CompilationInfo::requeueOutOfProcessEntry(TR_MethodToBeCompiled *entry)
    {
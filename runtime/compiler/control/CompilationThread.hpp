@@ -205,6 +205,12 @@ class CompilationInfoPerThreadBase
    bool methodCanBeCompiled(TR_Memory *trMemory, TR_FrontEnd *fe, TR_ResolvedMethod *compilee, TR_FilterBST *&filter);
    int32_t                getCompThreadId() const { return _compThreadId; }
 
+   // Optimization index and sub-index reached, and number of inlining attempts made, by the last compilation this
+   // thread completed successfully
+   int32_t                getLastPerformedOptIndex() const { return _lastPerformedOptIndex; }
+   int32_t                getLastPerformedOptSubIndex() const { return _lastPerformedOptSubIndex; }
+   int32_t                getLastNumInliningAttempts() const { return _lastNumInliningAttempts; }
+
    /**
     * \brief
     *
@@ -361,6 +367,18 @@ class CompilationInfoPerThreadBase
              this compilation locally, rather than offloading it to the remote server.
     */
    bool preferLocalComp(const TR_MethodToBeCompiled *entry);
+   /**
+      @brief Returns true if latency-aware routing is enabled and this compilation is expected to be
+             installed sooner if it is performed locally. Must be called at most once per compilation,
+             because the estimator occasionally picks the slower side on purpose to refresh its estimates.
+    */
+   bool isLocalCompFaster(const TR_MethodToBeCompiled *entry);
+   /**
+      @brief Returns true if this is a traced recompilation requested by the JIT debug agent. These are
+             always offloaded to the remote server, so the cost of tracing does not perturb the JVM
+             under investigation, and the server sends the trace log back along with the compiled body.
+    */
+   static bool isDebugAgentTracedRecompilation(const TR_MethodToBeCompiled *entry);
 
 
    bool compilationCanBeInterrupted() const { return _compilationCanBeInterrupted; }
@@ -388,6 +406,9 @@ class CompilationInfoPerThreadBase
    uintptr_t                    _timeWhenCompStarted;
    int32_t                      _numJITCompilations; // num JIT compilations this thread has performed; AOT loads not counted
    int32_t                      _qszWhenCompStarted; // size of compilation queue and compilation starts
+   int32_t                      _lastPerformedOptIndex;
+   int32_t                      _lastPerformedOptSubIndex;
+   int32_t                      _lastNumInliningAttempts;
 
    /// Determines whether this compilation thread can be interrupted the compile at the next yield point. A different
    /// thread may still request that the compilation _should_ be interrupted, however we may not be in a state at
@@ -23,17 +23,237 @@
 #include "control/DebugAgent.hpp"
 
 #include "codegen/CodeGenerator.hpp"
+#include "codegen/PrivateLinkage.hpp"
 #include "control/MethodToBeCompiled.hpp"
 #include "control/CompilationRuntime.hpp"
 #include "control/CompilationThread.hpp"
+#include "env/FilePointer.hpp"
+#include "env/IO.hpp"
 #include "env/ut_j9jit.h"
 #include "env/VMAccessCriticalSection.hpp"
+#include "env/PersistentCollections.hpp"
 #include "env/VMJ9.h"
 #include "ilgen/J9ByteCodeIlGenerator.hpp"
 #include "jithash.h"
 #include "nls/j9dmpnls.h"
-#include <queue>
-#include <set>
+#include "optimizer/Optimizer.hpp"
+#include <algorithm>
+#include <ctype.h>
+#include <limits.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Every platform reverts a JIT body to the interpreter by patching at most one 4 byte instruction at the JIT entry
+// point. We save that word before reverting so the body can later be re-enabled by writing it back.
+struct DebugAgentRevertedBody
+    {
+    void *startPC;
+    uint32_t savedJitEntry;
+    };
+
+static PersistentUnorderedMap<J9JITExceptionTable *, DebugAgentRevertedBody> *revertedBodies = NULL;
+
+// In-memory trace log of the last good recompilation, compared against the next bad recompilation
+static TR::FILE *goodCompilationLog = NULL;
+
+// Canonicalizes the parts of a trace log line which differ between two compilations of the same method even when the
+// IL is the same. Node global indices and the addresses printed in square brackets are renumbered in order of first
+// appearance, and visit counts are dropped.
+class DebugAgentLogNormalizer
+    {
+    public:
+
+    std::string normalize(const char *line, size_t length);
+
+    private:
+
+    static size_t getCanonicalId(std::unordered_map<std::string, size_t> &ids, const char *name, size_t length)
+        {
+        auto result = ids.insert(std::make_pair(std::string(name, length), ids.size() + 1));
+        return result.first->second;
+        }
+
+    std::unordered_map<std::string, size_t> _nodeIds;
+    std::unordered_map<std::string, size_t> _addressIds;
+    };
+
+std::string
+DebugAgentLogNormalizer::normalize(const char *line, size_t length)
+    {
+    std::string normalizedLine;
+    normalizedLine.reserve(length);
+
+    int32_t bracketDepth = 0;
+    size_t i = 0;
+    while (i < length)
+        {
+        char c = line[i];
+        bool atWordStart = (0 == i) || !isalnum(static_cast<unsigned char>(line[i - 1]));
+
+        // Node global index, e.g. n1540n
+        if (('n' == c) && atWordStart)
+            {
+            size_t end = i + 1;
+            while ((end < length) && isdigit(static_cast<unsigned char>(line[end])))
+                ++end;
+
+            if ((end > i + 1) && (end < length) && ('n' == line[end]) && ((end + 1 == length) || !isalnum(static_cast<unsigned char>(line[end + 1]))))
+                {
+                char name[32];
+                snprintf(name, sizeof(name), "n%dn", (int)getCanonicalId(_nodeIds, line + i + 1, end - i - 1));
+                normalizedLine.append(name);
+                i = end + 1;
+                continue;
+                }
+            }
+
+        // Addresses, e.g. [     0x3ff5451d110] or [000003FF5451D160]
+        if ((bracketDepth > 0) && atWordStart && isxdigit(static_cast<unsigned char>(c)))
+            {
+            size_t digitsStart = i;
+            if (('0' == c) && (i + 1 < length) && ('x' == line[i + 1] || 'X' == line[i + 1]))
+                digitsStart = i + 2;
+
+            size_t end = digitsStart;
+            while ((end < length) && isxdigit(static_cast<unsigned char>(line[end])))
+                ++end;
+
+            if ((end - digitsStart >= 8) && ((end == length) || !isalnum(static_cast<unsigned char>(line[end]))))
+                {
+                char name[32];
+                snprintf(name, sizeof(name), "addr%d", (int)getCanonicalId(_addressIds, line + digitsStart, end - digitsStart));
+                normalizedLine.append(name);
+                i = end;
+                continue;
+                }
+            }
+
+        // Visit counts, e.g. vc=1593
+        if (('v' == c) && atWordStart && (i + 2 < length) && ('c' == line[i + 1]) && ('=' == line[i + 2]))
+            {
+            normalizedLine.append("vc=");
+            i += 3;
+            while ((i < length) && isdigit(static_cast<unsigned char>(line[i])))
+                ++i;
+            continue;
+            }
+
+        if ('[' == c)
+            ++bracketDepth;
+        else if ((']' == c) && (bracketDepth > 0))
+            --bracketDepth;
+
+        normalizedLine.push_back(c);
+        ++i;
+        }
+
+    return normalizedLine;
+    }
+
+static void
+getNormalizedLines(TR::FILE *log, std::vector<std::string> &lines)
+    {
+    if ((NULL == log) || (NULL == log->getBuffer()))
+        return;
+
+    DebugAgentLogNormalizer normalizer;
+    const char *buffer = log->getBuffer();
+    size_t length = log->getBufferLength();
+    size_t lineStart = 0;
+    for (size_t i = 0; i < length; ++i)
+        {
+        if ('\n' == buffer[i])
+            {
+            lines.push_back(normalizer.normalize(buffer + lineStart, i - lineStart));
+            lineStart = i + 1;
+            }
+        }
+
+    if (lineStart < length)
+        lines.push_back(normalizer.normalize(buffer + lineStart, length - lineStart));
+    }
+
+// Writes a unified style diff of the normalized good and bad trace logs. Lines common to the start and the end of both
+// logs are skipped, and the remaining lines are matched using a longest common subsequence unless there are too many
+// of them, in which case they are written out as a whole.
+static void
+writeCompilationLogDiff(TR::FILE *diffLog, TR::FILE *goodLog, TR::FILE *badLog)
+    {
+    static const size_t MAX_LCS_TABLE_SIZE = 4 * 1024 * 1024;
+
+    std::vector<std::string> goodLines;
+    std::vector<std::string> badLines;
+    getNormalizedLines(goodLog, goodLines);
+    getNormalizedLines(badLog, badLines);
+
+    size_t prefix = 0;
+    while ((prefix < goodLines.size()) && (prefix < badLines.size()) && (goodLines[prefix] == badLines[prefix]))
+        ++prefix;
+
+    size_t suffix = 0;
+    while ((prefix + suffix < goodLines.size()) && (prefix + suffix < badLines.size()) &&
+           (goodLines[goodLines.size() - 1 - suffix] == badLines[badLines.size() - 1 - suffix]))
+        ++suffix;
+
+    size_t n = goodLines.size() - prefix - suffix;
+    size_t m = badLines.size() - prefix - suffix;
+
+    trfprintf(diffLog, "--- goodJitCompilationLog\n+++ badJitCompilationLog\n");
+    if ((0 == n) && (0 == m))
+        {
+        trfprintf(diffLog, "No differences after normalization\n");
+        return;
+        }
+
+    trfprintf(diffLog, "@@ -%d,%d +%d,%d @@\n", (int)(prefix + 1), (int)n, (int)(prefix + 1), (int)m);
+
+    if ((n + 1) * (m + 1) > MAX_LCS_TABLE_SIZE)
+        {
+        for (size_t i = 0; i < n; ++i)
+            trfprintf(diffLog, "-%s\n", goodLines[prefix + i].c_str());
+        for (size_t j = 0; j < m; ++j)
+            trfprintf(diffLog, "+%s\n", badLines[prefix + j].c_str());
+        return;
+        }
+
+    // lcs[i * (m + 1) + j] is the length of the longest common subsequence of the good lines from i and the bad lines
+    // from j onwards
+    std::vector<uint32_t> lcs((n + 1) * (m + 1), 0);
+    for (size_t i = n; i-- > 0;)
+        {
+        for (size_t j = m; j-- > 0;)
+            {
+            if (goodLines[prefix + i] == badLines[prefix + j])
+                lcs[i * (m + 1) + j] = lcs[(i + 1) * (m + 1) + j + 1] + 1;
+            else
+                lcs[i * (m + 1) + j] = std::max(lcs[(i + 1) * (m + 1) + j], lcs[i * (m + 1) + j + 1]);
+            }
+        }
+
+    size_t i = 0;
+    size_t j = 0;
+    while ((i < n) || (j < m))
+        {
+        if ((i < n) && (j < m) && (goodLines[prefix + i] == badLines[prefix + j]))
+            {
+            trfprintf(diffLog, " %s\n", goodLines[prefix + i].c_str());
+            ++i;
+            ++j;
+            }
+        else if ((j < m) && ((i == n) || (lcs[i * (m + 1) + j + 1] >= lcs[(i + 1) * (m + 1) + j])))
+            {
+            trfprintf(diffLog, "+%s\n", badLines[prefix + j].c_str());
+            ++j;
+            }
+        else
+            {
+            trfprintf(diffLog, "-%s\n", goodLines[prefix + i].c_str());
+            ++i;
+            }
+        }
+    }
 
 void
 debugAgentSetForceUsePreexistence(J9VMThread* vmThread)
@@ -97,6 +317,12 @@ debugAgentStart(J9VMThread* vmThread)
 
     compInfo->getPersistentInfo()->setDisableFurtherCompilation(true);
 
+    if (NULL == revertedBodies)
+        {
+        revertedBodies = new (PERSISTENT_NEW) PersistentUnorderedMap<J9JITExceptionTable *, DebugAgentRevertedBody>(
+            PersistentUnorderedMap<J9JITExceptionTable *, DebugAgentRevertedBody>::allocator_type(TR::Compiler->persistentAllocator()));
+        }
+
     TR::CompilationInfoPerThread *recompilationThreadInfo = compInfo->getCompilationInfoForDiagnosticThread();
     if (NULL == recompilationThreadInfo)
         {
@@ -120,69 +346,125 @@ debugAgentStart(J9VMThread* vmThread)
     return true;
     }
 
-BOOLEAN
-debugAgentGetAllJitMethods(J9VMThread* vmThread, jobject jitMethodSet)
+// Walks the JIT hash tables hanging off the translation artifacts AVL tree, storing at most capacity JIT methods into
+// jitMethods. Returns the number of JIT methods found, which may exceed capacity.
+static UDATA
+collectJitMethods(J9AVLTreeNode *node, J9JITExceptionTable **jitMethods, UDATA capacity, UDATA count)
     {
-    JNIEnv *env = (JNIEnv*)vmThread;
+    if (NULL == node)
+        {
+        return count;
+        }
 
-    jclass java_lang_Long = env->FindClass("java/lang/Long");
-    jmethodID java_lang_Long_init = env->GetMethodID(java_lang_Long, "<init>", "(J)V");
-    jmethodID java_lang_Long_longValue = env->GetMethodID(java_lang_Long, "longValue", "()J");
+    count = collectJitMethods(J9AVLTREENODE_LEFTCHILD(node), jitMethods, capacity, count);
 
-    jclass java_util_HashSet = env->FindClass("java/util/HashSet");
-    jmethodID java_util_HashSet_init = env->GetMethodID(java_util_HashSet, "<init>", "()V");
-    jmethodID java_util_HashSet_add = env->GetMethodID(java_util_HashSet, "add", "(Ljava/lang/Object;)Z");
-    jmethodID java_util_HashSet_size = env->GetMethodID(java_util_HashSet, "size", "()I");
+    J9JITHashTableWalkState state;
+    J9JITExceptionTable* metadata = hash_jit_start_do(&state, reinterpret_cast<J9JITHashTable*>(node));
+    while (NULL != metadata)
+        {
+        if (count < capacity)
+            {
+            jitMethods[count] = metadata;
+            }
+        ++count;
 
-    jclass java_util_LinkedList = env->FindClass("java/util/LinkedList");
-    jmethodID java_util_LinkedList_init = env->GetMethodID(java_util_LinkedList, "<init>", "()V");
-    jmethodID java_util_LinkedList_add = env->GetMethodID(java_util_LinkedList, "add", "(Ljava/lang/Object;)Z");
-    jmethodID java_util_LinkedList_isEmpty = env->GetMethodID(java_util_LinkedList, "isEmpty", "()Z");
-    jmethodID java_util_LinkedList_remove = env->GetMethodID(java_util_LinkedList, "remove", "()Ljava/lang/Object;");
+        metadata = hash_jit_next_do(&state);
+        }
 
-    jobject jitAVLQueue = env->NewObject(java_util_LinkedList, java_util_LinkedList_init);
+    return collectJitMethods(J9AVLTREENODE_RIGHTCHILD(node), jitMethods, capacity, count);
+    }
 
-    jobject rootNode = env->NewObject(java_lang_Long, java_lang_Long_init, (jlong)jitConfig->translationArtifacts->rootNode);
-    env->CallBooleanMethod(jitAVLQueue, java_util_LinkedList_add, rootNode);
-    env->DeleteLocalRef(rootNode);
+// Number of times the method of a JIT body has been compiled before the body was created, as far as we can tell from
+// the persistent information the JIT keeps around
+static int32_t
+getRecompilationCount(TR_PersistentJittedBodyInfo *bodyInfo)
+    {
+    int32_t count = bodyInfo->getMethodInfo()->getNumberOfInvalidations();
+    if (NULL != bodyInfo->getStartPCAfterPreviousCompile())
+        {
+        ++count;
+        }
+    return count;
+    }
+
+// Orders JIT methods so that the ones most likely to be miscompiled come first. Hotter bodies are ranked first, then
+// bodies of methods which have been recompiled more often, then profiling bodies, and finally the most recently
+// compiled bodies. JIT methods without a persistent body info cannot be reverted and are ranked last.
+static bool
+isMoreLikelyMiscompiled(J9JITExceptionTable *a, J9JITExceptionTable *b)
+    {
+    TR_PersistentJittedBodyInfo *aBodyInfo = reinterpret_cast<TR_PersistentJittedBodyInfo *>(a->bodyInfo);
+    TR_PersistentJittedBodyInfo *bBodyInfo = reinterpret_cast<TR_PersistentJittedBodyInfo *>(b->bodyInfo);
 
-    jboolean jitAVLQueueIsEmpty = env->CallBooleanMethod(jitAVLQueue, java_util_LinkedList_isEmpty);
-    while (jitAVLQueueIsEmpty != JNI_TRUE)
+    if ((NULL == aBodyInfo) || (NULL == bBodyInfo))
         {
-        jobject nodeObject = env->CallObjectMethod(jitAVLQueue, java_util_LinkedList_remove);
-        J9AVLTreeNode *node = (J9AVLTreeNode *)env->CallLongMethod(nodeObject, java_lang_Long_longValue);
-        env->DeleteLocalRef(nodeObject);
+        if (aBodyInfo != bBodyInfo)
+            return NULL != aBodyInfo;
+        return a < b;
+        }
 
-        if (NULL != node)
-            {
-            jobject leftChild = env->NewObject(java_lang_Long, java_lang_Long_init, (jlong)J9AVLTREENODE_LEFTCHILD(node));
-            jobject rightChild = env->NewObject(java_lang_Long, java_lang_Long_init, (jlong)J9AVLTREENODE_RIGHTCHILD(node));
-            env->CallBooleanMethod(jitAVLQueue, java_util_LinkedList_add, leftChild);
-            env->CallBooleanMethod(jitAVLQueue, java_util_LinkedList_add, rightChild);
+    if (aBodyInfo->getHotness() != bBodyInfo->getHotness())
+        return aBodyInfo->getHotness() > bBodyInfo->getHotness();
 
+    int32_t aRecompilationCount = getRecompilationCount(aBodyInfo);
+    int32_t bRecompilationCount = getRecompilationCount(bBodyInfo);
+    if (aRecompilationCount != bRecompilationCount)
+        return aRecompilationCount > bRecompilationCount;
 
-            J9JITHashTableWalkState state;
-            J9JITExceptionTable* metadata = hash_jit_start_do(&state, reinterpret_cast<J9JITHashTable*>(node));
-            while (NULL != metadata)
-                {
-                jobject jitMethod = env->NewObject(java_lang_Long, java_lang_Long_init, (jlong)metadata);
-                env->CallBooleanMethod(jitMethodSet, java_util_HashSet_add, jitMethod);
-                env->DeleteLocalRef(jitMethod);
-                
-                metadata = hash_jit_next_do(&state);
-                }
+    if (aBodyInfo->getIsProfilingBody() != bBodyInfo->getIsProfilingBody())
+        return aBodyInfo->getIsProfilingBody();
 
-            env->DeleteLocalRef(leftChild);
-            env->DeleteLocalRef(rightChild);
-            }
+    // The start count is the global sample counter at the time the body was compiled
+    if (aBodyInfo->getStartCount() != bBodyInfo->getStartCount())
+        return aBodyInfo->getStartCount() > bBodyInfo->getStartCount();
+
+    return a < b;
+    }
+
+BOOLEAN
+debugAgentGetAllJitMethods(J9VMThread* vmThread, J9JITExceptionTable ***jitMethods, UDATA *jitMethodCount)
+    {
+    PORT_ACCESS_FROM_VMC(vmThread);
+
+    *jitMethods = NULL;
+    *jitMethodCount = 0;
+
+    J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
+    if (NULL == jitConfig)
+        {
+        fprintf(stderr, "Could not locate J9JITConfig\n");
+        return false;
+        }
+
+    // Everything is done natively so the walk does not allocate on the Java heap of the application being debugged.
+    // The first pass only counts the JIT methods so the second can fill an exactly sized array.
+    J9AVLTreeNode *rootNode = jitConfig->translationArtifacts->rootNode;
+    UDATA count = collectJitMethods(rootNode, NULL, 0, 0);
+    if (0 == count)
+        {
+        return true;
+        }
 
-        jitAVLQueueIsEmpty = env->CallBooleanMethod(jitAVLQueue, java_util_LinkedList_isEmpty);
+    J9JITExceptionTable **methods = static_cast<J9JITExceptionTable **>(j9mem_allocate_memory(count * sizeof(J9JITExceptionTable *), J9MEM_CATEGORY_JIT));
+    if (NULL == methods)
+        {
+        fprintf(stderr, "Could not allocate memory for %d JIT methods\n", (int)count);
+        return false;
         }
 
-    env->DeleteLocalRef(java_lang_Long);
-    env->DeleteLocalRef(java_util_HashSet);
-    env->DeleteLocalRef(java_util_LinkedList);
-    env->DeleteLocalRef(jitAVLQueue);
+    // Further compilation is disabled while the debug agent runs so the count cannot grow between the two passes
+    count = std::min(collectJitMethods(rootNode, methods, count, 0), count);
+
+    // A JIT method may be reachable from more than one hash table
+    std::sort(methods, methods + count);
+    count = std::unique(methods, methods + count) - methods;
+
+    // Reverting the likeliest suspects first shortens the linear search and concentrates them in the first half of
+    // the bisection
+    std::sort(methods, methods + count, isMoreLikelyMiscompiled);
+
+    *jitMethods = methods;
+    *jitMethodCount = count;
 
     return true;
     }
@@ -244,13 +526,83 @@ debugAgentRevertToInterpreter(J9VMThread* vmThread, J9JITExceptionTable *jitMeth
         return false;
         }
 
+    // Reverting patches the JIT entry to branch to the switch to interpreter pre-prologue, which is only generated
+    // for bodies using preexistence or when running with -Xjit:enableDebugAgentRevert. Such bodies are excluded from
+    // the search up front, see debugAgentIsRevertible.
+    if (!bodyInfo->getHasSwitchToInterpreterPrePrologue())
+        {
+        fprintf(stderr, "Cannot invalidate method because it has no switch to interpreter pre-prologue %.*s.%.*s%.*s\n",
+            (int)J9UTF8_LENGTH(className), J9UTF8_DATA(className),
+            (int)J9UTF8_LENGTH(methName), J9UTF8_DATA(methName),
+            (int)J9UTF8_LENGTH(methSig), J9UTF8_DATA(methSig));
+
+        return false;
+        }
+
+    uint32_t *jitEntry = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(pc) + J9::PrivateLinkage::LinkageInfo::get(pc)->getJitEntryOffset());
+    DebugAgentRevertedBody revertedBody = { pc, *jitEntry };
+    (*revertedBodies)[jitMethod] = revertedBody;
+
+    bodyInfo->getMethodInfo()->setIsRevertedByDebugAgent();
     TR::Recompilation::methodCannotBeRecompiled(pc, frontendOfThread);
 
     return true;
     }
 
+BOOLEAN
+debugAgentRestoreJitMethod(J9VMThread* vmThread, J9JITExceptionTable *jitMethod)
+    {
+    J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
+    if (NULL == jitConfig)
+        {
+        fprintf(stderr, "Could not locate J9JITConfig\n");
+        return false;
+        }
+
+    TR::CompilationInfo *compInfo = TR::CompilationInfo::get(jitConfig);
+    if (NULL == compInfo)
+        {
+        fprintf(stderr, "Could not locate TR::CompilationInfo\n");
+        return false;
+        }
+
+    auto it = revertedBodies->find(jitMethod);
+    if (it == revertedBodies->end())
+        {
+        return false;
+        }
+
+    void *pc = it->second.startPC;
+    J9::PrivateLinkage::LinkageInfo *linkageInfo = J9::PrivateLinkage::LinkageInfo::get(pc);
+    uint32_t *jitEntry = reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(pc) + linkageInfo->getJitEntryOffset());
+
+    // Undo the patch applied by TR::Recompilation::methodCannotBeRecompiled so callers linked directly to the body
+    // execute it again, and allow the body to be reverted or recompiled again afterwards
+    omrthread_jit_write_protect_disable();
+    *jitEntry = it->second.savedJitEntry;
+    omrthread_jit_write_protect_enable();
+    TR::CodeGenerator::syncCode(reinterpret_cast<uint8_t *>(jitEntry), sizeof(uint32_t));
+    linkageInfo->resetHasFailedRecompilation();
+
+    TR_PersistentJittedBodyInfo *bodyInfo = reinterpret_cast<TR_PersistentJittedBodyInfo *>(jitMethod->bodyInfo);
+    bodyInfo->getMethodInfo()->setIsRevertedByDebugAgent(false);
+
+    revertedBodies->erase(it);
+
+    // Point the J9Method back at the body if it was switched to the interpreter. This API is meant to be called from
+    // within JNI so we must acquire VM access here because the VM walks the vTables of the class hierarchy.
+    if (NULL == compInfo->getPCIfCompiled(jitMethod->ramMethod))
+        {
+        vmThread->javaVM->internalVMFunctions->internalAcquireVMAccess(vmThread);
+        jitMethodTranslated(vmThread, jitMethod->ramMethod, pc);
+        vmThread->javaVM->internalVMFunctions->internalReleaseVMAccess(vmThread);
+        }
+
+    return true;
+    }
+
 extern J9_CFUNC BOOLEAN
-debugAgentRecompile(J9VMThread* vmThread, J9JITExceptionTable *jitMethod, IDATA lastOptIndex, IDATA lastOptSubIndex, BOOLEAN enableTracing, BOOLEAN goodLog)
+debugAgentRecompile(J9VMThread* vmThread, J9JITExceptionTable *jitMethod, IDATA lastOptIndex, IDATA lastOptSubIndex, IDATA maxInlinedCallSites, IDATA *disabledOptimizations, UDATA disabledOptimizationCount, UDATA bodyKind, BOOLEAN enableTracing, BOOLEAN goodLog, J9DebugAgentRecompileResult *result)
     {
     J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
     if (NULL == jitConfig)
@@ -287,8 +639,10 @@ debugAgentRecompile(J9VMThread* vmThread, J9JITExceptionTable *jitMethod, IDATA
     J9UTF8 *methSig = J9ROMMETHOD_SIGNATURE(romMethod);
     J9UTF8 *className = J9ROMCLASS_CLASSNAME(clazz->romClass);
 
+    bool aotCompile = (J9_DEBUG_AGENT_RECOMPILE_AOT == bodyKind) || ((J9_DEBUG_AGENT_RECOMPILE_SAME_KIND == bodyKind) && bodyInfo->getIsAotedBody());
+
     void *pc = compInfo->getPCIfCompiled(jitMethod->ramMethod);
-    fprintf(stderr, "Recompiling PC = %p lastOptIndex = %d lastOptSubIndex = %d %.*s.%.*s%.*s\n", pc, (int)lastOptIndex, (int)lastOptSubIndex, 
+    fprintf(stderr, "Recompiling %s PC = %p lastOptIndex = %d lastOptSubIndex = %d %.*s.%.*s%.*s\n", aotCompile ? "AOT" : "JIT", pc, (int)lastOptIndex, (int)lastOptSubIndex,
         (int)J9UTF8_LENGTH(className), J9UTF8_DATA(className),
         (int)J9UTF8_LENGTH(methName), J9UTF8_DATA(methName),
         (int)J9UTF8_LENGTH(methSig), J9UTF8_DATA(methSig));
@@ -304,45 +658,212 @@ debugAgentRecompile(J9VMThread* vmThread, J9JITExceptionTable *jitMethod, IDATA
 
     plan->setInsertInstrumentation(bodyInfo->getIsProfilingBody());
 
-    char *fileName = "goodJitCompilationLog_opt_index_";
-    if (!goodLog)
-    {
-        fileName = "badJitCompilationLog_opt_index_";
-    }
-    // Ref: https://github.com/eclipse-openj9/openj9-omr/blob/openj9/compiler/ras/Tree.cpp#L1168
-    int numDigits = ( lastOptIndex == 0 ? 1 : ((int) log10( (double)lastOptIndex ) + 1) );
-    int maxSize = strlen(fileName) + numDigits + 5;
-    char fileNameWithLastOptIndex[maxSize];
-    snprintf(fileNameWithLastOptIndex, maxSize, "%s%d.log", fileName, (int)lastOptIndex);
-    TR::FILE *jitCompilationLog = enableTracing ? trfopen(fileNameWithLastOptIndex, "ab", false) : NULL;
-    if (enableTracing)
-    {
+    // The method will execute the new body from now on so the reverted one can no longer be restored
+    bodyInfo->getMethodInfo()->setIsRevertedByDebugAgent(false);
+    revertedBodies->erase(jitMethod);
+
+    // Trace logs are captured in memory and only the difference between the good and the bad log is written out
+    TR::FILE *jitCompilationLog = enableTracing ? j9jit_fopenInMemory() : NULL;
+
+    // The debug agent settings are passed to the compilation through the command line options, which every
+    // compilation copies its options from, and from which they are sent to the server when running as a JITServer
+    // client. Traced recompilations are offloaded to the server, see isDebugAgentTracedRecompilation. AOT compilations
+    // copy their options from the AOT command line options, so those are set up the same way.
+    TR::Options *cmdLineOptions = TR::Options::getCmdLineOptions();
+    TR::Options *compileOptions = aotCompile ? TR::Options::getAOTCmdLineOptions() : cmdLineOptions;
+    if (NULL != jitCompilationLog)
+        {
+        // Only trace the IL before and after the last optimization performed along with the trace of the optimization
+        // itself, see J9::Compilation::reportOptimizationPhase
         plan->setLogCompilation(jitCompilationLog);
-        TR::Options::getCmdLineOptions()->setOption(TR_TraceAll);
-    }
+        int32_t firstTracedOptIndex = static_cast<int32_t>(std::max<IDATA>(lastOptIndex - 1, 0));
+        int32_t lastTracedOptIndex = static_cast<int32_t>(lastOptIndex < INT_MAX ? lastOptIndex + 1 : INT_MAX);
+        cmdLineOptions->setDebugAgentTraceOptIndexRange(firstTracedOptIndex, lastTracedOptIndex);
+        compileOptions->setDebugAgentTraceOptIndexRange(firstTracedOptIndex, lastTracedOptIndex);
+        }
+
+    compileOptions->setLastOptIndex(lastOptIndex);
+    compileOptions->setLastOptSubIndex(lastOptSubIndex);
+    compileOptions->setDebugAgentMaxInlinedCallSites(static_cast<int32_t>(std::min<IDATA>(maxInlinedCallSites, INT_MAX)));
+
+    // Remember which optimizations were already disabled to restore them afterwards. All of them are saved before any
+    // is disabled so that an optimization listed more than once is still restored to its original state.
+    bool wasDisabled[OMR::numOpts];
+    for (UDATA i = 0; i < disabledOptimizationCount; ++i)
+        {
+        OMR::Optimizations optimization = static_cast<OMR::Optimizations>(disabledOptimizations[i]);
+        if ((optimization >= 0) && (optimization < OMR::numOpts))
+            {
+            wasDisabled[optimization] = compileOptions->isDisabled(optimization);
+            }
+        }
+    for (UDATA i = 0; i < disabledOptimizationCount; ++i)
+        {
+        OMR::Optimizations optimization = static_cast<OMR::Optimizations>(disabledOptimizations[i]);
+        if ((optimization >= 0) && (optimization < OMR::numOpts))
+            {
+            compileOptions->setDisabled(optimization, true);
+            }
+        }
 
-    TR::Options::getCmdLineOptions()->setLastOptIndex(lastOptIndex);
-    TR::Options::getCmdLineOptions()->setLastOptSubIndex(lastOptSubIndex);
+    memset(TR::Options::_debugAgentPerformedOptimizations, 0, sizeof(TR::Options::_debugAgentPerformedOptimizations));
+    TR::Options::_debugAgentRecompiling = true;
 
     // This API is meant to be called from within JNI so we must acquire VM access here before queuing the compilation
     // beacuse we will attempt to release VM access right before a synchronous compilation
     vmThread->javaVM->internalVMFunctions->internalAcquireVMAccess(vmThread);
 
-    J9::JitDumpMethodDetails details(jitMethod->ramMethod, NULL, bodyInfo->getIsAotedBody());
+    // JitDump AOT compilations are relocated right away and never stored in the shared class cache
+    J9::JitDumpMethodDetails details(jitMethod->ramMethod, NULL, aotCompile);
     auto rc = compilationOK;
     auto queued = false;
+    I_64 compilationStartTime = j9time_nano_time();
     compInfo->compileMethod(vmThread, details, pc, TR_no, &rc, &queued, plan);
-    if (enableTracing)
+    I_64 compilationTime = j9time_nano_time() - compilationStartTime;
+    compileOptions->setDebugAgentMaxInlinedCallSites(-1);
+    TR::Options::_debugAgentRecompiling = false;
+
+    for (UDATA i = 0; i < disabledOptimizationCount; ++i)
+        {
+        OMR::Optimizations optimization = static_cast<OMR::Optimizations>(disabledOptimizations[i]);
+        if ((optimization >= 0) && (optimization < OMR::numOpts))
+            {
+            compileOptions->setDisabled(optimization, wasDisabled[optimization]);
+            }
+        }
+
+    UDATA codeSize = 0;
+    void *newPC = compInfo->getPCIfCompiled(jitMethod->ramMethod);
+    if ((compilationOK == rc) && (NULL != newPC))
+        {
+        J9JITExceptionTable *newJitMethod = jitConfig->jitGetExceptionTableFromPC(vmThread, reinterpret_cast<UDATA>(newPC));
+        if (NULL != newJitMethod)
+            {
+            codeSize = newJitMethod->endWarmPC - newJitMethod->startPC;
+            if (0 != newJitMethod->startColdPC)
+                codeSize += newJitMethod->endPC - newJitMethod->startColdPC;
+            }
+        }
+
+    UDATA traceLogBytes = 0;
+    if (NULL != jitCompilationLog)
+        {
+        traceLogBytes = jitCompilationLog->getBufferLength();
+        cmdLineOptions->setDebugAgentTraceOptIndexRange(-1, -1);
+        compileOptions->setDebugAgentTraceOptIndexRange(-1, -1);
+
+        if (goodLog)
+            {
+            // Keep the good log around until the bad log it is compared against has been captured
+            if (NULL != goodCompilationLog)
+                trfclose(goodCompilationLog);
+            goodCompilationLog = jitCompilationLog;
+            }
+        else
+            {
+            char diffFileName[64];
+            snprintf(diffFileName, sizeof(diffFileName), "jitCompilationLogDiff_opt_index_%d.log", (int)lastOptIndex);
+            TR::FILE *diffLog = trfopen(diffFileName, "wb", false);
+            if (NULL != diffLog)
+                {
+                writeCompilationLogDiff(diffLog, goodCompilationLog, jitCompilationLog);
+                trfflush(diffLog);
+                trfclose(diffLog);
+                fprintf(stderr, "Wrote JIT compilation log diff to %s\n", diffFileName);
+                }
+
+            trfclose(jitCompilationLog);
+            if (NULL != goodCompilationLog)
+                {
+                trfclose(goodCompilationLog);
+                goodCompilationLog = NULL;
+                }
+            }
+        }
+
+    vmThread->javaVM->internalVMFunctions->internalReleaseVMAccess(vmThread);
+
+    // JitDump compilations are only processed by the diagnostic thread, which remembers how far into the
+    // optimization strategy its last successful compilation got
+    if (NULL != result)
+        {
+        TR::CompilationInfoPerThread *diagnosticThreadInfo = compInfo->getCompilationInfoForDiagnosticThread();
+        result->compilationSucceeded = (compilationOK == rc) && (NULL != diagnosticThreadInfo);
+        result->lastPerformedOptIndex = result->compilationSucceeded ? diagnosticThreadInfo->getLastPerformedOptIndex() : -1;
+        result->lastPerformedOptSubIndex = result->compilationSucceeded ? diagnosticThreadInfo->getLastPerformedOptSubIndex() : -1;
+        result->inliningAttempts = result->compilationSucceeded ? diagnosticThreadInfo->getLastNumInliningAttempts() : -1;
+        result->compilationTime = static_cast<UDATA>(compilationTime / 1000);
+        result->codeSize = codeSize;
+        result->traceLogBytes = traceLogBytes;
+        }
+
+    return true;
+    }
+
+BOOLEAN
+debugAgentIsAotBody(J9VMThread* vmThread, J9JITExceptionTable *jitMethod)
     {
-        trfflush(jitCompilationLog);
-        trfclose(jitCompilationLog);
+    TR_PersistentJittedBodyInfo *bodyInfo = reinterpret_cast<TR_PersistentJittedBodyInfo *>(jitMethod->bodyInfo);
+    return (NULL != bodyInfo) && bodyInfo->getIsAotedBody();
     }
 
-    vmThread->javaVM->internalVMFunctions->internalReleaseVMAccess(vmThread);
+BOOLEAN
+debugAgentIsRevertible(J9VMThread* vmThread, J9JITExceptionTable *jitMethod)
+    {
+    // Without the switch to interpreter pre-prologue only the J9Method could be sent back to the interpreter, while
+    // callers already linked directly to the body would keep executing it. This is the case of the AOT bodies stored
+    // in a shared class cache by a JVM running without -Xjit:enableDebugAgentRevert.
+    TR_PersistentJittedBodyInfo *bodyInfo = reinterpret_cast<TR_PersistentJittedBodyInfo *>(jitMethod->bodyInfo);
+    return (NULL != bodyInfo) && bodyInfo->getHasSwitchToInterpreterPrePrologue();
+    }
+
+BOOLEAN
+debugAgentGetPerformedOptimizations(J9VMThread* vmThread, IDATA **optimizations, UDATA *optimizationCount)
+    {
+    PORT_ACCESS_FROM_VMC(vmThread);
+
+    *optimizations = NULL;
+    *optimizationCount = 0;
+
+    UDATA count = std::count(TR::Options::_debugAgentPerformedOptimizations, TR::Options::_debugAgentPerformedOptimizations + OMR::numOpts, true);
+    if (0 == count)
+        {
+        return true;
+        }
+
+    IDATA *performed = static_cast<IDATA *>(j9mem_allocate_memory(count * sizeof(IDATA), J9MEM_CATEGORY_JIT));
+    if (NULL == performed)
+        {
+        fprintf(stderr, "Could not allocate memory for %d optimizations\n", (int)count);
+        return false;
+        }
+
+    count = 0;
+    for (IDATA i = 0; i < OMR::numOpts; ++i)
+        {
+        if (TR::Options::_debugAgentPerformedOptimizations[i])
+            {
+            performed[count++] = i;
+            }
+        }
+
+    *optimizations = performed;
+    *optimizationCount = count;
 
     return true;
     }
 
+const char *
+debugAgentGetOptimizationName(IDATA optimization)
+    {
+    if ((optimization < 0) || (optimization >= OMR::numOpts))
+        {
+        return "unknown";
+        }
+
+    return OMR::Optimizer::getOptimizationName(static_cast<OMR::Optimizations>(optimization));
+    }
+
 BOOLEAN
 debugAgentEnd(J9VMThread* vmThread)
     {
@@ -362,6 +883,18 @@ debugAgentEnd(J9VMThread* vmThread)
 
     compInfo->getPersistentInfo()->setDisableFurtherCompilation(false);
 
+    for (auto it = revertedBodies->begin(); it != revertedBodies->end(); ++it)
+        {
+        reinterpret_cast<TR_PersistentJittedBodyInfo *>(it->first->bodyInfo)->getMethodInfo()->setIsRevertedByDebugAgent(false);
+        }
+    revertedBodies->clear();
+
+    if (NULL != goodCompilationLog)
+        {
+        trfclose(goodCompilationLog);
+        goodCompilationLog = NULL;
+        }
+
     compInfo->getCompilationInfoForDiagnosticThread()->suspendCompilationThread();
     return true;
     }
@@ -34,13 +34,28 @@ extern J9_CFUNC BOOLEAN
 debugAgentStart(J9VMThread* vmThread);
 
 extern J9_CFUNC BOOLEAN
-debugAgentGetAllJitMethods(J9VMThread* vmThread, jobject jitMethodSet);
+debugAgentGetAllJitMethods(J9VMThread* vmThread, J9JITExceptionTable ***jitMethods, UDATA *jitMethodCount);
 
 extern J9_CFUNC BOOLEAN
 debugAgentRevertToInterpreter(J9VMThread* vmThread, J9JITExceptionTable *jitMethod);
 
 extern J9_CFUNC BOOLEAN
-debugAgentRecompile(J9VMThread* vmThread, J9JITExceptionTable *jitMethod, IDATA lastOptIndex, IDATA lastOptSubIndex, BOOLEAN enableTracing, BOOLEAN goodLog);
+debugAgentRestoreJitMethod(J9VMThread* vmThread, J9JITExceptionTable *jitMethod);
+
+extern J9_CFUNC BOOLEAN
+debugAgentRecompile(J9VMThread* vmThread, J9JITExceptionTable *jitMethod, IDATA lastOptIndex, IDATA lastOptSubIndex, IDATA maxInlinedCallSites, IDATA *disabledOptimizations, UDATA disabledOptimizationCount, UDATA bodyKind, BOOLEAN enableTracing, BOOLEAN goodLog, J9DebugAgentRecompileResult *result);
+
+extern J9_CFUNC BOOLEAN
+debugAgentIsAotBody(J9VMThread* vmThread, J9JITExceptionTable *jitMethod);
+
+extern J9_CFUNC BOOLEAN
+debugAgentIsRevertible(J9VMThread* vmThread, J9JITExceptionTable *jitMethod);
+
+extern J9_CFUNC BOOLEAN
+debugAgentGetPerformedOptimizations(J9VMThread* vmThread, IDATA **optimizations, UDATA *optimizationCount);
+
+extern J9_CFUNC const char *
+debugAgentGetOptimizationName(IDATA optimization);
 
 extern J9_CFUNC BOOLEAN
 debugAgentEnd(J9VMThread* vmThread);
@@ -40,6 +40,7 @@
 #include "control/Recompilation.hpp"
 #include "control/RecompilationInfo.hpp"
 #include "env/CompilerEnv.hpp"
+#include "env/FilePointer.hpp"
 #include "env/IO.hpp"
 #include "env/VMJ9.h"
 #include "env/VerboseLog.hpp"
@@ -132,12 +133,19 @@ int64_t J9::Options::_oldAgeUnderLowMemory = 1000 * 60 * 5; // 5 minutes
 int64_t J9::Options::_timeBetweenPurges = 1000 * 60 * 1; // 1 minute
 bool J9::Options::_shareROMClasses = false;
 int32_t J9::Options::_sharedROMClassCacheNumPartitions = 16;
+bool J9::Options::_aggregateProfiles = false;
+int32_t J9::Options::_sharedProfileCacheMaxMemoryKB = 64 * 1024; // 64 MB
 int32_t J9::Options::_reconnectWaitTimeMs = 1000;
 int32_t J9::Options::_highActiveThreadThreshold = -1;
 int32_t J9::Options::_veryHighActiveThreadThreshold = -1;
 int32_t J9::Options::_aotCachePersistenceMinDeltaMethods = 200;
 int32_t J9::Options::_aotCachePersistenceMinPeriodMs = 10000; // ms
 int32_t J9::Options::_jitserverMallocTrimInterval = 1000 * 30; // 30000ms = 30s
+int32_t J9::Options::_jitserverMessageCompressionThreshold = 4096; // bytes
+int32_t J9::Options::_jitserverLatencyRoutingLocalCostPercent = 150; // Weight of the local compilation time estimate
+int32_t J9::Options::_jitserverLatencyRoutingProbeInterval = 16; // One in this many routing decisions picks the side that looks slower
+int32_t J9::Options::_jitserverFairSchedulingQuantum = 10000; // us; 0 serves the requests of all clients in arrival order
+int32_t J9::Options::_jitserverSchedulingWeight = 1; // Share of the server compilation time requested by this client, relative to other clients
 int32_t J9::Options::_lowCompDensityModeEnterThreshold = 4; // Maximum number of compilations per 10 min of CPU required to enter low compilation density mode. Use 0 to disable feature
 int32_t J9::Options::_lowCompDensityModeExitThreshold = 15; // Minimum number of compilations per 10 min of CPU required to exit low compilation density mode
 int32_t J9::Options::_lowCompDensityModeExitLPQSize = 120;  // Minimum number of compilations in LPQ to take us out of low compilation density mode
@@ -306,6 +314,12 @@ bool J9::Options::_aggressiveLockReservation = false;
 
 bool J9::Options::_xrsSync = false;
 
+bool J9::Options::_enableDebugAgentRevert = false;
+bool J9::Options::_debugAgentRecompiling = false;
+bool J9::Options::_debugAgentPerformedOptimizations[OMR::numOpts] = { false };
+TR::CompilationFilters *J9::Options::_debugAgentFaultFilters = NULL;
+int32_t J9::Options::_debugAgentFaultOptIndex = -1;
+
 /**
  * This string array should be kept in sync with the
  * J9::ExternalOptions enum in J9Options.hpp
@@ -390,7 +404,13 @@ const char * J9::Options::_externalOptionStrings[J9::ExternalOptions::TR_NumExte
    "-XX:+JITServerHealthProbes",          // = 74
    "-XX:-JITServerHealthProbes",          // = 75
    "-XX:JITServerHealthProbePort=",       // = 76
-   // TR_NumExternalOptions                  = 77
+   "-XX:+JITServerMessageCompression",    // = 77
+   "-XX:-JITServerMessageCompression",    // = 78
+   "-XX:+JITServerLatencyAwareRouting",   // = 79
+   "-XX:-JITServerLatencyAwareRouting",   // = 80
+   "-XX:+JITServerAggregateProfiles",     // = 81
+   "-XX:-JITServerAggregateProfiles",     // = 82
+   // TR_NumExternalOptions                  = 83
    };
 
 //************************************************************************
@@ -806,6 +826,24 @@ Options::JITServerRemoteExclude(const char *option, void *base, TR::OptionTable
    }
 #endif /* defined(J9VM_OPT_JITSERVER) */
 
+const char *
+Options::debugAgentFaultMethodOption(const char *option, void *base, TR::OptionTable *entry)
+   {
+   if (!TR::Options::getDebug() && !TR::Options::createDebug())
+      return 0;
+   if (TR::Options::getJITCmdLineOptions() != NULL)
+      {
+      return TR::Options::getDebug()->limitOption(option, base, entry, TR::Options::getJITCmdLineOptions(), _debugAgentFaultFilters);
+      }
+   else
+      {
+      J9JITConfig * jitConfig = (J9JITConfig*)base;
+      PORT_ACCESS_FROM_JAVAVM(jitConfig->javaVM);
+      j9tty_printf(PORTLIB, "<JIT: debugAgentFaultMethod option should be specified on -Xjit --> '%s'>\n", option);
+      return option;
+      }
+   }
+
 const char *
 Options::tprofOption(const char *option, void *base, TR::OptionTable *entry)
    {
@@ -937,10 +975,16 @@ TR::OptionTable OMR::Options::_feOptions[] = {
         TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_dataCacheQuantumSize, 0, "F%d", NOT_IN_SUBSET},
    {"datatotal=",              "C<nnn>\ttotal data memory limit, in KB",
         TR::Options::setJitConfigNumericValue, offsetof(J9JITConfig, dataCacheTotalKB), 0, "F%d (KB)"},
+   {"debugAgentFaultMethod=", "D{regex}\ttest only: plant a fault into the IL of methods matching regex, see debugAgentFaultOptIndex",
+        TR::Options::debugAgentFaultMethodOption, 0, 0, "P%s"},
+   {"debugAgentFaultOptIndex=", "D<nnn>\ttest only: optimization index at which the fault of debugAgentFaultMethod is planted",
+        TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_debugAgentFaultOptIndex, 0, "F%d", NOT_IN_SUBSET },
    {"disableIProfilerClassUnloadThreshold=",      "R<nnn>\tNumber of classes that can be unloaded before we disable the IProfiler",
         TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_disableIProfilerClassUnloadThreshold, 0, "F%d", NOT_IN_SUBSET},
    {"dltPostponeThreshold=",      "M<nnn>\tNumber of dlt attempts inv. count for a method is seen not advancing",
         TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_dltPostponeThreshold, 0, "F%d", NOT_IN_SUBSET },
+   {"enableDebugAgentRevert", "D\tgenerate a switch to interpreter pre-prologue in every recompilable body so the JIT debug agent can revert it",
+        TR::Options::setStaticBool, (intptr_t)&TR::Options::_enableDebugAgentRevert, 1, "F%d", NOT_IN_SUBSET },
    {"exclude=",           "D<xxx>\tdo not compile methods beginning with xxx", TR::Options::limitOption, 1, 0, "P%s"},
    {"expensiveCompWeight=", "M<nnn>\tweight of a comp request to be considered expensive",
         TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_expensiveCompWeight, 0, "F%d", NOT_IN_SUBSET },
@@ -1066,8 +1110,18 @@ TR::OptionTable OMR::Options::_feOptions[] = {
         TR::Options::JITServerAOTCacheLoadLimitOption, 1, 0, "P%s"},
    {"jitserverAOTCacheStoreExclude=", "D{regex}\tdo not store methods matching regex in the JITServer AOT cache",
         TR::Options::JITServerAOTCacheStoreLimitOption, 1, 0, "P%s"},
+   {"jitserverFairSchedulingQuantum=", "M<nnn>\tcompilation time credited to a client in each round of the fair scheduling of JITServer requests (us). 0 disables fair scheduling",
+        TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_jitserverFairSchedulingQuantum, 0, "F%d", NOT_IN_SUBSET },
    {"jitserverMallocTrimInterval=", "M<nnn>\tmiminum time between two consecutive JITServer client malloc_trim invocations (ms)",
         TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_jitserverMallocTrimInterval, 0, "F%d", NOT_IN_SUBSET },
+   {"jitserverMessageCompressionThreshold=", "M<nnn>\tminimum size of a JITServer message to be compressed (bytes)",
+        TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_jitserverMessageCompressionThreshold, 0, "F%d", NOT_IN_SUBSET },
+   {"jitserverLatencyRoutingLocalCostPercent=", "M<nnn>\tweight of the local compilation time when choosing between a local and a remote compilation (%)",
+        TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_jitserverLatencyRoutingLocalCostPercent, 0, "F%d", NOT_IN_SUBSET },
+   {"jitserverLatencyRoutingProbeInterval=", "M<nnn>\tone in this many compilations goes to the side expected to be slower, to keep its latency estimate current. 0 disables probing",
+        TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_jitserverLatencyRoutingProbeInterval, 0, "F%d", NOT_IN_SUBSET },
+   {"jitserverSchedulingWeight=", "M<nnn>\tshare of the JITServer compilation time requested by this client, relative to the other clients of the server",
+        TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_jitserverSchedulingWeight, 0, "F%d", NOT_IN_SUBSET },
 #endif /* defined(J9VM_OPT_JITSERVER) */
    {"jProfilingEnablementSampleThreshold=", "M<nnn>\tNumber of global samples to allow generation of JProfiling bodies",
         TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_jProfilingEnablementSampleThreshold, 0, "F%d", NOT_IN_SUBSET },
@@ -1185,6 +1239,8 @@ TR::OptionTable OMR::Options::_feOptions[] = {
    {"seriousCompFailureThreshold=",     "M<nnn>\tnumber of srious compilation failures after which we write a trace point in the snap file",
         TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_seriousCompFailureThreshold, 0, "F%d", NOT_IN_SUBSET},
 #if defined(J9VM_OPT_JITSERVER)
+   {"sharedProfileCacheMaxMemoryKB=", "M<nnn>\tLimit for memory used by the IProfiler data aggregated across JITServer clients (in KB)",
+        TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_sharedProfileCacheMaxMemoryKB, 0, "F%d", NOT_IN_SUBSET},
    {"sharedROMClassCacheNumPartitions=", " \tnumber of JITServer ROMClass cache partitions (each has its own monitor)",
         TR::Options::setStaticNumeric, (intptr_t)&TR::Options::_sharedROMClassCacheNumPartitions, 0, "F%d", NOT_IN_SUBSET},
 #endif /* defined(J9VM_OPT_JITSERVER) */
@@ -1351,6 +1407,10 @@ J9::Options::JITServerParseCommonOptions(J9VMInitArgs *vmArgsArray, J9JavaVM *vm
    const char *xxJITServerLogConnections = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXplusJITServerLogConnections];
    const char *xxDisableJITServerLogConnections = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXminusJITServerLogConnections];
    const char *xxJITServerAOTmxOption = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXJITServerAOTmxOption];
+   const char *xxJITServerMessageCompressionOption = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXplusJITServerMessageCompression];
+   const char *xxDisableJITServerMessageCompressionOption = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXminusJITServerMessageCompression];
+   const char *xxJITServerLatencyAwareRoutingOption = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXplusJITServerLatencyAwareRouting];
+   const char *xxDisableJITServerLatencyAwareRoutingOption = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXminusJITServerLatencyAwareRouting];
 
    int32_t xxJITServerPortArgIndex = FIND_ARG_IN_ARGS(vmArgsArray, STARTSWITH_MATCH, xxJITServerPortOption, 0);
    int32_t xxJITServerTimeoutArgIndex = FIND_ARG_IN_ARGS(vmArgsArray, STARTSWITH_MATCH, xxJITServerTimeoutOption, 0);
@@ -1364,6 +1424,10 @@ J9::Options::JITServerParseCommonOptions(J9VMInitArgs *vmArgsArray, J9JavaVM *vm
    int32_t xxJITServerLogConnectionsArgIndex = FIND_ARG_IN_ARGS(vmArgsArray, EXACT_MATCH, xxJITServerLogConnections, 0);
    int32_t xxDisableJITServerLogConnectionsArgIndex = FIND_ARG_IN_ARGS(vmArgsArray, EXACT_MATCH, xxDisableJITServerLogConnections, 0);
    int32_t xxJITServerAOTmxArgIndex = FIND_ARG_IN_ARGS(vmArgsArray, STARTSWITH_MATCH, xxJITServerAOTmxOption, 0);
+   int32_t xxJITServerMessageCompressionArgIndex = FIND_ARG_IN_ARGS(vmArgsArray, EXACT_MATCH, xxJITServerMessageCompressionOption, 0);
+   int32_t xxDisableJITServerMessageCompressionArgIndex = FIND_ARG_IN_ARGS(vmArgsArray, EXACT_MATCH, xxDisableJITServerMessageCompressionOption, 0);
+   int32_t xxJITServerLatencyAwareRoutingArgIndex = FIND_ARG_IN_ARGS(vmArgsArray, EXACT_MATCH, xxJITServerLatencyAwareRoutingOption, 0);
+   int32_t xxDisableJITServerLatencyAwareRoutingArgIndex = FIND_ARG_IN_ARGS(vmArgsArray, EXACT_MATCH, xxDisableJITServerLatencyAwareRoutingOption, 0);
 
    if (xxJITServerPortArgIndex >= 0)
       {
@@ -1446,6 +1510,14 @@ J9::Options::JITServerParseCommonOptions(J9VMInitArgs *vmArgsArray, J9JavaVM *vm
          }
       }
 
+   // Message compression is negotiated through the configuration flags, so it has to be enabled at both the client and the server
+   if (xxJITServerMessageCompressionArgIndex > xxDisableJITServerMessageCompressionArgIndex)
+      compInfo->getPersistentInfo()->setJITServerMessageCompression(true);
+
+   // Only used at the client
+   if (xxJITServerLatencyAwareRoutingArgIndex > xxDisableJITServerLatencyAwareRoutingArgIndex)
+      compInfo->getPersistentInfo()->setJITServerLatencyAwareRouting(true);
+
    return true;
    }
 
@@ -2374,6 +2446,17 @@ bool J9::Options::preProcessJitServer(J9JavaVM *vm, J9JITConfig *jitConfig)
             disabledShareROMClasses = true;
             }
 
+         // Check if IProfiler data should be aggregated across clients
+         const char *xxJITServerAggregateProfilesOption = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXplusJITServerAggregateProfiles];
+         const char *xxDisableJITServerAggregateProfilesOption = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXminusJITServerAggregateProfiles];
+
+         int32_t xxJITServerAggregateProfilesArgIndex = FIND_ARG_IN_VMARGS(EXACT_MATCH, xxJITServerAggregateProfilesOption, 0);
+         int32_t xxDisableJITServerAggregateProfilesArgIndex = FIND_ARG_IN_VMARGS(EXACT_MATCH, xxDisableJITServerAggregateProfilesOption, 0);
+         if (xxJITServerAggregateProfilesArgIndex > xxDisableJITServerAggregateProfilesArgIndex)
+            {
+            _aggregateProfiles = true;
+            }
+
          // Check if the JITServer AOT cache persistence feature is enabled
          const char *xxJITServerAOTCachePersistenceOption = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXplusJITServerAOTCachePersistenceOption];
          const char *xxDisableJITServerAOTCachePersistenceOption = J9::Options::_externalOptionStrings[J9::ExternalOptions::XXminusJITServerAOTCachePersistenceOption];
@@ -2549,6 +2632,14 @@ bool J9::Options::preProcessJitServer(J9JavaVM *vm, J9JITConfig *jitConfig)
          // Enable ROMClass sharing at the server by default (unless explicitly disabled) if using AOT cache
          _shareROMClasses = true;
          }
+      if (_aggregateProfiles)
+         {
+         // Aggregated IProfiler data is keyed by the hashes of shared ROMClasses
+         if (disabledShareROMClasses)
+            _aggregateProfiles = false;
+         else
+            _shareROMClasses = true;
+         }
       if ((compInfo->getPersistentInfo()->getRemoteCompilationMode() == JITServer::CLIENT) &&
            compInfo->getPersistentInfo()->getJITServerUseAOTCache())
          {
@@ -3674,6 +3765,13 @@ J9::Options::packLogFile(TR::FILE *fp)
    {
    if (fp == NULL)
       return "";
+   // Traced JIT debug agent recompilations are logged in memory, see setLogFileForClientOptions
+   if (fp->isInMemory())
+      {
+      std::string logFileStr(fp->getBuffer(), fp->getBufferLength());
+      logFileStr.append("</jitlog>\n");
+      return logFileStr;
+      }
    const size_t BUFFER_SIZE = 4096; // 4KB
    char buf[BUFFER_SIZE + 1];
    std::string logFileStr("");
@@ -3730,14 +3828,20 @@ TR_Debug *createDebugObject(TR::Compilation *);
 // Side effect: set _logFile
 // At the client: Triggered when a remote compilation is followed by a local compilation.
 //                suffixNumber is the compilationSequenceNumber used for the remote compilation.
-// At the server: suffixNumber is set as 0.
+// At the server: suffixNumber is set as 0. Traced JIT debug agent recompilations offloaded by the client are
+//                logged in memory rather than to a file, since the log is only sent back to the client.
 void
 J9::Options::setLogFileForClientOptions(int suffixNumber)
    {
-   if (_logFileName)
+   bool logInMemory = (0 == suffixNumber) && !_logFileName && (_debugAgentTraceFirstOptIndex >= 0);
+   if (_logFileName || logInMemory)
       {
       _fe->acquireLogMonitor();
-      if (suffixNumber)
+      if (logInMemory)
+         {
+         _logFile = j9jit_fopenInMemory();
+         }
+      else if (suffixNumber)
          {
          self()->setOption(TR_EnablePIDExtension, true);
          self()->openLogFile(suffixNumber);
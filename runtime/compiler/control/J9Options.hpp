@@ -130,14 +130,25 @@ enum ExternalOptions
    XXplusHealthProbes                          = 74,
    XXminusHealthProbes                         = 75,
    XXJITServerHealthProbePortOption            = 76,
-   TR_NumExternalOptions                       = 77
+   XXplusJITServerMessageCompression           = 77,
+   XXminusJITServerMessageCompression          = 78,
+   XXplusJITServerLatencyAwareRouting          = 79,
+   XXminusJITServerLatencyAwareRouting         = 80,
+   XXplusJITServerAggregateProfiles            = 81,
+   XXminusJITServerAggregateProfiles           = 82,
+   TR_NumExternalOptions                       = 83
    };
 
 class OMR_EXTENSIBLE Options : public OMR::OptionsConnector
    {
    public:
 
-   Options() : OMR::OptionsConnector() {}
+   Options()
+      : OMR::OptionsConnector(),
+        _debugAgentTraceFirstOptIndex(-1),
+        _debugAgentTraceLastOptIndex(-1),
+        _debugAgentMaxInlinedCallSites(-1)
+      {}
 
    Options(TR_Memory * m,
            int32_t index,
@@ -150,7 +161,12 @@ class OMR_EXTENSIBLE Options : public OMR::OptionsConnector
       : OMR::OptionsConnector(m,index,lineNumber,compilee,oldStartPC,optimizationPlan,isAOT,compThreadID)
       {}
 
-   Options(TR::Options &other) : OMR::OptionsConnector(other) {}
+   Options(TR::Options &other)
+      : OMR::OptionsConnector(other),
+        _debugAgentTraceFirstOptIndex(other.getDebugAgentTraceFirstOptIndex()),
+        _debugAgentTraceLastOptIndex(other.getDebugAgentTraceLastOptIndex()),
+        _debugAgentMaxInlinedCallSites(other.getDebugAgentMaxInlinedCallSites())
+      {}
 
    enum FSDInitStatus
       {
@@ -371,12 +387,19 @@ class OMR_EXTENSIBLE Options : public OMR::OptionsConnector
    static int64_t _timeBetweenPurges;
    static bool _shareROMClasses;
    static int32_t _sharedROMClassCacheNumPartitions;
+   static bool _aggregateProfiles;
+   static int32_t _sharedProfileCacheMaxMemoryKB;
    static int32_t _reconnectWaitTimeMs;
    static const uint32_t DEFAULT_JITCLIENT_TIMEOUT = 30000; // ms
    static const uint32_t DEFAULT_JITSERVER_TIMEOUT = 30000; // ms
    static int32_t _aotCachePersistenceMinDeltaMethods;
    static int32_t _aotCachePersistenceMinPeriodMs;
    static int32_t _jitserverMallocTrimInterval;
+   static int32_t _jitserverMessageCompressionThreshold;
+   static int32_t _jitserverLatencyRoutingLocalCostPercent;
+   static int32_t _jitserverLatencyRoutingProbeInterval;
+   static int32_t _jitserverFairSchedulingQuantum;
+   static int32_t _jitserverSchedulingWeight;
    static int32_t _lowCompDensityModeEnterThreshold;
    static int32_t _lowCompDensityModeExitThreshold;
    static int32_t _lowCompDensityModeExitLPQSize;
@@ -449,6 +472,17 @@ class OMR_EXTENSIBLE Options : public OMR::OptionsConnector
 
    static bool _xrsSync;
 
+   static bool _enableDebugAgentRevert;
+
+   // Set while the JIT debug agent recompiles a method, along with the optimizations performed by the recompilation
+   static bool _debugAgentRecompiling;
+   static bool _debugAgentPerformedOptimizations[OMR::numOpts];
+
+   // Test only: methods and optimization index at which a fault is planted into the IL, to measure how quickly the
+   // JIT debug agent finds a known miscompilation
+   static TR::CompilationFilters *_debugAgentFaultFilters;
+   static int32_t _debugAgentFaultOptIndex;
+
    static const char * _externalOptionStrings[ExternalOptions::TR_NumExternalOptions];
 
    static void  printPID();
@@ -478,6 +512,8 @@ class OMR_EXTENSIBLE Options : public OMR::OptionsConnector
 
    static const char *vmStateOption(const char *option, void *, TR::OptionTable *entry);
 
+   static const char *debugAgentFaultMethodOption(const char *option, void *base, TR::OptionTable *entry);
+
    static const char *setJitConfigRuntimeFlag(const char *option, void *base, TR::OptionTable *entry);
    static const char *resetJitConfigRuntimeFlag(const char *option, void *base, TR::OptionTable *entry);
    static const char *setJitConfigNumericValue(const char *option, void *base, TR::OptionTable *entry);
@@ -644,6 +680,25 @@ class OMR_EXTENSIBLE Options : public OMR::OptionsConnector
    void closeLogFileForClientOptions();
 #endif /* defined(J9VM_OPT_JITSERVER) */
 
+   /**
+    * \brief Range of optimization indices traced by JIT debug agent recompilations, -1 when the debug agent is not
+    *        tracing. Kept per options object rather than globally so the range travels to a JITServer along with
+    *        the rest of the options of an offloaded recompilation.
+    */
+   int32_t getDebugAgentTraceFirstOptIndex() const { return _debugAgentTraceFirstOptIndex; }
+   int32_t getDebugAgentTraceLastOptIndex() const { return _debugAgentTraceLastOptIndex; }
+   void setDebugAgentTraceOptIndexRange(int32_t first, int32_t last)
+      {
+      _debugAgentTraceFirstOptIndex = first;
+      _debugAgentTraceLastOptIndex = last;
+      }
+
+   /**
+    * \brief Number of inlining attempts allowed in JIT debug agent recompilations, -1 when inlining is not limited
+    */
+   int32_t getDebugAgentMaxInlinedCallSites() const { return _debugAgentMaxInlinedCallSites; }
+   void setDebugAgentMaxInlinedCallSites(int32_t max) { _debugAgentMaxInlinedCallSites = max; }
+
 #if defined(J9VM_OPT_CRIU_SUPPORT)
    /**
     * \brief Static method used to reset FSD post-restore
@@ -676,6 +731,10 @@ class OMR_EXTENSIBLE Options : public OMR::OptionsConnector
 
    private:
 
+   int32_t _debugAgentTraceFirstOptIndex;
+   int32_t _debugAgentTraceLastOptIndex;
+   int32_t _debugAgentMaxInlinedCallSites;
+
 #if defined(J9VM_OPT_JITSERVER)
    static const char *JITServerAOTCacheLimitOption(const char *option, void *base, TR::OptionTable *entry, TR::CompilationFilters *&filters, const char *optName);
 #endif /* defined(J9VM_OPT_JITSERVER) */
@@ -327,6 +327,7 @@ J9::Recompilation::endOfCompilation()
 
       _bodyInfo->setHasLoops        (_compilation->mayHaveLoops());
       _bodyInfo->setUsesPreexistence(_compilation->usesPreexistence());
+      _bodyInfo->setHasSwitchToInterpreterPrePrologue(_compilation->cg()->mustGenerateSwitchToInterpreterPrePrologue());
 
       // if the only future compilation can be a forced one (preexistence)
       // do not sample this method.  If this is a counting based compilation
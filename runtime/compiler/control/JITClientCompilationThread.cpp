@@ -20,6 +20,7 @@
  * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
  *******************************************************************************/
 
+#include <algorithm>
 #include "j9cfg.h"
 #include "jitprotos.h"
 #include "vmaccess.h"
@@ -31,6 +32,7 @@
 #include "control/MethodToBeCompiled.hpp"
 #include "env/ClassLoaderTable.hpp"
 #include "env/ClassTableCriticalSection.hpp"
+#include "env/FilePointer.hpp"
 #include "env/J2IThunk.hpp"
 #include "env/j9methodServer.hpp"
 #include "env/JITServerPersistentCHTable.hpp"
@@ -110,6 +112,108 @@ findField(J9VMThread *vmStruct, J9ConstantPool *constantPool, UDATA index, BOOLE
    return result;
    }
 
+static void
+getMultipleResolvedMethods(TR::Compilation *comp, TR_J9VM *fe, TR_ResolvedJ9Method *owningMethod,
+                           const std::vector<TR_ResolvedMethodType> &methodTypes, const std::vector<int32_t> &cpIndices,
+                           std::vector<TR_OpaqueMethodBlock *> &ramMethods, std::vector<uint32_t> &vTableOffsets,
+                           std::vector<TR_ResolvedJ9JITServerMethodInfo> &methodInfos)
+   {
+   int32_t numMethods = methodTypes.size();
+   ramMethods.resize(numMethods);
+   vTableOffsets.resize(numMethods);
+   methodInfos.resize(numMethods);
+   for (int32_t i = 0; i < numMethods; ++i)
+      {
+      int32_t cpIndex = cpIndices[i];
+      TR_ResolvedMethodType type = methodTypes[i];
+      TR_ResolvedJ9Method *resolvedMethod = NULL;
+      TR_OpaqueMethodBlock *ramMethod = NULL;
+      uint32_t vTableOffset = 0;
+      TR_ResolvedJ9JITServerMethodInfo methodInfo;
+      bool unresolvedInCP = false;
+      switch (type)
+         {
+         case TR_ResolvedMethodType::VirtualFromCP:
+            {
+            resolvedMethod = static_cast<TR_ResolvedJ9Method *>(owningMethod->getResolvedPossiblyPrivateVirtualMethod(comp, cpIndex, true, &unresolvedInCP));
+            vTableOffset = resolvedMethod ? resolvedMethod->vTableSlot(cpIndex) : 0;
+            break;
+            }
+         case TR_ResolvedMethodType::Static:
+            {
+            resolvedMethod = static_cast<TR_ResolvedJ9Method *>(owningMethod->getResolvedStaticMethod(comp, cpIndex, &unresolvedInCP));
+            break;
+            }
+         case TR_ResolvedMethodType::Special:
+            {
+            resolvedMethod = static_cast<TR_ResolvedJ9Method *>(owningMethod->getResolvedSpecialMethod(comp, cpIndex, &unresolvedInCP));
+            break;
+            }
+         case TR_ResolvedMethodType::ImproperInterface:
+            {
+            resolvedMethod = static_cast<TR_ResolvedJ9Method *>(owningMethod->getResolvedImproperInterfaceMethod(comp, cpIndex));
+            vTableOffset = resolvedMethod ? resolvedMethod->vTableSlot(cpIndex) : 0;
+            break;
+            }
+         default:
+            {
+            break;
+            }
+         }
+      if (resolvedMethod)
+         {
+         TR_ResolvedJ9JITServerMethod::packMethodInfo(methodInfo, resolvedMethod, fe);
+         ramMethod = resolvedMethod->getPersistentIdentifier();
+         }
+      ramMethods[i] = ramMethod;
+      vTableOffsets[i] = vTableOffset;
+      methodInfos[i] = methodInfo;
+      }
+   }
+
+static void
+getFields(TR_J9VM *fe, TR_ResolvedJ9Method *owningMethod, const std::vector<int32_t> &cpIndices, const std::vector<uint8_t> &isStatic,
+          std::vector<J9Class *> &declaringClasses, std::vector<UDATA> &fields)
+   {
+   int32_t numFields = cpIndices.size();
+   declaringClasses.reserve(numFields);
+   fields.reserve(numFields);
+
+   J9ConstantPool *cp = reinterpret_cast<J9ConstantPool *>(owningMethod->ramConstantPool());
+   for (int32_t i = 0; i < numFields; ++i)
+      {
+      J9Class *declaringClass;
+      // do we need to check if the field is resolved?
+      UDATA field = findField(fe->vmThread(), cp, cpIndices[i], isStatic[i], &declaringClass);
+      declaringClasses.push_back(declaringClass);
+      fields.push_back(field);
+      }
+   }
+
+static TR_J9MethodFieldAttributes
+getFieldAttributes(TR::Compilation *comp, TR_ResolvedJ9Method *method, int32_t cpIndex, bool isStatic, bool isStore, bool needAOTValidation)
+   {
+   // TODO: I'm fairly sure this should be false always
+   needAOTValidation = needAOTValidation && !comp->ignoringLocalSCC();
+   TR::DataType type = TR::NoType;
+   bool volatileP = true;
+   bool isFinal = false;
+   bool isPrivate = false;
+   bool unresolvedInCP;
+   if (isStatic)
+      {
+      void *address;
+      bool result = method->staticAttributes(comp, cpIndex, &address, &type, &volatileP, &isFinal, &isPrivate, isStore, &unresolvedInCP, needAOTValidation);
+      return TR_J9MethodFieldAttributes(reinterpret_cast<uintptr_t>(address), type.getDataType(), volatileP, isFinal, isPrivate, unresolvedInCP, result);
+      }
+   else
+      {
+      U_32 fieldOffset;
+      bool result = method->fieldAttributes(comp, cpIndex, &fieldOffset, &type, &volatileP, &isFinal, &isPrivate, isStore, &unresolvedInCP, needAOTValidation);
+      return TR_J9MethodFieldAttributes(static_cast<uintptr_t>(fieldOffset), type.getDataType(), volatileP, isFinal, isPrivate, unresolvedInCP, result);
+      }
+   }
+
 static void
 handler_IProfiler_profilingSample(JITServer::ClientStream *client, TR_J9VM *fe, TR::Compilation *comp)
    {
@@ -550,6 +654,7 @@ handleServerMessage(JITServer::ClientStream *client, TR_J9VM *fe, JITServer::Mes
 #else
          vmInfo._isNonPortableRestoreMode = false;
 #endif /* defined(J9VM_OPT_CRIU_SUPPORT) */
+         vmInfo._schedulingWeight = TR::Options::_jitserverSchedulingWeight;
          client->write(response, vmInfo, listOfCacheDescriptors, comp->getPersistentInfo()->getJITServerAOTCacheName());
          }
          break;
@@ -1065,31 +1170,6 @@ handleServerMessage(JITServer::ClientStream *client, TR_J9VM *fe, JITServer::Mes
          client->write(response, fe->getObjectSizeClass(std::get<0>(recv)));
          }
          break;
-      case MessageType::VM_getFields:
-         {
-         auto recv = client->getRecvData<TR_ResolvedJ9Method *, std::vector<int32_t>, std::vector<uint8_t>>();
-         TR_ResolvedJ9Method *owningMethod = std::get<0>(recv);
-         auto &cpIndices = std::get<1>(recv);
-         auto &isStatic = std::get<2>(recv);
-
-         int32_t numFields = cpIndices.size();
-         std::vector<J9Class *> declaringClasses;
-         std::vector<UDATA> fields;
-         declaringClasses.reserve(numFields);
-         fields.reserve(numFields);
-
-         J9ConstantPool *cp = reinterpret_cast<J9ConstantPool *>(owningMethod->ramConstantPool());
-         for (int32_t i = 0; i < numFields; ++i)
-            {
-            J9Class *declaringClass;
-            // do we need to check if the field is resolved?
-            UDATA field = findField(fe->vmThread(), cp, cpIndices[i], isStatic[i], &declaringClass);
-            declaringClasses.push_back(declaringClass);
-            fields.push_back(field);
-            }
-         client->write(response, declaringClasses, fields);
-         }
-         break;
       case MessageType::VM_increaseOSRGlobalBufferSize:
          {
          auto recv = client->getRecvData<uintptr_t, uintptr_t, uintptr_t>();
@@ -1261,21 +1341,7 @@ handleServerMessage(JITServer::ClientStream *client, TR_J9VM *fe, JITServer::Mes
       case MessageType::ResolvedMethod_staticAttributes:
          {
          auto recv = client->getRecvData<TR_ResolvedJ9Method *, int32_t, bool, bool>();
-         TR_ResolvedJ9Method *method = std::get<0>(recv);
-         int32_t cpIndex = std::get<1>(recv);
-         int32_t isStore = std::get<2>(recv);
-         int32_t needAOTValidation = std::get<3>(recv);
-         // TODO: I'm fairly sure this should be false always
-         needAOTValidation = needAOTValidation && !comp->ignoringLocalSCC();
-         void *address;
-         TR::DataType type = TR::NoType;
-         bool volatileP = true;
-         bool isFinal = false;
-         bool isPrivate = false;
-         bool unresolvedInCP;
-         bool result = method->staticAttributes(comp, cpIndex, &address, &type, &volatileP, &isFinal, &isPrivate, isStore, &unresolvedInCP, needAOTValidation);
-         TR_J9MethodFieldAttributes attrs(reinterpret_cast<uintptr_t>(address), type.getDataType(), volatileP, isFinal, isPrivate, unresolvedInCP, result);
-         client->write(response, attrs);
+         client->write(response, getFieldAttributes(comp, std::get<0>(recv), std::get<1>(recv), true, std::get<2>(recv), std::get<3>(recv)));
          }
          break;
       case MessageType::ResolvedMethod_definingClassFromCPFieldRef:
@@ -1316,21 +1382,7 @@ handleServerMessage(JITServer::ClientStream *client, TR_J9VM *fe, JITServer::Mes
       case MessageType::ResolvedMethod_fieldAttributes:
          {
          auto recv = client->getRecvData<TR_ResolvedJ9Method *, int32_t, bool, bool>();
-         TR_ResolvedJ9Method *method = std::get<0>(recv);
-         I_32 cpIndex = std::get<1>(recv);
-         bool isStore = std::get<2>(recv);
-         bool needAOTValidation = std::get<3>(recv);
-         // TODO: I'm fairly sure this should be false always
-         needAOTValidation = needAOTValidation && !comp->ignoringLocalSCC();
-         U_32 fieldOffset;
-         TR::DataType type = TR::NoType;
-         bool volatileP = true;
-         bool isFinal = false;
-         bool isPrivate = false;
-         bool unresolvedInCP;
-         bool result = method->fieldAttributes(comp, cpIndex, &fieldOffset, &type, &volatileP, &isFinal, &isPrivate, isStore, &unresolvedInCP, needAOTValidation);
-         TR_J9MethodFieldAttributes attrs(static_cast<uintptr_t>(fieldOffset), type.getDataType(), volatileP, isFinal, isPrivate, unresolvedInCP, result);
-         client->write(response, attrs);
+         client->write(response, getFieldAttributes(comp, std::get<0>(recv), std::get<1>(recv), false, std::get<2>(recv), std::get<3>(recv)));
          }
          break;
       case MessageType::ResolvedMethod_getResolvedStaticMethodAndMirror:
@@ -1750,63 +1802,48 @@ handleServerMessage(JITServer::ClientStream *client, TR_J9VM *fe, JITServer::Mes
       case MessageType::ResolvedMethod_getMultipleResolvedMethods:
          {
          auto recv = client->getRecvData<TR_ResolvedJ9Method *, std::vector<TR_ResolvedMethodType>, std::vector<int32_t>>();
-         auto owningMethod = std::get<0>(recv);
-         auto &methodTypes = std::get<1>(recv);
-         auto &cpIndices = std::get<2>(recv);
-         int32_t numMethods = methodTypes.size();
-         std::vector<TR_OpaqueMethodBlock *> ramMethods(numMethods);
-         std::vector<uint32_t> vTableOffsets(numMethods);
-         std::vector<TR_ResolvedJ9JITServerMethodInfo> methodInfos(numMethods);
-         for (int32_t i = 0; i < numMethods; ++i)
-            {
-            int32_t cpIndex = cpIndices[i];
-            TR_ResolvedMethodType type = methodTypes[i];
-            TR_ResolvedJ9Method *resolvedMethod = NULL;
-            TR_OpaqueMethodBlock *ramMethod = NULL;
-            uint32_t vTableOffset = 0;
-            TR_ResolvedJ9JITServerMethodInfo methodInfo;
-            bool unresolvedInCP = false;
-            switch (type)
-               {
-               case TR_ResolvedMethodType::VirtualFromCP:
-                  {
-                  resolvedMethod = static_cast<TR_ResolvedJ9Method *>(owningMethod->getResolvedPossiblyPrivateVirtualMethod(comp, cpIndex, true, &unresolvedInCP));
-                  vTableOffset = resolvedMethod ? resolvedMethod->vTableSlot(cpIndex) : 0;
-                  break;
-                  }
-               case TR_ResolvedMethodType::Static:
-                  {
-                  resolvedMethod = static_cast<TR_ResolvedJ9Method *>(owningMethod->getResolvedStaticMethod(comp, cpIndex, &unresolvedInCP));
-                  break;
-                  }
-               case TR_ResolvedMethodType::Special:
-                  {
-                  resolvedMethod = static_cast<TR_ResolvedJ9Method *>(owningMethod->getResolvedSpecialMethod(comp, cpIndex, &unresolvedInCP));
-                  break;
-                  }
-               case TR_ResolvedMethodType::ImproperInterface:
-                  {
-                  resolvedMethod = static_cast<TR_ResolvedJ9Method *>(owningMethod->getResolvedImproperInterfaceMethod(comp, cpIndex));
-                  vTableOffset = resolvedMethod ? resolvedMethod->vTableSlot(cpIndex) : 0;
-                  break;
-                  }
-               default:
-                  {
-                  break;
-                  }
-               }
-            if (resolvedMethod)
-               {
-               TR_ResolvedJ9JITServerMethod::packMethodInfo(methodInfo, resolvedMethod, fe);
-               ramMethod = resolvedMethod->getPersistentIdentifier();
-               }
-            ramMethods[i] = ramMethod;
-            vTableOffsets[i] = vTableOffset;
-            methodInfos[i] = methodInfo;
-            }
+         std::vector<TR_OpaqueMethodBlock *> ramMethods;
+         std::vector<uint32_t> vTableOffsets;
+         std::vector<TR_ResolvedJ9JITServerMethodInfo> methodInfos;
+         getMultipleResolvedMethods(comp, fe, std::get<0>(recv), std::get<1>(recv), std::get<2>(recv), ramMethods, vTableOffsets, methodInfos);
          client->write(response, ramMethods, vTableOffsets, methodInfos);
          }
          break;
+      case MessageType::ResolvedMethod_getResolutionBatch:
+         {
+         auto recv = client->getRecvData<TR_ResolvedJ9Method *,
+                                         std::vector<TR_ResolvedMethodType>, std::vector<int32_t>,
+                                         std::vector<int32_t>, std::vector<uint8_t>,
+                                         std::vector<int32_t>, std::vector<uint8_t>, std::vector<uint8_t>,
+                                         std::vector<int32_t>>();
+         TR_ResolvedJ9Method *owningMethod = std::get<0>(recv);
+
+         std::vector<TR_OpaqueMethodBlock *> ramMethods;
+         std::vector<uint32_t> vTableOffsets;
+         std::vector<TR_ResolvedJ9JITServerMethodInfo> methodInfos;
+         getMultipleResolvedMethods(comp, fe, owningMethod, std::get<1>(recv), std::get<2>(recv), ramMethods, vTableOffsets, methodInfos);
+
+         std::vector<J9Class *> declaringClasses;
+         std::vector<UDATA> fields;
+         getFields(fe, owningMethod, std::get<3>(recv), std::get<4>(recv), declaringClasses, fields);
+
+         auto &attributesCPIndices = std::get<5>(recv);
+         auto &attributesIsStatic = std::get<6>(recv);
+         auto &attributesIsStore = std::get<7>(recv);
+         std::vector<TR_J9MethodFieldAttributes> attributes;
+         attributes.reserve(attributesCPIndices.size());
+         for (size_t i = 0; i < attributesCPIndices.size(); ++i)
+            attributes.push_back(getFieldAttributes(comp, owningMethod, attributesCPIndices[i], attributesIsStatic[i], attributesIsStore[i], false));
+
+         auto &classCPIndices = std::get<8>(recv);
+         std::vector<TR_OpaqueClassBlock *> classes;
+         classes.reserve(classCPIndices.size());
+         for (size_t i = 0; i < classCPIndices.size(); ++i)
+            classes.push_back(owningMethod->getClassFromConstantPool(comp, classCPIndices[i], false));
+
+         client->write(response, ramMethods, vTableOffsets, methodInfos, declaringClasses, fields, attributes, classes);
+         }
+         break;
       case MessageType::ResolvedMethod_getConstantDynamicTypeFromCP:
          {
          auto recv = client->getRecvData<TR_ResolvedJ9Method *, int32_t>();
@@ -3027,10 +3064,11 @@ remoteCompilationEnd(J9VMThread *vmThread, TR::Compilation *comp, TR_ResolvedMet
 
       // If we're not using the AOT cache, we still store by default. This avoids certain test failures in the short term.
       // Also, if we've explicitly been requested by the user to delay method relocations then we need to store methods
-      // in the SCC to support that option.
+      // in the SCC to support that option. JitDump recompilations are never stored.
       auto persistentInfo = compInfo->getPersistentInfo();
-      if ((persistentInfo->getJITServerAOTCacheDelayMethodRelocation() && !persistentInfo->getJITServerAOTCacheIgnoreLocalSCC()) ||
-          !compInfo->getPersistentInfo()->getJITServerUseAOTCache())
+      if (!entry->getMethodDetails().isJitDumpMethod() &&
+          ((persistentInfo->getJITServerAOTCacheDelayMethodRelocation() && !persistentInfo->getJITServerAOTCacheIgnoreLocalSCC()) ||
+           !compInfo->getPersistentInfo()->getJITServerUseAOTCache()))
          {
          J9ROMMethod *romMethod = comp->fej9()->getROMMethodFromRAMMethod(method);
          TR::CompilationInfo::storeAOTInSharedCache(
@@ -3108,9 +3146,18 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
    J9Class *clazz = J9_CLASS_FROM_METHOD(method);
    J9ROMClass *romClass = clazz->romClass;
    J9ROMMethod *romMethod = J9_ROM_METHOD_FROM_RAM_METHOD(method);
-   std::string detailsStr((const char *)&details, sizeof(details));
    TR::CompilationInfo *compInfo = compInfoPT->getCompilationInfo();
    TR_MethodToBeCompiled *entry = compInfoPT->getMethodBeingCompiled();
+
+   // Traced JIT debug agent recompilations are logged by the server, which sends the log back to be appended to the
+   // in-memory log of the debug agent. Their body is installed like that of any other compilation, so they are not
+   // sent as JitDump recompilations, for which the server skips the updates carried by the request.
+   TR::FILE *debugAgentLog = TR::CompilationInfoPerThreadBase::isDebugAgentTracedRecompilation(entry)
+      ? entry->_optimizationPlan->getLogCompilation()
+      : NULL;
+   TR::IlGeneratorMethodDetails debugAgentDetails(method);
+   TR::IlGeneratorMethodDetails &requestDetails = debugAgentLog ? debugAgentDetails : details;
+   std::string detailsStr((const char *)&requestDetails, sizeof(requestDetails));
    TR::PersistentInfo *persistentInfo = compInfo->getPersistentInfo();
    bool useAotCompilation = entry->_useAotCompilation;
 
@@ -3133,6 +3180,13 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
       aotCacheLoad = aotCacheStore && !entry->_doNotLoadFromJITServerAOTCache &&
                      compInfo->methodCanBeJITServerAOTCacheLoaded(compiler->signature(), compilee->convertToMethod()->methodType());
       }
+   // JitDump recompilations must be compiled with their own options rather than loaded from or stored into the
+   // JITServer AOT cache
+   if (details.isJitDumpMethod())
+      {
+      aotCacheStore = false;
+      aotCacheLoad = false;
+      }
    auto deserializer = compInfo->getJITServerAOTDeserializer();
    if (!aotCacheLoad && deserializer)
       deserializer->incNumCacheBypasses();
@@ -3273,10 +3327,10 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
    std::pair<std::string, std::string> chtableUpdates = chTable->serializeUpdates();
    // Update the sequence number for these updates
    uint32_t seqNo = compInfo->incCompReqSeqNo();
-   uint32_t lastCriticalSeqNo = !details.isJitDumpMethod() ? compInfo->getLastCriticalSeqNo() : 0;
+   uint32_t lastCriticalSeqNo = !requestDetails.isJitDumpMethod() ? compInfo->getLastCriticalSeqNo() : 0;
    // If needed, update the seqNo of the last request that carried information that needed to be processed in order
    if (!chtableUpdates.first.empty() || !chtableUpdates.second.empty() ||
-       !illegalModificationList.empty() || !unloadedClasses.empty() || details.isJitDumpMethod())
+       !illegalModificationList.empty() || !unloadedClasses.empty() || requestDetails.isJitDumpMethod())
       {
       compInfo->setLastCriticalSeqNo(seqNo);
       }
@@ -3292,6 +3346,9 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
    TR_OptimizationPlan modifiedOptPlan;
    std::vector<SerializedRuntimeAssumption> serializedRuntimeAssumptions;
    std::vector<TR_OpaqueMethodBlock *> methodsRequiringTrampolines;
+   uint64_t requestSentTimeUs = 0;
+   uint64_t roundTripTimeUs = 0;
+   uint64_t serverProcessingTimeUs = 0;
    uint32_t methodIndex = (uint32_t)(method - clazz->ramMethods);// Index in the array of methods of the defining class
    try
       {
@@ -3308,16 +3365,24 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
 
       Trc_JITServerRemoteCompileRequest(vmThread, seqNo, compiler->signature(), compiler->getHotnessName());
 
+      // The in-memory log of the debug agent only exists on the client, the server opens its own
+      if (debugAgentLog)
+         entry->_optimizationPlan->setLogCompilation(NULL);
+      PORT_ACCESS_FROM_JITCONFIG(compInfoPT->getJitConfig());
+      requestSentTimeUs = j9time_usec_clock();
       client->buildCompileRequest(
          persistentInfo->getClientUID(), seqNo, lastCriticalSeqNo, method, clazz, *entry->_optimizationPlan,
-         detailsStr, details.getType(), unloadedClasses, illegalModificationList, classInfoTuple, optionsStr,
+         detailsStr, requestDetails.getType(), unloadedClasses, illegalModificationList, classInfoTuple, optionsStr,
          recompMethodInfoStr, chtableUpdates.first, chtableUpdates.second, useAotCompilation,
          TR::Compiler->vm.isVMInStartupPhase(compInfoPT->getJitConfig()), aotCacheStore, aotCacheLoad, methodIndex,
          classChainOffset, ramClassChain, uncachedRAMClasses, uncachedClassInfos, newKnownIds
       );
+      if (debugAgentLog)
+         entry->_optimizationPlan->setLogCompilation(debugAgentLog);
 
       JITServer::MessageType response;
       while (!handleServerMessage(client, compiler->fej9vm(), response));
+      roundTripTimeUs = j9time_usec_clock() - requestSentTimeUs;
 
       // Re-acquire VM access
       // handleServerMessage will always acquire VM access after read() and release VM access at the end
@@ -3329,7 +3394,8 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
          auto recv = client->getRecvData<
             std::string, std::string, CHTableCommitData, std::vector<TR_OpaqueClassBlock*>, std::string,
             std::vector<TR_ResolvedJ9Method*>, TR_OptimizationPlan, std::vector<SerializedRuntimeAssumption>,
-            JITServer::ServerMemoryState, JITServer::ServerActiveThreadsState, std::vector<TR_OpaqueMethodBlock *>
+            JITServer::ServerMemoryState, JITServer::ServerActiveThreadsState, std::vector<TR_OpaqueMethodBlock *>,
+            uint64_t
          >();
          statusCode = compilationOK;
          codeCacheStr = std::get<0>(recv);
@@ -3343,6 +3409,7 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
          JITServer::ServerMemoryState nextMemoryState = std::get<8>(recv);
          JITServer::ServerActiveThreadsState nextActiveThreadState = std::get<9>(recv);
          methodsRequiringTrampolines = std::get<10>(recv);
+         serverProcessingTimeUs = std::get<11>(recv);
 
          updateCompThreadActivationPolicy(compInfoPT, nextMemoryState, nextActiveThreadState);
 
@@ -3354,7 +3421,8 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
          auto recv = client->getRecvData<
             std::string, std::vector<std::string>, CHTableCommitData, std::vector<TR_OpaqueClassBlock*>, std::string,
             std::vector<TR_ResolvedJ9Method*>, TR_OptimizationPlan, std::vector<SerializedRuntimeAssumption>,
-            JITServer::ServerMemoryState, JITServer::ServerActiveThreadsState, std::vector<TR_OpaqueMethodBlock *>
+            JITServer::ServerMemoryState, JITServer::ServerActiveThreadsState, std::vector<TR_OpaqueMethodBlock *>,
+            uint64_t
          >();
          auto &methodStr = std::get<0>(recv);
          auto &records = std::get<1>(recv);
@@ -3367,6 +3435,7 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
          JITServer::ServerMemoryState nextMemoryState = std::get<8>(recv);
          JITServer::ServerActiveThreadsState nextActiveThreadState = std::get<9>(recv);
          methodsRequiringTrampolines = std::get<10>(recv);
+         serverProcessingTimeUs = std::get<11>(recv);
 
          updateCompThreadActivationPolicy(compInfoPT, nextMemoryState, nextActiveThreadState);
 
@@ -3398,12 +3467,13 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
       else if (JITServer::MessageType::AOTCache_serializedAOTMethod == response)
          {
          auto recv = client->getRecvData<std::string, std::vector<std::string>, TR_OptimizationPlan,
-                                         JITServer::ServerMemoryState, JITServer::ServerActiveThreadsState>();
+                                         JITServer::ServerMemoryState, JITServer::ServerActiveThreadsState, uint64_t>();
          auto &methodStr = std::get<0>(recv);
          auto &records = std::get<1>(recv);
          modifiedOptPlan = std::get<2>(recv);
          JITServer::ServerMemoryState nextMemoryState = std::get<3>(recv);
          JITServer::ServerActiveThreadsState nextActiveThreadState = std::get<4>(recv);
+         serverProcessingTimeUs = std::get<5>(recv);
 
          updateCompThreadActivationPolicy(compInfoPT, nextMemoryState, nextActiveThreadState);
 
@@ -3631,11 +3701,14 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
       throw; // rethrow the exception
       }
 
+   if (debugAgentLog && !logFileStr.empty())
+      debugAgentLog->write(compInfoPT->getJitConfig()->javaVM->portLibrary, const_cast<char *>(logFileStr.data()), static_cast<int32_t>(logFileStr.size()));
+
    TR_MethodMetaData *metaData = NULL;
    // If a JitDump recompilation succeeded,
    // return before performing relocations and adding runtime assumptions,
    // since the compilation will be failed anyway.
-   if (details.isJitDumpMethod())
+   if (requestDetails.isJitDumpMethod())
       return NULL;
 
    if (statusCode == compilationOK || statusCode == compilationNotNeeded)
@@ -3656,12 +3729,25 @@ remoteCompile(J9VMThread *vmThread, TR::Compilation *compiler, TR_ResolvedMethod
          TR_ASSERT(codeCacheStr.size(), "must have code cache");
          TR_ASSERT(dataCacheStr.size(), "must have data cache");
 
+         TR_Hotness requestedOptLevel = entry->_optimizationPlan->getOptLevel();
          entry->_optimizationPlan->clone(&modifiedOptPlan);
 
          // Relocate the received compiled code
          metaData = remoteCompilationEnd(vmThread, compiler, compilee, method, compInfoPT, codeCacheStr, dataCacheStr);
          if (metaData)
             {
+            // AOT compilations are always remote, so only JIT compilations are sampled for routing
+            if (persistentInfo->getJITServerLatencyAwareRouting() && !useAotCompilation)
+               {
+               // The request waited for the part of the round trip that the server did not spend processing it.
+               // The two durations are measured with different clocks, which can only disagree by their granularity.
+               uint64_t serverWaitTimeUs = roundTripTimeUs - std::min(serverProcessingTimeUs, roundTripTimeUs);
+               PORT_ACCESS_FROM_JITCONFIG(compInfoPT->getJitConfig());
+               compInfo->getJITServerLatencyEstimator().recordRemoteCompilation(
+                  requestedOptLevel, TR::CompilationInfo::getMethodBytecodeSize(method),
+                  j9time_usec_clock() - compInfoPT->getTimeWhenCompStarted(), serverWaitTimeUs);
+               }
+
             // Must add the runtime assumptions received from the server to the RAT and
             // update the list in the comp object with persistent entries. A pointer to
             // this list will be copied into the metadata
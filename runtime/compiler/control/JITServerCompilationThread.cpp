@@ -229,7 +229,8 @@ outOfProcessCompilationEnd(TR_MethodToBeCompiled *entry, TR::Compilation *comp)
          resolvedMirrorMethodsPersistIPInfo
             ? std::vector<TR_ResolvedJ9Method*>(resolvedMirrorMethodsPersistIPInfo->begin(), resolvedMirrorMethodsPersistIPInfo->end())
             : std::vector<TR_ResolvedJ9Method*>(),
-         *entry->_optimizationPlan, serializedRuntimeAssumptions, memoryState, activeThreadState, methodsRequiringTrampolines
+         *entry->_optimizationPlan, serializedRuntimeAssumptions, memoryState, activeThreadState, methodsRequiringTrampolines,
+         compInfoPT->getRequestProcessingTimeUs()
       );
       if (TR::Options::getVerboseOption(TR_VerboseJITServer))
          {
@@ -251,7 +252,8 @@ outOfProcessCompilationEnd(TR_MethodToBeCompiled *entry, TR::Compilation *comp)
          resolvedMirrorMethodsPersistIPInfo
             ? std::vector<TR_ResolvedJ9Method*>(resolvedMirrorMethodsPersistIPInfo->begin(), resolvedMirrorMethodsPersistIPInfo->end())
             : std::vector<TR_ResolvedJ9Method*>(),
-         *entry->_optimizationPlan, serializedRuntimeAssumptions, memoryState, activeThreadState, methodsRequiringTrampolines
+         *entry->_optimizationPlan, serializedRuntimeAssumptions, memoryState, activeThreadState, methodsRequiringTrampolines,
+         compInfoPT->getRequestProcessingTimeUs()
       );
       if (TR::Options::getVerboseOption(TR_VerboseJITServer))
          {
@@ -289,9 +291,17 @@ TR::CompilationInfoPerThreadRemote::CompilationInfoPerThreadRemote(TR::Compilati
    _classUnloadReadMutexDepth(0),
    _aotCacheStore(false),
    _methodIndex((uint32_t)-1),
-   _definingClassChainRecord(NULL)
+   _definingClassChainRecord(NULL),
+   _requestReadTimeUs(0)
    {}
 
+uint64_t
+TR::CompilationInfoPerThreadRemote::getRequestProcessingTimeUs() const
+   {
+   PORT_ACCESS_FROM_JITCONFIG(_jitConfig);
+   return j9time_usec_clock() - _requestReadTimeUs;
+   }
+
 /**
  * @brief Method executed by JITServer to dequeue and notify all waiting threads
  *        that the condition they were waiting for has been fulfilled.
@@ -538,7 +548,7 @@ TR::CompilationInfoPerThreadRemote::serveCachedAOTMethod(TR_MethodToBeCompiled &
    entry._stream->write(JITServer::MessageType::AOTCache_serializedAOTMethod,
                         std::string((const char *)&serializedMethod->data(), serializedMethod->data().size()),
                         serializedRecords, *optPlan, computeServerMemoryState(getCompilationInfo()),
-                        computeServerActiveThreadsState(getCompilationInfo()));
+                        computeServerActiveThreadsState(getCompilationInfo()), getRequestProcessingTimeUs());
    return true;
    }
 
@@ -569,7 +579,7 @@ TR::CompilationInfoPerThreadRemote::processEntry(TR_MethodToBeCompiled &entry, J
       auto aotCacheMap = compInfo->getJITServerAOTCacheMap();
       TR_ASSERT(aotCacheMap, "aotCacheMap must exist if such a special request was issued");
       if (stream == LOAD_AOTCACHE_REQUEST)
-         aotCacheMap->loadNextQueuedAOTCacheFromFile(scratchSegmentProvider);
+         aotCacheMap->loadNextQueuedAOTCacheFromFile();
       else
          aotCacheMap->saveNextQueuedAOTCacheToFile();
 
@@ -588,6 +598,12 @@ TR::CompilationInfoPerThreadRemote::processEntry(TR_MethodToBeCompiled &entry, J
 
    _recompilationMethodInfo = NULL;
 
+   // Compilation time charged to the client by the fair scheduler; the entry is recycled before the charge is settled
+   uint64_t schedulingChargeUs = entry._schedulingChargeUs;
+   uint64_t schedulingClientUID = entry.getClientUID();
+   // Time at which the fair scheduler found the request pending on the connection; 0 if it did not look
+   uint64_t requestPendingTimeUs = entry._requestPendingTimeUs;
+
    // Release compMonitor before doing the blocking read
    compInfo->releaseCompMonitor(compThread);
 
@@ -651,6 +667,12 @@ TR::CompilationInfoPerThreadRemote::processEntry(TR_MethodToBeCompiled &entry, J
       auto &uncachedClassInfos      = std::get<23>(req);
       auto &newKnownIds             = std::get<24>(req);
 
+      // The client subtracts the time spent processing the request from its round trip time to find out
+      // how long the request waited. Persistent connections are queued again before the client sends
+      // its next request, so the time spent in the compilation queue would include idle time.
+      PORT_ACCESS_FROM_JITCONFIG(_jitConfig);
+      _requestReadTimeUs = j9time_usec_clock();
+
       TR_ASSERT_FATAL(TR::Compiler->persistentMemory() == compInfo->persistentMemory(),
                       "per-client persistent memory must not be set at this point");
 
@@ -710,6 +732,9 @@ TR::CompilationInfoPerThreadRemote::processEntry(TR_MethodToBeCompiled &entry, J
                    "per-client persistent memory must be set at this point");
 
          clientSession->setIsInStartupPhase(isInStartupPhase);
+         // The wait of a request is unknown if the scheduler did not find it on its connection before the read
+         if (requestPendingTimeUs)
+            clientSession->recordQueueWaitTime(_requestReadTimeUs - requestPendingTimeUs);
          } // End critical section
 
      if (TR::Options::getVerboseOption(TR_VerboseJITServer))
@@ -1165,6 +1190,14 @@ TR::CompilationInfoPerThreadRemote::processEntry(TR_MethodToBeCompiled &entry, J
          compInfo->recycleCompilationEntry(&entry);
          }
 
+      // An aborted request says little about the cost of the requests of this client; just return the charge.
+      // The stream may have failed before the client session was looked up.
+      ClientSessionData *chargedClientData = getClientData();
+      if (!chargedClientData && schedulingChargeUs && schedulingClientUID)
+         chargedClientData = compInfo->getClientSessionHT()->peekClientSession(schedulingClientUID);
+      if (chargedClientData)
+         chargedClientData->setSchedulingDeficit(chargedClientData->getSchedulingDeficit() + (int64_t)schedulingChargeUs);
+
       // Reset the pointer to the cached client session data
       if (getClientData())
          {
@@ -1270,6 +1303,7 @@ TR::CompilationInfoPerThreadRemote::processEntry(TR_MethodToBeCompiled &entry, J
    getClientData()->getSequencingMonitor()->enter();
    getClientData()->decNumActiveThreads();
    getClientData()->getSequencingMonitor()->exit();
+   getClientData()->settleSchedulingCharge(schedulingChargeUs, getRequestProcessingTimeUs());
    getClientData()->decInUse();  // We have the compMonitor so it's safe to access the inUse counter
    if (getClientData()->getInUse() == 0)
       {
@@ -111,6 +111,8 @@ public:
 
    bool isAOTCacheStore() const { return _aotCacheStore; }
    uint32_t getMethodIndex() const { return _methodIndex; }
+   // Time elapsed since the current request was read, reported to the client with the result
+   uint64_t getRequestProcessingTimeUs() const;
    const AOTCacheClassChainRecord *getDefiningClassChainRecord() { return _definingClassChainRecord; }
 
 private:
@@ -190,6 +192,7 @@ private:
    bool _aotCacheStore; // True if the result of this compilation will be stored in AOT cache
    uint32_t _methodIndex; // Index of the method being compiled in the array of methods of its defining class
    const AOTCacheClassChainRecord *_definingClassChainRecord; // Used to store the result of the compilation in AOT cache
+   uint64_t _requestReadTimeUs; // Time at which the current request was read from the client
 
    static int32_t _numClearedCaches; // number of instances JITServer was forced to clear its internal per-client caches
 
@@ -32,6 +32,7 @@
 #include "net/CommunicationStream.hpp"
 #include "OMR/Bytes.hpp"// for OMR::alignNoCheck()
 #include "runtime/JITServerAOTDeserializer.hpp"
+#include "runtime/JITServerSharedProfileCache.hpp"
 #include "runtime/JITServerSharedROMClassCache.hpp"
 #include "romclasswalk.h"
 #include "util_api.h"// for allSlotsInROMClassDo()
@@ -826,6 +827,20 @@ JITServerHelpers::printJITServerMsgStats(J9JITConfig *jitConfig, TR::Compilation
    j9tty_printf(PORTLIB, "Total number of messages: %llu\n", (unsigned long long)totalMsgCount);
    j9tty_printf(PORTLIB, "Total amount of data received: %llu bytes\n",
                 (unsigned long long)JITServer::CommunicationStream::_totalMsgSize);
+   if (JITServer::CommunicationStream::_numCompressedMsgsReceived)
+      j9tty_printf(PORTLIB, "Compressed messages received: %u, %llu bytes compressed from %llu bytes (ratio %f)\n",
+                   JITServer::CommunicationStream::_numCompressedMsgsReceived,
+                   (unsigned long long)JITServer::CommunicationStream::_totalCompressedMsgSizeReceived,
+                   (unsigned long long)JITServer::CommunicationStream::_totalUncompressedMsgSizeReceived,
+                   JITServer::CommunicationStream::_totalUncompressedMsgSizeReceived /
+                      (double)JITServer::CommunicationStream::_totalCompressedMsgSizeReceived);
+   if (JITServer::CommunicationStream::_numCompressedMsgsSent)
+      j9tty_printf(PORTLIB, "Compressed messages sent: %u, %llu bytes compressed from %llu bytes (ratio %f)\n",
+                   JITServer::CommunicationStream::_numCompressedMsgsSent,
+                   (unsigned long long)JITServer::CommunicationStream::_totalCompressedMsgSizeSent,
+                   (unsigned long long)JITServer::CommunicationStream::_totalUncompressedMsgSizeSent,
+                   JITServer::CommunicationStream::_totalUncompressedMsgSizeSent /
+                      (double)JITServer::CommunicationStream::_totalCompressedMsgSizeSent);
 
    uint32_t numCompilations = 0;
    uint32_t numDeserializedMethods = 0;
@@ -972,6 +987,18 @@ JITServerHelpers::cacheRemoteROMClass(ClientSessionData *clientSessionData, J9Cl
 
    auto result = clientSessionData->getROMClassMap().insert({ clazz, classInfoStruct });
 
+   if (TR::CompilationInfo::get()->getJITServerSharedProfileCache())
+      {
+      auto hash = JITServerSharedProfileCache::getClassHash(romClass, classInfoStruct._numDimensions);
+      if (hash)
+         {
+         auto hashResult = clientSessionData->getClassByROMClassHashMap().insert({ *hash, clazz });
+         // Profiled classes cannot be translated unambiguously if the client has several classes with this ROMClass
+         if (!hashResult.second && (hashResult.first->second != clazz))
+            hashResult.first->second = NULL;
+         }
+      }
+
    auto &methodMap = clientSessionData->getJ9MethodMap();
    uint32_t numMethods = romClass->romMethodCount;
    J9ROMMethod *romMethod = J9ROMCLASS_ROMMETHODS(romClass);
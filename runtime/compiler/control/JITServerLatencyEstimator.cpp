@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * Copyright IBM Corp. and others 2026
+ *
+ * This program and the accompanying materials are made available under
+ * the terms of the Eclipse Public License 2.0 which accompanies this
+ * distribution and is available at https://www.eclipse.org/legal/epl-2.0/
+ * or the Apache License, Version 2.0 which accompanies this distribution and
+ * is available at https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This Source Code may also be made available under the following
+ * Secondary Licenses when the conditions for such availability set
+ * forth in the Eclipse Public License, v. 2.0 are satisfied: GNU
+ * General Public License, version 2 with the GNU Classpath
+ * Exception [1] and GNU General Public License, version 2 with the
+ * OpenJDK Assembly Exception [2].
+ *
+ * [1] https://www.gnu.org/software/classpath/license.html
+ * [2] https://openjdk.org/legal/assembly-exception.html
+ *
+ * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
+ *******************************************************************************/
+
+#include "control/JITServerLatencyEstimator.hpp"
+
+#include <limits.h>
+#include <string.h>
+#include "compile/Compilation.hpp"
+#include "control/Options.hpp"
+#include "control/Options_inlines.hpp"
+
+
+JITServerLatencyEstimator::JITServerLatencyEstimator() :
+   _numLocalDecisions(0),
+   _numProbes(0)
+   {
+   memset(_localCompTime, 0, sizeof(_localCompTime));
+   memset(_remoteCompTime, 0, sizeof(_remoteCompTime));
+   memset(_serverWaitTime, 0, sizeof(_serverWaitTime));
+   memset(_numDecisions, 0, sizeof(_numDecisions));
+   }
+
+void
+JITServerLatencyEstimator::Estimate::addSample(uint64_t timeUs)
+   {
+   // Read the fields once; other compilation threads may be updating them concurrently
+   uint64_t avgTimeUs = _avgTimeUs;
+   uint32_t numSamples = _numSamples;
+   if (numSamples < (1 << SAMPLE_WEIGHT_SHIFT))
+      {
+      // Plain average until there are enough samples for the weighted one to be meaningful
+      avgTimeUs = (avgTimeUs * numSamples + timeUs) / (numSamples + 1);
+      }
+   else
+      {
+      avgTimeUs = avgTimeUs - (avgTimeUs >> SAMPLE_WEIGHT_SHIFT) + (timeUs >> SAMPLE_WEIGHT_SHIFT);
+      }
+   _avgTimeUs = avgTimeUs;
+   if (numSamples < UINT_MAX)
+      _numSamples = numSamples + 1;
+   }
+
+JITServerLatencyEstimator::SizeClass
+JITServerLatencyEstimator::getSizeClass(uint32_t bytecodeSize)
+   {
+   if (bytecodeSize < SMALL_METHOD_BYTECODE_SIZE)
+      return SMALL_METHOD;
+   if (bytecodeSize < LARGE_METHOD_BYTECODE_SIZE)
+      return MEDIUM_METHOD;
+   return LARGE_METHOD;
+   }
+
+void
+JITServerLatencyEstimator::recordLocalCompilation(TR_Hotness optLevel, uint32_t bytecodeSize, uint64_t compTimeUs)
+   {
+   if (isTracked(optLevel))
+      _localCompTime[optLevel][getSizeClass(bytecodeSize)].addSample(compTimeUs);
+   }
+
+void
+JITServerLatencyEstimator::recordRemoteCompilation(TR_Hotness optLevel, uint32_t bytecodeSize,
+                                                   uint64_t compTimeUs, uint64_t serverWaitTimeUs)
+   {
+   if (!isTracked(optLevel))
+      return;
+   // The client measures the wait as part of the round trip, within the compilation time
+   _remoteCompTime[optLevel][getSizeClass(bytecodeSize)].addSample(compTimeUs - serverWaitTimeUs);
+   _serverWaitTime[optLevel].addSample(serverWaitTimeUs);
+   }
+
+bool
+JITServerLatencyEstimator::preferLocalCompilation(TR_Hotness optLevel, uint32_t bytecodeSize)
+   {
+   if (!isTracked(optLevel))
+      return false;
+
+   SizeClass sizeClass = getSizeClass(bytecodeSize);
+   const Estimate &local = _localCompTime[optLevel][sizeClass];
+   const Estimate &remote = _remoteCompTime[optLevel][sizeClass];
+   const Estimate &wait = _serverWaitTime[optLevel];
+
+   uint32_t probeInterval = (uint32_t)TR::Options::_jitserverLatencyRoutingProbeInterval;
+   uint32_t numDecisions = ++_numDecisions[optLevel][sizeClass];
+   bool probe = (probeInterval > 0) && (0 == numDecisions % probeInterval);
+
+   // Compilations are remote by default, so the remote estimates are built first. Samples
+   // for the local side come from the compilations kept local for other reasons and from probes.
+   if (!remote.isValid())
+      return false;
+   if (!local.isValid())
+      {
+      if (probe)
+         _numProbes++;
+      return probe;
+      }
+
+   // Local compilations compete with the application for the CPU of the client,
+   // which is accounted for by inflating their cost
+   uint64_t expectedLocalTimeUs = local._avgTimeUs * TR::Options::_jitserverLatencyRoutingLocalCostPercent / 100;
+   uint64_t expectedRemoteTimeUs = remote._avgTimeUs + wait._avgTimeUs;
+   bool preferLocal = expectedLocalTimeUs < expectedRemoteTimeUs;
+   if (probe)
+      {
+      _numProbes++;
+      return !preferLocal;
+      }
+   if (preferLocal)
+      _numLocalDecisions++;
+   return preferLocal;
+   }
+
+void
+JITServerLatencyEstimator::printStats(FILE *f) const
+   {
+   fprintf(f,
+      "JITServer latency-aware routing statistics:\n"
+      "\tcompilations kept local: %u\n"
+      "\tprobes: %u\n",
+      _numLocalDecisions,
+      _numProbes
+   );
+   for (int32_t optLevel = 0; optLevel < (int32_t)numHotnessLevels; ++optLevel)
+      {
+      if (!_serverWaitTime[optLevel]._numSamples)
+         {
+         bool hasLocalSamples = false;
+         for (int32_t sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; ++sizeClass)
+            hasLocalSamples = hasLocalSamples || _localCompTime[optLevel][sizeClass]._numSamples;
+         if (!hasLocalSamples)
+            continue;
+         }
+      fprintf(f, "\t%s: serverWait=%lluus(%u)", TR::Compilation::getHotnessName((TR_Hotness)optLevel),
+              (unsigned long long)_serverWaitTime[optLevel]._avgTimeUs, _serverWaitTime[optLevel]._numSamples);
+      for (int32_t sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; ++sizeClass)
+         {
+         const Estimate &local = _localCompTime[optLevel][sizeClass];
+         const Estimate &remote = _remoteCompTime[optLevel][sizeClass];
+         fprintf(f, " [size%d local=%lluus(%u) remote=%lluus(%u)]", sizeClass,
+                 (unsigned long long)local._avgTimeUs, local._numSamples,
+                 (unsigned long long)remote._avgTimeUs, remote._numSamples);
+         }
+      fprintf(f, "\n");
+      }
+   }
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * Copyright IBM Corp. and others 2026
+ *
+ * This program and the accompanying materials are made available under
+ * the terms of the Eclipse Public License 2.0 which accompanies this
+ * distribution and is available at https://www.eclipse.org/legal/epl-2.0/
+ * or the Apache License, Version 2.0 which accompanies this distribution and
+ * is available at https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This Source Code may also be made available under the following
+ * Secondary Licenses when the conditions for such availability set
+ * forth in the Eclipse Public License, v. 2.0 are satisfied: GNU
+ * General Public License, version 2 with the GNU Classpath
+ * Exception [1] and GNU General Public License, version 2 with the
+ * OpenJDK Assembly Exception [2].
+ *
+ * [1] https://www.gnu.org/software/classpath/license.html
+ * [2] https://openjdk.org/legal/assembly-exception.html
+ *
+ * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
+ *******************************************************************************/
+
+#ifndef JITSERVER_LATENCY_ESTIMATOR_H
+#define JITSERVER_LATENCY_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "compile/CompilationTypes.hpp"
+
+
+// Used at the JITServer client to decide whether a compilation will be installed sooner
+// if it is performed locally or if it is sent to the server.
+//
+// For every opt level and method size class the client keeps exponentially weighted
+// averages of the time it takes to compile locally and of the time it takes to get the
+// answer of the server, not counting the time the request waits before the server starts
+// processing it. The server reports how long it processed each request, and the client
+// attributes the rest of the round trip to waiting, mostly in the queue of the server.
+// The wait time is averaged per opt level only, since it does not depend on the method
+// being compiled. The expected time-to-install of a remote compilation is the sum of the
+// two remote averages.
+//
+// The averages are updated by all compilation threads without synchronization;
+// losing an occasional sample is acceptable for a heuristic.
+class JITServerLatencyEstimator
+   {
+public:
+   enum SizeClass
+      {
+      SMALL_METHOD,  // bytecode size below SMALL_METHOD_BYTECODE_SIZE
+      MEDIUM_METHOD, // bytecode size below LARGE_METHOD_BYTECODE_SIZE
+      LARGE_METHOD,
+      NUM_SIZE_CLASSES
+      };
+
+   JITServerLatencyEstimator();
+
+   // Record the time it took to compile and install a method locally
+   void recordLocalCompilation(TR_Hotness optLevel, uint32_t bytecodeSize, uint64_t compTimeUs);
+   // Record the time it took to compile and install a method remotely, and the part of that
+   // time the request waited before the server started processing it
+   void recordRemoteCompilation(TR_Hotness optLevel, uint32_t bytecodeSize, uint64_t compTimeUs, uint64_t serverWaitTimeUs);
+
+   // Returns true if a compilation with the given opt level and bytecode size is expected
+   // to be installed sooner if performed locally. Returns false if there are not enough
+   // samples for either side. Once in a while the side that looks slower is chosen anyway,
+   // so that its estimate does not become stale.
+   bool preferLocalCompilation(TR_Hotness optLevel, uint32_t bytecodeSize);
+
+   void printStats(FILE *f) const;
+
+private:
+   struct Estimate
+      {
+      uint64_t _avgTimeUs;
+      uint32_t _numSamples;
+
+      void addSample(uint64_t timeUs);
+      bool isValid() const { return _numSamples >= MIN_SAMPLES; }
+      };
+
+   static const uint32_t SMALL_METHOD_BYTECODE_SIZE = 64;
+   static const uint32_t LARGE_METHOD_BYTECODE_SIZE = 1024;
+   // Number of samples needed before an estimate is used for routing
+   static const uint32_t MIN_SAMPLES = 4;
+   // Weight of a new sample is 1/2^SAMPLE_WEIGHT_SHIFT
+   static const uint32_t SAMPLE_WEIGHT_SHIFT = 3;
+
+   static SizeClass getSizeClass(uint32_t bytecodeSize);
+   static bool isTracked(TR_Hotness optLevel) { return (uint32_t)optLevel < (uint32_t)numHotnessLevels; }
+
+   Estimate _localCompTime[numHotnessLevels][NUM_SIZE_CLASSES];
+   Estimate _remoteCompTime[numHotnessLevels][NUM_SIZE_CLASSES]; // Excludes the time waiting for the server
+   Estimate _serverWaitTime[numHotnessLevels];
+   uint32_t _numDecisions[numHotnessLevels][NUM_SIZE_CLASSES];
+   uint32_t _numLocalDecisions; // Compilations kept local because they were expected to be installed sooner
+   uint32_t _numProbes; // Compilations sent to the side that looked slower to refresh its estimate
+   };
+
+#endif // JITSERVER_LATENCY_ESTIMATOR_H
@@ -29,6 +29,7 @@
 #if defined(J9VM_OPT_JITSERVER)
 #include "control/CompilationThread.hpp"
 #include "net/ServerStream.hpp"
+#include "runtime/JITServerAOTCache.hpp"
 #endif /* defined(J9VM_OPT_JITSERVER) */
 
 int16_t TR_MethodToBeCompiled::_globalIndex = 0;
@@ -98,6 +99,8 @@ void TR_MethodToBeCompiled::initialize(TR::IlGeneratorMethodDetails &details, vo
    _useAOTCacheCompilation = false;
    _origOptLevel = unknownHotness;
    _stream = NULL;
+   _schedulingChargeUs = 0;
+   _requestPendingTimeUs = 0;
 #endif /* defined(J9VM_OPT_JITSERVER) */
 
    TR_ASSERT_FATAL(_freeTag & ENTRY_IN_POOL_FREE, "initializing an entry which is not free");
@@ -151,6 +154,9 @@ TR_MethodToBeCompiled::setAotCodeToBeRelocated(const void *m)
 uint64_t
 TR_MethodToBeCompiled::getClientUID() const
    {
+   // Requests to load or save an AOT cache do not come from a client
+   if (_stream == LOAD_AOTCACHE_REQUEST || _stream == SAVE_AOTCACHE_REQUEST)
+      return 0;
    return _stream->getClientId();
    }
 #endif /* defined(J9VM_OPT_JITSERVER) */
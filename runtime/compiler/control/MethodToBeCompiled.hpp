@@ -84,7 +84,7 @@ struct TR_MethodToBeCompiled
    void setRemoteCompReq() { _remoteCompReq = true; }
    void unsetRemoteCompReq() { _remoteCompReq = false; }
    bool isOutOfProcessCompReq() const { return _stream != NULL; } // at the server
-   uint64_t getClientUID() const;
+   uint64_t getClientUID() const; // 0 until the first request on the connection is read
    bool hasChangedToLocalSyncComp() const { return _origOptLevel != unknownHotness; }
    void setShouldUpgradeOutOfProcessCompilation() { _shouldUpgradeOutOfProcessCompilation = true; }
    bool shouldUpgradeOutOfProcessCompilation() const { return _shouldUpgradeOutOfProcessCompilation; }
@@ -173,6 +173,10 @@ struct TR_MethodToBeCompiled
    TR_Hotness _origOptLevel;
    // A non-NULL field denotes an out-of-process compilation request
    JITServer::ServerStream *_stream;
+   // Compilation time charged to the client when the request was dequeued at the server
+   uint64_t _schedulingChargeUs;
+   // Time at which the client was found to have sent the request on this queued connection; 0 if not known yet
+   uint64_t _requestPendingTimeUs;
 #endif /* defined(J9VM_OPT_JITSERVER) */
    }; // TR_MethodToBeCompiled
 
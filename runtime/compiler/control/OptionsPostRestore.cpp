@@ -180,6 +180,12 @@ J9::OptionsPostRestore::iterateOverExternalOptions()
          case J9::ExternalOptions::XXplusHealthProbes:
          case J9::ExternalOptions::XXminusHealthProbes:
          case J9::ExternalOptions::XXJITServerHealthProbePortOption:
+         case J9::ExternalOptions::XXplusJITServerMessageCompression:
+         case J9::ExternalOptions::XXminusJITServerMessageCompression:
+         case J9::ExternalOptions::XXplusJITServerLatencyAwareRouting:
+         case J9::ExternalOptions::XXminusJITServerLatencyAwareRouting:
+         case J9::ExternalOptions::XXplusJITServerAggregateProfiles:
+         case J9::ExternalOptions::XXminusJITServerAggregateProfiles:
             {
             // do nothing, consume them to prevent errors
             FIND_AND_CONSUME_RESTORE_ARG(OPTIONAL_LIST_MATCH, optString, 0);
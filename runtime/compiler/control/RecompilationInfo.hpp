@@ -160,6 +160,9 @@ class TR_PersistentMethodInfo
    bool isExcludedPostRestore() { return _flags.testAny(IsExcludedPostRestore); }
    void setIsExcludedPostRestore(bool b = true) { _flags.set(IsExcludedPostRestore, b); }
 
+   bool isRevertedByDebugAgent() { return _flags.testAny(IsRevertedByDebugAgent); }
+   void setIsRevertedByDebugAgent(bool b = true) { _flags.set(IsRevertedByDebugAgent, b); }
+
    uint16_t getTimeStamp() { return _timeStamp; }
 
    TR_OptimizationPlan * getOptimizationPlan() {return _optimizationPlan;}
@@ -249,6 +252,10 @@ class TR_PersistentMethodInfo
                                                          // J9::Recompilation::methodCannotBeRecompiled to patch the startPC
                                                          // to call the interpreter
 
+      IsRevertedByDebugAgent               = 0x02000000, // The JIT debug agent is reverting this method to the interpreter, which
+                                                         // J9::Recompilation::methodCannotBeRecompiled does by patching the startPC
+                                                         // to call the interpreter
+
       lastFlag                             = 0x80000000
       };
 
@@ -367,6 +374,9 @@ class TR_PersistentJittedBodyInfo
    bool getUsesJProfiling() { return _flags.testAny(UsesJProfiling); }
    void setUsesJProfiling() { _flags.set(UsesJProfiling, true); }
 
+   bool getHasSwitchToInterpreterPrePrologue() { return _flags.testAny(HasSwitchToInterpreterPrePrologue); }
+   void setHasSwitchToInterpreterPrePrologue(bool b) { _flags.set(HasSwitchToInterpreterPrePrologue, b); }
+
    // used in dump recompilations
    void *getStartPCAfterPreviousCompile() { return _startPCAfterPreviousCompile; }
    void setStartPCAfterPreviousCompile(void *oldStartPC) { _startPCAfterPreviousCompile = oldStartPC; }
@@ -428,7 +438,8 @@ class TR_PersistentJittedBodyInfo
       UsesGCR                 = 0x0800,
       ReducedWarm             = 0x1000,  // Warm body was optimized to a lesser extent (NoServer) to reduce compilation time
       UsesSamplingJProfiling  = 0x2000,  // Body has samplingJProfiling code
-      UsesJProfiling          = 0x4000   // Body has jProfiling code
+      UsesJProfiling          = 0x4000,  // Body has jProfiling code
+      HasSwitchToInterpreterPrePrologue = 0x8000 // Body can be reverted to the interpreter by patching its JIT entry
       };
 
    // ### IMPORTANT ###
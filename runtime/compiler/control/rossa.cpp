@@ -121,6 +121,7 @@
 #include "runtime/JITServerAOTCache.hpp"
 #include "runtime/JITServerAOTDeserializer.hpp"
 #include "runtime/JITServerIProfiler.hpp"
+#include "runtime/JITServerSharedProfileCache.hpp"
 #include "runtime/JITServerSharedROMClassCache.hpp"
 #include "runtime/JITServerStatisticsThread.hpp"
 #include "runtime/Listener.hpp"
@@ -1845,6 +1846,24 @@ onLoadInternal(
          compInfo->setJITServerSharedROMClassCache(cache);
          }
 
+      //NOTE: This must be done only after the shared ROMClass cache has been created
+      if (TR::Options::_aggregateProfiles)
+         {
+         if (TR::Options::_shareROMClasses)
+            {
+            size_t maxMemory = (size_t)std::max(0, TR::Options::_sharedProfileCacheMaxMemoryKB) * 1024;
+            auto cache = new (PERSISTENT_NEW) JITServerSharedProfileCache(maxMemory);
+            if (!cache)
+               return -1;
+            compInfo->setJITServerSharedProfileCache(cache);
+            }
+         else if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+            {
+            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer,
+                                           "ERROR: ROMClass sharing is disabled, disabling aggregation of IProfiler data");
+            }
+         }
+
       //NOTE: This must be done only after the SSL library has been successfully loaded
       if (compInfo->getPersistentInfo()->getJITServerUseAOTCache())
          {
@@ -1889,7 +1908,12 @@ onLoadInternal(
    jitConfig->debugAgentStart = debugAgentStart;
    jitConfig->debugAgentGetAllJitMethods = debugAgentGetAllJitMethods;
    jitConfig->debugAgentRevertToInterpreter = debugAgentRevertToInterpreter;
+   jitConfig->debugAgentRestoreJitMethod = debugAgentRestoreJitMethod;
    jitConfig->debugAgentRecompile = debugAgentRecompile;
+   jitConfig->debugAgentIsAotBody = debugAgentIsAotBody;
+   jitConfig->debugAgentIsRevertible = debugAgentIsRevertible;
+   jitConfig->debugAgentGetPerformedOptimizations = debugAgentGetPerformedOptimizations;
+   jitConfig->debugAgentGetOptimizationName = debugAgentGetOptimizationName;
    jitConfig->debugAgentEnd = debugAgentEnd;
    jitConfig->debugAgentSetForceUsePreexistence = debugAgentSetForceUsePreexistence;
    
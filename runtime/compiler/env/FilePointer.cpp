@@ -58,6 +58,10 @@ FilePointer::initialize(::FILE *stream)
    {
    _stream  = stream;
    _useJ9IO = false;
+   _inMemory = false;
+   _buffer = NULL;
+   _bufferLength = 0;
+   _bufferCapacity = 0;
    }
 
 
@@ -67,6 +71,22 @@ FilePointer::initialize(J9PortLibrary *portLib, int32_t fileId)
    PORT_ACCESS_FROM_PORT(portLib);
    _fileId  = fileId;
    _useJ9IO = true;
+   _inMemory = false;
+   _buffer = NULL;
+   _bufferLength = 0;
+   _bufferCapacity = 0;
+   }
+
+
+void
+FilePointer::initializeInMemory()
+   {
+   _stream  = NULL;
+   _useJ9IO = false;
+   _inMemory = true;
+   _buffer = NULL;
+   _bufferLength = 0;
+   _bufferCapacity = 0;
    }
 
 
@@ -76,7 +96,31 @@ FilePointer::write(J9PortLibrary *portLib, char *buf, int32_t length)
    PORT_ACCESS_FROM_PORT(portLib);
    if (length > 0)
       {
-      if (_useJ9IO)
+      if (_inMemory)
+         {
+         if (_bufferLength + length > _bufferCapacity)
+            {
+            size_t capacity = _bufferCapacity > 0 ? _bufferCapacity * 2 : 64 * 1024;
+            while (capacity < _bufferLength + length)
+               capacity *= 2;
+
+            char *buffer = (char *)j9mem_allocate_memory(capacity, J9MEM_CATEGORY_JIT);
+            if (NULL == buffer)
+               return 0;
+
+            if (NULL != _buffer)
+               {
+               memcpy(buffer, _buffer, _bufferLength);
+               j9mem_free_memory(_buffer);
+               }
+            _buffer = buffer;
+            _bufferCapacity = capacity;
+            }
+
+         memcpy(_buffer + _bufferLength, buf, length);
+         _bufferLength += length;
+         }
+      else if (_useJ9IO)
          {
          return j9file_write(_fileId, buf, length);
          }
@@ -92,7 +136,14 @@ void
 FilePointer::close(J9PortLibrary *portLib)
    {
    PORT_ACCESS_FROM_PORT(portLib);
-   if (_useJ9IO)
+   if (_inMemory)
+      {
+      j9mem_free_memory(_buffer);
+      _buffer = NULL;
+      _bufferLength = 0;
+      _bufferCapacity = 0;
+      }
+   else if (_useJ9IO)
       {
       flush(portLib);
       j9file_sync(_fileId);
@@ -109,7 +160,7 @@ void
 FilePointer::flush(J9PortLibrary *portLib)
    {
    PORT_ACCESS_FROM_PORT(portLib);
-   if (!_useJ9IO)
+   if (!_useJ9IO && !_inMemory)
       fflush(_stream);
    }
 
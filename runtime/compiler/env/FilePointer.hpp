@@ -23,6 +23,7 @@
 #ifndef TR_FILEPOINTER_INCL
 #define TR_FILEPOINTER_INCL
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdint.h>
 #include "env/FilePointerDecl.hpp"
@@ -39,8 +40,18 @@ namespace TR
       void initialize(J9PortLibrary *portLib, int32_t fileId);
       void initialize(::FILE *stream);
 
+      /**
+       * \brief Initializes a file whose contents are kept in memory rather than written out, so they can be inspected
+       *        through getBuffer() before the file is closed.
+       */
+      void initializeInMemory();
+
       int32_t write(J9PortLibrary *portLib, char *buf, int32_t length);
 
+      bool isInMemory() const { return _inMemory; }
+      const char *getBuffer() const { return _buffer; }
+      size_t getBufferLength() const { return _bufferLength; }
+
       void close(J9PortLibrary *portLib);
 
       void flush(J9PortLibrary *portLib);
@@ -67,6 +78,11 @@ namespace TR
       uint8_t cipher(uint8_t c);
 
       bool _useJ9IO;
+      bool _inMemory;
+
+      char *_buffer;
+      size_t _bufferLength;
+      size_t _bufferCapacity;
       };
 
 }
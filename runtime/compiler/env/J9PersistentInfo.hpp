@@ -172,6 +172,8 @@ class PersistentInfo : public OMR::PersistentInfoConnector
          _requireJITServer(false),
          _localSyncCompiles(true),
          _JITServerUseAOTCache(false),
+         _JITServerMessageCompression(false),
+         _JITServerLatencyAwareRouting(false),
          _JITServerAOTCacheName("default"),
          _JITServerUseAOTCachePersistence(false),
          _JITServerAOTCacheDir(),
@@ -371,6 +373,10 @@ class PersistentInfo : public OMR::PersistentInfoConnector
    void setLocalSyncCompiles(bool localSyncCompiles) { _localSyncCompiles = localSyncCompiles; }
    bool getJITServerUseAOTCache() const { return _JITServerUseAOTCache; }
    void setJITServerUseAOTCache(bool use) { _JITServerUseAOTCache = use; }
+   bool getJITServerMessageCompression() const { return _JITServerMessageCompression; }
+   void setJITServerMessageCompression(bool use) { _JITServerMessageCompression = use; }
+   bool getJITServerLatencyAwareRouting() const { return _JITServerLatencyAwareRouting; }
+   void setJITServerLatencyAwareRouting(bool use) { _JITServerLatencyAwareRouting = use; }
    const std::string &getJITServerAOTCacheName() const { return _JITServerAOTCacheName; }
    void setJITServerAOTCacheName(const char *name) { _JITServerAOTCacheName = name; }
    bool getJITServerUseAOTCachePersistence() const { return _JITServerUseAOTCachePersistence; }
@@ -482,6 +488,8 @@ class PersistentInfo : public OMR::PersistentInfoConnector
    bool        _requireJITServer;
    bool        _localSyncCompiles;
    bool        _JITServerUseAOTCache;
+   bool        _JITServerMessageCompression; // Whether to compress large messages sent between the client and the server
+   bool        _JITServerLatencyAwareRouting; // At the client, whether to keep compilations local when they are expected to be installed sooner
    std::string _JITServerAOTCacheName; // Name of the server AOT cache that this client is using
    bool        _JITServerUseAOTCachePersistence; // Whether to persist the JITServer AOT caches at the server
    std::string _JITServerAOTCacheDir;  // Directory where the JITServer persistent AOT caches are located
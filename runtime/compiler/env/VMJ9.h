@@ -165,6 +165,7 @@ extern "C" {
    J9VMThread * getJ9VMThreadFromTR_VM(void *vm);
    J9JITConfig * getJ9JitConfigFromFE(void *vm);
    TR::FILE *j9jit_fopen(const char *fileName, const char *mode, bool useJ9IO);
+   TR::FILE *j9jit_fopenInMemory();
    void j9jit_fclose(TR::FILE *pFile);
    void j9jit_seek(void *voidConfig, TR::FILE *pFile, IDATA offset, I_32 whence);
    IDATA j9jit_read(void *voidConfig, TR::FILE *pFile, void *buf, IDATA nbytes);
@@ -20,6 +20,8 @@
  * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
  *******************************************************************************/
 
+#include <unordered_map>
+#include <unordered_set>
 #include "j9methodServer.hpp"
 #include "control/CompilationRuntime.hpp"
 #include "control/CompilationThread.hpp"
@@ -1577,6 +1579,76 @@ TR_ResolvedJ9JITServerMethod::addValidationRecordForCachedResolvedMethod(const T
    return added;
    }
 
+// Return the type of resolved method required by an invoke bytecode, or NoType if the bytecode is not an invoke.
+// The cpIndex read from the bytecode is updated for split table indices.
+static TR_ResolvedMethodType
+getResolvedMethodTypeForInvoke(TR_J9ByteCode bc, int32_t &cpIndex)
+   {
+   switch (bc)
+      {
+      case J9BCinvokevirtual:
+         return TR_ResolvedMethodType::VirtualFromCP;
+      case J9BCinvokestaticsplit:
+         cpIndex |= J9_STATIC_SPLIT_TABLE_INDEX_FLAG;
+         return TR_ResolvedMethodType::Static;
+      case J9BCinvokestatic:
+         return TR_ResolvedMethodType::Static;
+      case J9BCinvokespecialsplit:
+         cpIndex |= J9_SPECIAL_SPLIT_TABLE_INDEX_FLAG;
+         return TR_ResolvedMethodType::Special;
+      case J9BCinvokespecial:
+         return TR_ResolvedMethodType::Special;
+      case J9BCinvokeinterface:
+         return TR_ResolvedMethodType::ImproperInterface;
+      default:
+         return TR_ResolvedMethodType::NoType;
+      }
+   }
+
+bool
+TR_ResolvedJ9JITServerMethod::isResolvedMethodCached(TR_ResolvedMethodType type, int32_t cpIndex)
+   {
+   auto compInfoPT = static_cast<TR::CompilationInfoPerThreadRemote *>(_fe->_compInfoPT);
+   TR_ResolvedMethod *resolvedMethod;
+   return compInfoPT->getCachedResolvedMethod(
+      compInfoPT->getResolvedMethodKey(type, (TR_OpaqueClassBlock *) _ramClass, cpIndex),
+      this,
+      &resolvedMethod);
+   }
+
+void
+TR_ResolvedJ9JITServerMethod::cacheResolvedMethods(
+   const std::vector<TR_ResolvedMethodType> &methodTypes,
+   const std::vector<int32_t> &cpIndices,
+   const std::vector<TR_OpaqueMethodBlock *> &ramMethods,
+   const std::vector<uint32_t> &vTableOffsets,
+   const std::vector<TR_ResolvedJ9JITServerMethodInfo> &methodInfos,
+   int32_t ttlForUnresolved)
+   {
+   auto compInfoPT = static_cast<TR::CompilationInfoPerThreadRemote *>(_fe->_compInfoPT);
+   int32_t numMethods = methodTypes.size();
+   TR_ASSERT(numMethods == ramMethods.size(), "Number of received methods does not match the number of requested methods");
+   for (int32_t i = 0; i < numMethods; ++i)
+      {
+      TR_ResolvedMethodType type = methodTypes[i];
+      TR_ResolvedMethod *resolvedMethod;
+      TR_ResolvedMethodKey key = compInfoPT->getResolvedMethodKey(type, (TR_OpaqueClassBlock *) _ramClass, cpIndices[i]);
+      if (!compInfoPT->getCachedResolvedMethod(
+             key,
+             this,
+             &resolvedMethod))
+         {
+         compInfoPT->cacheResolvedMethod(
+            key,
+            ramMethods[i],
+            vTableOffsets[i],
+            methodInfos[i],
+            ttlForUnresolved
+            );
+         }
+      }
+   }
+
 void
 TR_ResolvedJ9JITServerMethod::cacheResolvedMethodsCallees(int32_t ttlForUnresolved)
    {
@@ -1591,52 +1663,8 @@ TR_ResolvedJ9JITServerMethod::cacheResolvedMethodsCallees(int32_t ttlForUnresolv
       {
       // Identify all bytecodes that require a resolved method
       int32_t cpIndex = bci.next2Bytes();
-      TR_ResolvedMethodType type = TR_ResolvedMethodType::NoType;
-      TR_ResolvedMethod *resolvedMethod;
-      switch (bc)
-         {
-         case J9BCinvokevirtual:
-            {
-            type = TR_ResolvedMethodType::VirtualFromCP;
-            break;
-            }
-         case J9BCinvokestaticsplit:
-            {
-            // falling through on purpose
-            cpIndex |= J9_STATIC_SPLIT_TABLE_INDEX_FLAG;
-            }
-         case J9BCinvokestatic:
-            {
-            type = TR_ResolvedMethodType::Static;
-            break;
-            }
-         case J9BCinvokespecialsplit:
-            {
-            // falling through on purpose
-            cpIndex |= J9_SPECIAL_SPLIT_TABLE_INDEX_FLAG;
-            }
-         case J9BCinvokespecial:
-            {
-            type = TR_ResolvedMethodType::Special;
-            break;
-            }
-         case J9BCinvokeinterface:
-            {
-            type = TR_ResolvedMethodType::ImproperInterface;
-            break;
-            }
-         default:
-            {
-            // do nothing
-            break;
-            }
-         }
-
-      if (type != TR_ResolvedMethodType::NoType &&
-          !compInfoPT->getCachedResolvedMethod(
-             compInfoPT->getResolvedMethodKey(type, (TR_OpaqueClassBlock *) _ramClass, cpIndex),
-             this,
-             &resolvedMethod))
+      TR_ResolvedMethodType type = getResolvedMethodTypeForInvoke(bc, cpIndex);
+      if (type != TR_ResolvedMethodType::NoType && !isResolvedMethodCached(type, cpIndex))
          {
          methodTypes.push_back(type);
          cpIndices.push_back(cpIndex);
@@ -1655,91 +1683,161 @@ TR_ResolvedJ9JITServerMethod::cacheResolvedMethodsCallees(int32_t ttlForUnresolv
    auto recv = _stream->read<std::vector<TR_OpaqueMethodBlock *>, std::vector<uint32_t>, std::vector<TR_ResolvedJ9JITServerMethodInfo>>();
 
    // 3. Cache all received resolved methods
-   auto &ramMethods = std::get<0>(recv);
-   auto &vTableOffsets = std::get<1>(recv);
-   auto &methodInfos = std::get<2>(recv);
-   TR_ASSERT(numMethods == ramMethods.size(), "Number of received methods does not match the number of requested methods");
-   for (int32_t i = 0; i < numMethods; ++i)
-      {
-      TR_ResolvedMethodType type = methodTypes[i];
-      TR_ResolvedMethod *resolvedMethod;
-      TR_ResolvedMethodKey key = compInfoPT->getResolvedMethodKey(type, (TR_OpaqueClassBlock *) _ramClass, cpIndices[i]);
-      if (!compInfoPT->getCachedResolvedMethod(
-             key,
-             this,
-             &resolvedMethod))
-         {
-         compInfoPT->cacheResolvedMethod(
-            key,
-            ramMethods[i],
-            vTableOffsets[i],
-            methodInfos[i],
-            ttlForUnresolved
-            );
-         }
-      }
+   cacheResolvedMethods(methodTypes, cpIndices, std::get<0>(recv), std::get<1>(recv), std::get<2>(recv), ttlForUnresolved);
    }
 
 void
-TR_ResolvedJ9JITServerMethod::cacheFields()
-   {
-   // 1. Iterate through bytecodes and look for loads/stores
-   // If the corresponding field or static is not cached, add it
-   // to the list of fields that will be sent to the client in one batch.
+TR_ResolvedJ9JITServerMethod::prefetchResolutions(bool includeCallees, int32_t ttlForUnresolved)
+   {
+   // 1. Iterate through bytecodes and collect the queries that ILGen is about to make for them
+   // and that cannot be answered from the caches:
+   //    - resolved methods for invokes (only if includeCallees is set)
+   //    - field info for loads/stores, used by jitFieldsAreSame/jitStaticAreSame when creating symbol references
+   //    - field and static attributes for loads/stores
+   //    - classes for new, anewarray, multianewarray, checkcast and instanceof
+   // Attributes and classes are not prefetched for AOT compilations, which use separate caches and validation,
+   // nor with runtime resolution, which bypasses the caches.
    auto serverVM = static_cast<TR_J9ServerVM *>(_fe);
-   auto compInfoPT = _fe->_compInfoPT;
-   TR_J9ByteCodeIterator bci(0, this, _fe, compInfoPT->getCompilation());
-   std::vector<int32_t> cpIndices;
-   std::vector<uint8_t> isStaticField;
+   auto compInfoPT = static_cast<TR::CompilationInfoPerThreadRemote *>(_fe->_compInfoPT);
+   TR::Compilation *comp = compInfoPT->getCompilation();
+   ClientSessionData *clientData = compInfoPT->getClientData();
+   bool prefetchConstants = !comp->compileRelocatableCode() && !clientData->getRtResolve();
    J9Class *ramClass = constantPoolHdr();
-   for(TR_J9ByteCode bc = bci.first(); bc != J9BCunknown; bc = bci.next())
-      {
-      bool isField = false;
-      bool isStatic;
-      if (bc == J9BCgetfield || bc == J9BCputfield)
-         {
-         isField = true;
-         isStatic = false;
-         }
-      else if (bc == J9BCgetstatic || bc == J9BCputstatic)
-         {
-         isField = true;
-         isStatic = true;
-         }
 
-      J9Class *declaringClass;
-      UDATA field;
+   std::vector<TR_ResolvedMethodType> methodTypes;
+   std::vector<int32_t> methodCPIndices;
+   std::vector<int32_t> fieldCPIndices;
+   std::vector<uint8_t> fieldIsStatic;
+   std::vector<int32_t> attributesCPIndices;
+   std::vector<uint8_t> attributesIsStatic;
+   std::vector<uint8_t> attributesIsStore;
+   std::vector<int32_t> classCPIndices;
+   // The same constant pool entry is typically referenced by several bytecodes.
+   // Map the cpIndex of each field seen so far to its position in the attribute queries, or -1 if cached.
+   std::unordered_map<int32_t, int32_t> seenAttributes;
+   std::unordered_set<int32_t> seenFieldsAndClasses;
+
+   TR_J9ByteCodeIterator bci(0, this, _fe, comp);
+   for (TR_J9ByteCode bc = bci.first(); bc != J9BCunknown; bc = bci.next())
+      {
       int32_t cpIndex = bci.next2Bytes();
-      if (isField && !serverVM->getCachedField(ramClass, cpIndex, &declaringClass, &field))
+      switch (bc)
          {
-         cpIndices.push_back(cpIndex);
-         isStaticField.push_back(isStatic);
+         case J9BCgetfield:
+         case J9BCputfield:
+         case J9BCgetstatic:
+         case J9BCputstatic:
+            {
+            bool isStatic = (bc == J9BCgetstatic) || (bc == J9BCputstatic);
+            bool isStore = (bc == J9BCputfield) || (bc == J9BCputstatic);
+            J9Class *declaringClass;
+            UDATA field;
+            if (seenFieldsAndClasses.insert(cpIndex).second &&
+                !serverVM->getCachedField(ramClass, cpIndex, &declaringClass, &field))
+               {
+               fieldCPIndices.push_back(cpIndex);
+               fieldIsStatic.push_back(isStatic);
+               }
+
+            if (!prefetchConstants)
+               break;
+            auto it = seenAttributes.find(cpIndex);
+            if (it != seenAttributes.end())
+               {
+               // Resolve for a store if the field is stored anywhere in the method
+               if (isStore && (it->second != -1))
+                  attributesIsStore[it->second] = true;
+               break;
+               }
+            TR_J9MethodFieldAttributes attributes;
+            if (getCachedFieldAttributes(cpIndex, attributes, isStatic))
+               {
+               seenAttributes.insert({cpIndex, -1});
+               }
+            else
+               {
+               seenAttributes.insert({cpIndex, (int32_t)attributesCPIndices.size()});
+               attributesCPIndices.push_back(cpIndex);
+               attributesIsStatic.push_back(isStatic);
+               attributesIsStore.push_back(isStore);
+               }
+            break;
+            }
+         case J9BCnew:
+         case J9BCanewarray:
+         case J9BCmultianewarray:
+         case J9BCcheckcast:
+         case J9BCinstanceof:
+            {
+            if (!prefetchConstants || !seenFieldsAndClasses.insert(cpIndex).second)
+               break;
+            OMR::CriticalSection getRemoteROMClass(clientData->getROMMapMonitor());
+            auto &constantClassPoolCache = getJ9ClassInfo(compInfoPT, _ramClass)._constantClassPoolCache;
+            if (constantClassPoolCache.find(cpIndex) == constantClassPoolCache.end())
+               classCPIndices.push_back(cpIndex);
+            break;
+            }
+         default:
+            {
+            if (!includeCallees)
+               break;
+            TR_ResolvedMethodType type = getResolvedMethodTypeForInvoke(bc, cpIndex);
+            if (type != TR_ResolvedMethodType::NoType && !isResolvedMethodCached(type, cpIndex))
+               {
+               methodTypes.push_back(type);
+               methodCPIndices.push_back(cpIndex);
+               }
+            break;
+            }
          }
       }
 
-   // If there's just one field, it's faster to get it through regular means,
-   // to avoid overhead of vectors
-   int32_t numFields = cpIndices.size();
-   if (numFields < 2)
+   // If there is at most one query, it's cheaper to let it be made
+   // through regular means, because client won't have to deal with vectors
+   size_t numQueries = methodTypes.size() + fieldCPIndices.size() + attributesCPIndices.size() + classCPIndices.size();
+   if (numQueries < 2)
       return;
 
-   // 2. Send a message to get info for all fields
-   JITServer::ServerStream *stream = compInfoPT->getMethodBeingCompiled()->_stream;
-   stream->write(
-      JITServer::MessageType::VM_getFields,
-      getRemoteMirror(),
-      cpIndices,
-      isStaticField);
-   auto recv = stream->read<std::vector<J9Class *>, std::vector<UDATA>>();
-
-   // 3. Cache all received fields
-   auto &declaringClasses = std::get<0>(recv);
-   auto &fields = std::get<1>(recv);
-   TR_ASSERT(numFields == declaringClasses.size(), "Number of received fields does not match the requested number");
-   OMR::CriticalSection getRemoteROMClass(compInfoPT->getClientData()->getROMMapMonitor());
-   for (int32_t i = 0; i < numFields; ++i)
-      {
-      serverVM->cacheField(ramClass, cpIndices[i], declaringClasses[i], fields[i]);
+   // 2. Send all queries to the client in one message
+   _stream->write(
+      JITServer::MessageType::ResolvedMethod_getResolutionBatch,
+      _remoteMirror,
+      methodTypes, methodCPIndices,
+      fieldCPIndices, fieldIsStatic,
+      attributesCPIndices, attributesIsStatic, attributesIsStore,
+      classCPIndices);
+   auto recv = _stream->read<
+      std::vector<TR_OpaqueMethodBlock *>, std::vector<uint32_t>, std::vector<TR_ResolvedJ9JITServerMethodInfo>,
+      std::vector<J9Class *>, std::vector<UDATA>,
+      std::vector<TR_J9MethodFieldAttributes>,
+      std::vector<TR_OpaqueClassBlock *>>();
+
+   // 3. Cache all the answers
+   cacheResolvedMethods(methodTypes, methodCPIndices, std::get<0>(recv), std::get<1>(recv), std::get<2>(recv), ttlForUnresolved);
+
+   auto &declaringClasses = std::get<3>(recv);
+   auto &fields = std::get<4>(recv);
+   TR_ASSERT(fieldCPIndices.size() == declaringClasses.size(), "Number of received fields does not match the requested number");
+      {
+      OMR::CriticalSection getRemoteROMClass(clientData->getROMMapMonitor());
+      for (size_t i = 0; i < fieldCPIndices.size(); ++i)
+         serverVM->cacheField(ramClass, fieldCPIndices[i], declaringClasses[i], fields[i]);
+      }
+
+   auto &attributes = std::get<5>(recv);
+   TR_ASSERT(attributesCPIndices.size() == attributes.size(), "Number of received field attributes does not match the requested number");
+   for (size_t i = 0; i < attributesCPIndices.size(); ++i)
+      cacheFieldAttributes(attributesCPIndices[i], attributes[i], attributesIsStatic[i]);
+
+   auto &classes = std::get<6>(recv);
+   TR_ASSERT(classCPIndices.size() == classes.size(), "Number of received classes does not match the requested number");
+   OMR::CriticalSection getRemoteROMClass(clientData->getROMMapMonitor());
+   auto &constantClassPoolCache = getJ9ClassInfo(compInfoPT, _ramClass)._constantClassPoolCache;
+   for (size_t i = 0; i < classCPIndices.size(); ++i)
+      {
+      // Do not cache unresolved classes, because they may become resolved later on
+      if (classes[i])
+         constantClassPoolCache.insert({classCPIndices[i], classes[i]});
       }
    }
 
@@ -229,7 +229,8 @@ public:
    static void createResolvedMethodFromJ9MethodMirror(TR_ResolvedJ9JITServerMethodInfo &methodInfo, TR_OpaqueMethodBlock *method, uint32_t vTableSlot, TR_ResolvedMethod *owningMethod, TR_FrontEnd *fe, TR_Memory *trMemory);
    bool addValidationRecordForCachedResolvedMethod(const TR_ResolvedMethodKey &key, TR_OpaqueMethodBlock *method);
    void cacheResolvedMethodsCallees(int32_t ttlForUnresolved = 2);
-   void cacheFields();
+   // Get the answers to the queries that ILGen makes for this method from the client in a single message
+   void prefetchResolutions(bool includeCallees, int32_t ttlForUnresolved = 2);
    int32_t collectImplementorsCapped(TR_OpaqueClassBlock *topClass, int32_t maxCount, int32_t cpIndexOrOffset, TR_YesNoMaybe useGetResolvedInterfaceMethod, TR_ResolvedMethod **implArray);
    bool isLambdaFormGeneratedMethod() { return _isLambdaFormGeneratedMethod; }
    static void packMethodInfo(TR_ResolvedJ9JITServerMethodInfo &methodInfo, TR_ResolvedJ9Method *resolvedMethod, TR_FrontEnd *fe);
@@ -245,6 +246,10 @@ protected:
    virtual bool canCacheFieldAttributes(int32_t cpIndex, const TR_J9MethodFieldAttributes &attributes, bool isStatic);
 
 private:
+   bool isResolvedMethodCached(TR_ResolvedMethodType type, int32_t cpIndex);
+   void cacheResolvedMethods(const std::vector<TR_ResolvedMethodType> &methodTypes, const std::vector<int32_t> &cpIndices,
+                             const std::vector<TR_OpaqueMethodBlock *> &ramMethods, const std::vector<uint32_t> &vTableOffsets,
+                             const std::vector<TR_ResolvedJ9JITServerMethodInfo> &methodInfos, int32_t ttlForUnresolved);
 
    J9ROMClass *_romClass; // cached copy of ROM class from client
    J9RAMConstantPoolItem *_literals; // client pointer to constant pool
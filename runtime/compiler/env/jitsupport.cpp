@@ -176,6 +176,22 @@ j9jit_fopen(const char *fileName, const char *mode, bool useJ9IO)
    }
 
 
+TR::FILE *
+j9jit_fopenInMemory()
+   {
+   PORT_ACCESS_FROM_PORT(TR::Compiler->portLib);
+   TR::FILE *pFile = (TR::FILE *)j9mem_allocate_memory(sizeof(TR::FILE), J9MEM_CATEGORY_JIT);
+   if (!pFile)
+      {
+      j9tty_printf(privatePortLibrary, "Non-Fatal Error: Unable to open in-memory file\n");
+      return NULL;
+      }
+
+   pFile->initializeInMemory();
+   return pFile;
+   }
+
+
 void j9jit_fclose(TR::FILE *pFile)
    {
    PORT_ACCESS_FROM_PORT(TR::Compiler->portLib);
@@ -305,7 +321,9 @@ I_32 j9jit_vfprintf(TR::FILE *pFile, const char *format, va_list args)
       {
       char *bufPtr = buf;
 #if defined(J9ZOS390)
-      bufPtr = a2e(bufPtr, length);
+      // In-memory files are only read back by the JIT itself so they are kept in ASCII
+      if (!pFile->isInMemory())
+         bufPtr = a2e(bufPtr, length);
 #endif
       if (pFile->write(privatePortLibrary, bufPtr, length) == length)
          {
@@ -314,7 +332,8 @@ I_32 j9jit_vfprintf(TR::FILE *pFile, const char *format, va_list args)
             pFile->flush(privatePortLibrary);
          }
 #if defined(J9ZOS390)
-      free(bufPtr);
+      if (bufPtr != buf)
+         free(bufPtr);
 #endif
       }
    if (grewBuf)
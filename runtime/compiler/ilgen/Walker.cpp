@@ -203,20 +203,20 @@ TR::Block * TR_J9ByteCodeIlGenerator::walker(TR::Block * prevBlock)
 #if defined(J9VM_OPT_JITSERVER)
    if (prevBlock == 0 && comp()->isOutOfProcessCompilation() && _methodSymbol->getResolvedMethod())
       {
-      // Every J9BCinvoke* bytecode requires a corresponding resolved method for its method symbol.
-      // Prefetch resolved methods in one message.
-      // For unresolved methods, allow the next 2 requests to return NULL without asking the client,
-      // since they happen almost immediately after this one and method is unlikely to become resolved.
+      // Prefetch in one message the answers to the queries made while generating IL for this method:
+      // field info for every field/static loaded/stored in this method, which are later used by
+      // jitFieldsAreSame/jitStaticAreSame when creating symbol references, field attributes and classes.
+      //
+      // Every J9BCinvoke* bytecode requires a corresponding resolved method for its method symbol,
+      // which is prefetched for the method being compiled (callees of inlined methods are prefetched
+      // when estimating their size). For unresolved methods, allow the next 2 requests to return NULL
+      // without asking the client, since they happen almost immediately after this one and method is
+      // unlikely to become resolved.
       //
       // NOTE: first request occurs in the switch statement over bytecodes,
       // second request occurs in stashArgumentsForOSR
-      if (_methodSymbol->getResolvedMethod() == comp()->getMethodBeingCompiled())
-         static_cast<TR_ResolvedJ9JITServerMethod *>(_methodSymbol->getResolvedMethod())->cacheResolvedMethodsCallees(2);
-
-
-      // Cache field info for every field/static loaded/stored in this method, which are later used by
-      // jitFieldsAreSame/jitStaticAreSame when creating symbol references.
-      static_cast<TR_ResolvedJ9JITServerMethod *>(_methodSymbol->getResolvedMethod())->cacheFields();
+      bool includeCallees = _methodSymbol->getResolvedMethod() == comp()->getMethodBeingCompiled();
+      static_cast<TR_ResolvedJ9JITServerMethod *>(_methodSymbol->getResolvedMethod())->prefetchResolutions(includeCallees, 2);
       }
 #endif
 
@@ -85,7 +85,7 @@ public:
       {
       if (getVersionCheckStatus() == NOT_DONE)
          {
-         _cMsg.setFullVersion(getJITServerVersion(), CONFIGURATION_FLAGS);
+         _cMsg.setFullVersion(getJITServerVersion(), CONFIGURATION_FLAGS | OPTIONAL_FEATURES);
          write(MessageType::compilationRequest, args...);
          _cMsg.clearFullVersion();
          }
@@ -121,6 +121,7 @@ public:
    MessageType read()
       {
       readMessage(_sMsg);
+      setRemoteOptionalFeatures(_sMsg.getMetaData()->_config);
       return _sMsg.type();
       }
 
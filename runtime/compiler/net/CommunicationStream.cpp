@@ -23,13 +23,16 @@
 #include "control/CompilationRuntime.hpp"
 #include "control/Options.hpp" // TR::Options::useCompressedPointers()
 #include "env/CompilerEnv.hpp" // for TR::Compiler->target.is64Bit()
+#include "infra/Assert.hpp"
 #include "net/CommunicationStream.hpp"
+#include "zlib.h"
 
 
 namespace JITServer
 {
 
 uint32_t CommunicationStream::CONFIGURATION_FLAGS = 0;
+uint32_t CommunicationStream::OPTIONAL_FEATURES = 0;
 
 uint32_t CommunicationStream::_msgTypeCount[] = {0};
 uint64_t CommunicationStream::_totalMsgSize = 0;
@@ -38,6 +41,12 @@ uint32_t CommunicationStream::_numConsecutiveReadErrorsOfSameType = 0;
 #if defined(MESSAGE_SIZE_STATS)
 TR_Stats CommunicationStream::_msgSizeStats[];
 #endif /* defined(MESSAGE_SIZE_STATS) */
+uint32_t CommunicationStream::_numCompressedMsgsSent = 0;
+uint64_t CommunicationStream::_totalCompressedMsgSizeSent = 0;
+uint64_t CommunicationStream::_totalUncompressedMsgSizeSent = 0;
+uint32_t CommunicationStream::_numCompressedMsgsReceived = 0;
+uint64_t CommunicationStream::_totalCompressedMsgSizeReceived = 0;
+uint64_t CommunicationStream::_totalUncompressedMsgSizeReceived = 0;
 
 void
 CommunicationStream::initConfigurationFlags()
@@ -46,6 +55,10 @@ CommunicationStream::initConfigurationFlags()
       {
       CONFIGURATION_FLAGS |= JITServerCompressedRef;
       }
+   if (TR::CompilationInfo::get()->getPersistentInfo()->getJITServerMessageCompression())
+      {
+      OPTIONAL_FEATURES |= JITServerMessageCompression;
+      }
    CONFIGURATION_FLAGS |= JAVA_SPEC_VERSION & JITServerJavaVersionMask;
    }
 
@@ -86,6 +99,8 @@ CommunicationStream::readMessage(Message &msg)
 
    // bytesRead >= sizeof(uint32_t)
    uint32_t serializedSize = ((uint32_t *)buffer)[0];
+   bool isCompressed = (serializedSize & COMPRESSED_MESSAGE_FLAG) != 0;
+   serializedSize &= ~COMPRESSED_MESSAGE_FLAG;
    if (bytesRead > serializedSize)
       {
       throw JITServer::StreamFailure("JITServer I/O error: read more than the message size");
@@ -108,6 +123,16 @@ CommunicationStream::readMessage(Message &msg)
       readBlocking(buffer + bytesRead, bytesLeftToRead);
       }
 
+   if (isCompressed)
+      {
+      uint32_t compressedSize = serializedSize;
+      serializedSize = decompressMessage(msg, compressedSize);
+
+      _numCompressedMsgsReceived += 1;
+      _totalCompressedMsgSizeReceived += compressedSize;
+      _totalUncompressedMsgSizeReceived += serializedSize;
+      }
+
    msg.setSerializedSize(serializedSize);
 
    // rebuild the message
@@ -125,11 +150,156 @@ void
 CommunicationStream::writeMessage(Message &msg)
    {
    char *serialMsg = msg.serialize();
+   uint32_t serializedSize = msg.serializedSize();
+
+   // The top bit of the size marks compressed messages
+   TR_ASSERT_FATAL(serializedSize < COMPRESSED_MESSAGE_FLAG, "Message of %u bytes is too large to be sent", serializedSize);
+
+   // Compression is only used once both parties have told each other that they enabled it. The client
+   // learns it from the first response of the server, so the first request on a connection is never compressed.
+   uint32_t compressedSize = 0;
+   if (_compressionEnabled &&
+       (serializedSize >= (uint32_t)TR::Options::_jitserverMessageCompressionThreshold))
+      {
+      // Compression needs the whole message in one contiguous buffer
+      if (msg.hasReferencedData())
+         serialMsg = msg.gatherReferencedData();
+      compressedSize = compressMessage(serialMsg, serializedSize);
+      }
+
    // write serialized message to the socket
-   writeBlocking(serialMsg, msg.serializedSize());
+   if (compressedSize)
+      {
+      writeBlocking(_compressionBuffer, compressedSize);
+
+      _numCompressedMsgsSent += 1;
+      _totalCompressedMsgSizeSent += compressedSize;
+      _totalUncompressedMsgSizeSent += serializedSize;
+      }
+   else if (msg.hasReferencedData())
+      {
+      writeSegments(msg, serialMsg);
+      }
+   else
+      {
+      writeBlocking(serialMsg, serializedSize);
+      }
    msg.clearForWrite();
    }
 
+void
+CommunicationStream::writeSegments(Message &msg, char *serialMsg)
+   {
+   // Interleave the parts of the message held in its buffer with the
+   // referenced data, which is sent without being copied into the buffer
+   uint32_t bufferedOffset = 0;
+   _segments.clear();
+   for (const auto &ref : msg.getReferencedData())
+      {
+      if (ref._offset > bufferedOffset)
+         {
+         struct iovec buffered = { serialMsg + bufferedOffset, ref._offset - bufferedOffset };
+         _segments.push_back(buffered);
+         }
+      if (ref._size > 0)
+         {
+         struct iovec referenced = { const_cast<char *>(ref._data), ref._size };
+         _segments.push_back(referenced);
+         }
+      bufferedOffset = ref._offset;
+      }
+   if (msg.bufferedSize() > bufferedOffset)
+      {
+      struct iovec buffered = { serialMsg + bufferedOffset, msg.bufferedSize() - bufferedOffset };
+      _segments.push_back(buffered);
+      }
+
+   writeBlocking(_segments.data(), _segments.size());
+   }
+
+uint32_t
+CommunicationStream::compressMessage(const char *serialMsg, uint32_t serializedSize)
+   {
+   static const uint32_t compressedHeaderSize = 2 * sizeof(uint32_t);
+   if (serializedSize <= compressedHeaderSize)
+      return 0;
+
+   // Limiting the output to the size of the original message makes
+   // compress2() fail with Z_BUF_ERROR if compression does not pay off
+   ensureCompressionBufferCapacity(serializedSize);
+   uLongf compressedDataSize = serializedSize - compressedHeaderSize;
+   int ret = compress2((Bytef *)(_compressionBuffer + compressedHeaderSize), &compressedDataSize,
+                       (const Bytef *)(serialMsg + sizeof(uint32_t)), serializedSize - sizeof(uint32_t), Z_BEST_SPEED);
+   if (ret != Z_OK)
+      return 0;
+
+   uint32_t compressedSize = compressedHeaderSize + compressedDataSize;
+   ((uint32_t *)_compressionBuffer)[0] = compressedSize | COMPRESSED_MESSAGE_FLAG;
+   ((uint32_t *)_compressionBuffer)[1] = serializedSize;
+   return compressedSize;
+   }
+
+uint32_t
+CommunicationStream::decompressMessage(Message &msg, uint32_t compressedSize)
+   {
+   static const uint32_t compressedHeaderSize = 2 * sizeof(uint32_t);
+   if (compressedSize < compressedHeaderSize)
+      throw JITServer::StreamFailure("JITServer I/O error: compressed message is too small");
+
+   char *buffer = msg.getBufferStartForRead();
+   uint32_t serializedSize = ((uint32_t *)buffer)[1];
+   if (serializedSize < sizeof(uint32_t))
+      throw JITServer::StreamFailure("JITServer I/O error: invalid size of the compressed message");
+
+   // The original message replaces the compressed one in the message buffer,
+   // so the compressed data is first moved out of the way
+   uint32_t compressedDataSize = compressedSize - compressedHeaderSize;
+   ensureCompressionBufferCapacity(compressedDataSize);
+   memcpy(_compressionBuffer, buffer + compressedHeaderSize, compressedDataSize);
+
+   if (serializedSize > msg.getBufferCapacity())
+      {
+      msg.expandBuffer(serializedSize, 0);
+      buffer = msg.getBufferStartForRead();
+      }
+
+   uLongf dataSize = serializedSize - sizeof(uint32_t);
+   int ret = uncompress((Bytef *)(buffer + sizeof(uint32_t)), &dataSize,
+                        (const Bytef *)_compressionBuffer, compressedDataSize);
+   if ((ret != Z_OK) || (dataSize != serializedSize - sizeof(uint32_t)))
+      throw JITServer::StreamFailure("JITServer I/O error: failed to decompress the message");
+
+   return serializedSize;
+   }
+
+void
+CommunicationStream::ensureCompressionBufferCapacity(uint32_t requiredSize)
+   {
+   if (requiredSize <= _compressionBufferCapacity)
+      return;
+
+   freeCompressionBuffer();
+   // Round up to a power of 2 to avoid reallocating for every slightly larger message
+   uint32_t capacity = 1;
+   while (capacity < requiredSize)
+      capacity <<= 1;
+   _compressionBuffer = static_cast<char *>(TR::Compiler->persistentGlobalAllocator().allocate(capacity));
+   if (!_compressionBuffer)
+      throw std::bad_alloc();
+   _compressionBufferCapacity = capacity;
+   }
+
+void
+CommunicationStream::freeCompressionBuffer()
+   {
+   if (_compressionBuffer)
+      {
+      TR::Compiler->persistentGlobalAllocator().deallocate(_compressionBuffer);
+      _compressionBuffer = NULL;
+      _compressionBufferCapacity = 0;
+      }
+   }
+
 std::string
 CommunicationStream::showFullVersionIncompatibility(uint64_t serverFullVersion, uint64_t clientFullVersion)
    {
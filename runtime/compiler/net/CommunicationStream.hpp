@@ -23,7 +23,11 @@
 #ifndef COMMUNICATION_STREAM_H
 #define COMMUNICATION_STREAM_H
 
+#include <algorithm>
+#include <limits.h>
 #include <unistd.h>
+#include <sys/uio.h>
+#include <vector>
 #include "net/LoadSSLLibs.hpp"
 #include "net/Message.hpp"
 #include "infra/Statistics.hpp"
@@ -34,10 +38,14 @@ namespace JITServer
 {
 // When adding another compatibility mask/flag, also add a new message in
 // CommunicationStream::showFullVersionIncompatibility that handles the new enum value.
+// Flags in JITServerOptionalFeaturesMask do not have to match: each side advertises the
+// optional features it enables, and a feature is only used when both sides enable it.
 enum JITServerCompatibilityFlags
    {
-   JITServerJavaVersionMask    = 0x00000FFF,
-   JITServerCompressedRef      = 0x00001000,
+   JITServerJavaVersionMask      = 0x00000FFF,
+   JITServerCompressedRef        = 0x00001000,
+   JITServerMessageCompression   = 0x00002000,
+   JITServerOptionalFeaturesMask = JITServerMessageCompression,
    };
 
 class CommunicationStream
@@ -56,6 +64,13 @@ public:
 #if defined(MESSAGE_SIZE_STATS)
    static TR_Stats _msgSizeStats[MessageType::MessageType_MAXTYPE];
 #endif /* defined(MESSAGE_SIZE_STATS) */
+   // Message compression statistics; sizes are those of the whole message, before and after compression
+   static uint32_t _numCompressedMsgsSent;
+   static uint64_t _totalCompressedMsgSizeSent;
+   static uint64_t _totalUncompressedMsgSizeSent;
+   static uint32_t _numCompressedMsgsReceived;
+   static uint64_t _totalCompressedMsgSizeReceived;
+   static uint64_t _totalUncompressedMsgSizeReceived;
 
    static void initConfigurationFlags();
 
@@ -75,6 +90,12 @@ public:
       {
       return Message::buildFullVersion(getJITServerVersion(), CONFIGURATION_FLAGS);
       }
+
+   // Full version of the remote party without the flags of the optional features it enables
+   static uint64_t getRequiredFullVersion(uint64_t fullVersion)
+      {
+      return fullVersion & ~((uint64_t)JITServerOptionalFeaturesMask << 32);
+      }
    static std::string showFullVersionIncompatibility(uint64_t serverFullVersion, uint64_t clientFullVersion);
 
    static void printJITServerVersion()
@@ -89,7 +110,8 @@ public:
       }
 
 protected:
-   CommunicationStream() : _ssl(NULL), _connfd(-1) { }
+   CommunicationStream() :
+      _ssl(NULL), _connfd(-1), _compressionEnabled(false), _compressionBuffer(NULL), _compressionBufferCapacity(0) { }
 
    virtual ~CommunicationStream()
       {
@@ -97,6 +119,7 @@ protected:
          (*OBIO_free_all)(_ssl);
       if (_connfd != -1)
          close(_connfd);
+      freeCompressionBuffer();
       }
 
    void initStream(int connfd, BIO *ssl)
@@ -112,6 +135,12 @@ protected:
 
    int getConnFD() const { return _connfd; }
 
+   // Called with the flags sent by the remote party to enable the optional features that both parties enable
+   void setRemoteOptionalFeatures(uint32_t flags)
+      {
+      _compressionEnabled = (OPTIONAL_FEATURES & flags & JITServerMessageCompression) != 0;
+      }
+
    BIO *_ssl; // SSL connection, null if not using SSL
    int _connfd;
    ServerMessage _sMsg;
@@ -128,11 +157,33 @@ protected:
    // likely to lose an increment when merging/rebasing/etc.
    //
    static const uint8_t MAJOR_NUMBER = 1;
-   static const uint16_t MINOR_NUMBER = 64; // ID: EbRgDu72oycJkc90HtnO
+   static const uint16_t MINOR_NUMBER = 69; // ID: QPQ4TcP2cMDDHPdibgQr
    static const uint8_t PATCH_NUMBER = 0;
    static uint32_t CONFIGURATION_FLAGS;
+   static uint32_t OPTIONAL_FEATURES; // JITServerOptionalFeaturesMask flags enabled by this party
+
+   bool _compressionEnabled; // Both parties enabled message compression on this connection
 
 private:
+   // Set in the size of a message whose content after the size has been compressed.
+   // The compressed message starts with its own size and the size of the original message.
+   static const uint32_t COMPRESSED_MESSAGE_FLAG = 0x80000000;
+
+   // Compress a serialized message into _compressionBuffer.
+   // Return the size of the compressed message, or 0 if compression did not make it smaller.
+   uint32_t compressMessage(const char *serialMsg, uint32_t serializedSize);
+   // Replace the compressed message read into msg with the original message and return its size
+   uint32_t decompressMessage(Message &msg, uint32_t compressedSize);
+   void ensureCompressionBufferCapacity(uint32_t requiredSize);
+   void freeCompressionBuffer();
+
+   char *_compressionBuffer; // Scratch buffer for compression, allocated on first use
+   uint32_t _compressionBufferCapacity;
+
+   // Send a message that references data outside of its buffer as a list of segments
+   void writeSegments(Message &msg, char *serialMsg);
+   std::vector<struct iovec> _segments; // Reused by writeSegments
+
    void readBlocking(char *data, size_t size)
       {
       size_t totalBytesRead = 0;
@@ -246,6 +297,46 @@ private:
             }
          }
       }
+
+   // Write all the segments described by iov; the entries of iov are modified in the process
+   void writeBlocking(struct iovec *iov, int iovcnt)
+      {
+      if (_ssl)
+         {
+         for (int i = 0; i < iovcnt; ++i)
+            writeBlocking(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+         return;
+         }
+
+      while (iovcnt > 0)
+         {
+         ssize_t bytesWritten = writev(_connfd, iov, std::min(iovcnt, IOV_MAX));
+         if (bytesWritten <= 0)
+            {
+            if (EINTR != errno)
+               {
+               throw JITServer::StreamFailure("JITServer I/O error: write error: " + std::string(strerror(errno)));
+               }
+            }
+         else
+            {
+            // Skip the segments that were written entirely and
+            // advance into the segment that was written partially
+            size_t bytesLeft = bytesWritten;
+            while ((iovcnt > 0) && (bytesLeft >= iov->iov_len))
+               {
+               bytesLeft -= iov->iov_len;
+               ++iov;
+               --iovcnt;
+               }
+            if (bytesLeft > 0)
+               {
+               iov->iov_base = static_cast<char *>(iov->iov_base) + bytesLeft;
+               iov->iov_len -= bytesLeft;
+               }
+            }
+         }
+      }
    }; // class CommunicationStream
 }; // namespace JITServer
 
@@ -61,8 +61,13 @@ Message::addData(const DataDescriptor &desc, const void *dataStart, bool needs64
       serializedDescriptor->addInitialPadding(initialPadding);
       }
 
-   // Write the real data and possibly some padding at the end
-   _buffer.writeData(dataStart, desc.getPayloadSize(), desc.getPaddingSize()); 
+   // Write the real data and possibly some padding at the end.
+   // Large payloads are referenced in place and sent directly from their
+   // own memory, see CommunicationStream::writeMessage
+   if (desc.getPayloadSize() >= MessageBuffer::MIN_REFERENCED_DATA_SIZE)
+      _buffer.referenceData(dataStart, desc.getPayloadSize(), desc.getPaddingSize());
+   else
+      _buffer.writeData(dataStart, desc.getPayloadSize(), desc.getPaddingSize());
    _descriptorOffsets.push_back(descOffset);
    return desc.getTotalSize() + initialPadding;
    }
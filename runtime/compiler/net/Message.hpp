@@ -230,6 +230,8 @@ public:
       Writes the descriptor and attached data to the MessageBuffer
       and updates the message structure. If the attached data is not
       aligned on a 32-bit boundary, some padding will be written as well.
+      Large data is only referenced by the MessageBuffer, so it must stay
+      valid until the message has been sent.
 
       @param desc Descriptor for the new data
       @param dataStart Pointer to the new data
@@ -298,19 +300,41 @@ public:
       @brief Serialize the message
       
       Write total message size to the beginning of message buffer and return pointer to it.
+      If the message references data outside of the buffer, the buffer only holds
+      the parts of the message in between, see getReferencedData().
 
       @return A pointer to the beginning of the serialized message
    */
    char *serialize()
       {
-      *_buffer.getValueAtOffset<uint32_t>(0) = _buffer.size();
+      *_buffer.getValueAtOffset<uint32_t>(0) = serializedSize();
       return _buffer.getBufferStart();
       }
 
    /**
-      @brief Return the size of the serialized message.
+      @brief Return the size of the serialized message, including referenced data.
    */
-   uint32_t serializedSize() { return _buffer.size(); }
+   uint32_t serializedSize() { return _buffer.size() + _buffer.referencedDataSize(); }
+
+   /**
+      @brief Return the size of the part of the serialized message held in the buffer.
+   */
+   uint32_t bufferedSize() { return _buffer.size(); }
+
+   bool hasReferencedData() const { return !_buffer.getReferencedData().empty(); }
+
+   /**
+      @brief Get the large payloads that are sent from their own memory
+      instead of from the buffer, sorted by their offset into the buffer.
+   */
+   const std::vector<MessageBuffer::ReferencedData> &getReferencedData() const { return _buffer.getReferencedData(); }
+
+   /**
+      @brief Copy the referenced data into the buffer to get a contiguous serialized message.
+
+      @return A pointer to the beginning of the serialized message
+   */
+   char *gatherReferencedData() { return _buffer.gatherReferencedData(); }
 
    /**
       @brief Rebuild the message from the MessageBuffer
@@ -27,7 +27,8 @@ namespace JITServer
 {
 MessageBuffer::MessageBuffer() :
    _capacity(INITIAL_BUFFER_SIZE),
-   _allocator(TR::Compiler->persistentGlobalAllocator())
+   _allocator(TR::Compiler->persistentGlobalAllocator()),
+   _referencedDataSize(0)
    {
    _storage = allocateMemory(_capacity);
    if (!_storage)
@@ -80,6 +81,50 @@ MessageBuffer::writeData(const void *dataStart, uint32_t dataSize, uint8_t paddi
    return offset(data);
    }
  
+uint32_t
+MessageBuffer::referenceData(const void *dataStart, uint32_t dataSize, uint8_t paddingSize)
+   {
+   uint32_t dataOffset = size();
+   uint32_t referencedSize = dataSize & ~((uint32_t)0x7);
+   ReferencedData ref = { dataOffset, static_cast<const char *>(dataStart), referencedSize };
+   _referencedData.push_back(ref);
+   _referencedDataSize += referencedSize;
+
+   writeData(static_cast<const char *>(dataStart) + referencedSize, dataSize - referencedSize, paddingSize);
+   return dataOffset;
+   }
+
+char *
+MessageBuffer::gatherReferencedData()
+   {
+   if (_referencedData.empty())
+      return _storage;
+
+   uint32_t localSize = size();
+   uint32_t totalSize = localSize + _referencedDataSize;
+   expandIfNeeded(totalSize);
+
+   // Move the local data into its final place starting from the end of the
+   // buffer, so that nothing gets overwritten before it has been moved
+   char *dest = _storage + totalSize;
+   uint32_t localEnd = localSize;
+   for (auto it = _referencedData.rbegin(); it != _referencedData.rend(); ++it)
+      {
+      uint32_t localDataSize = localEnd - it->_offset;
+      dest -= localDataSize;
+      memmove(dest, _storage + it->_offset, localDataSize);
+      dest -= it->_size;
+      memcpy(dest, it->_data, it->_size);
+      localEnd = it->_offset;
+      }
+   TR_ASSERT_FATAL(dest == _storage + localEnd, "Referenced data gathered incorrectly");
+
+   _curPtr = _storage + totalSize;
+   _referencedData.clear();
+   _referencedDataSize = 0;
+   return _storage;
+   }
+
 uint8_t
 MessageBuffer::alignCurrentPositionOn64Bit()
    {
@@ -23,6 +23,7 @@
 #ifndef MESSAGE_BUFFER_H
 #define MESSAGE_BUFFER_H
 
+#include <vector>
 #include "env/jittypes.h"
 #include "env/TRMemory.hpp"
 #include "OMR/Bytes.hpp" // for alignNoCheck
@@ -45,10 +46,32 @@ namespace JITServer
 
    Variable _curPtr defines the boundary of the current data. Reading/writing to/from buffer
    will always advance the pointer.
+
+   Large payloads of an outgoing message can be referenced in place instead of being copied
+   into the buffer (see referenceData()). The buffer then only holds the data in between
+   such payloads and the message must be sent as a list of segments, or gathered into
+   the buffer with gatherReferencedData(), before the referenced memory goes away.
  */
 class MessageBuffer
    {
 public:
+   /**
+      @class ReferencedData
+      @brief A payload of an outgoing message that lives outside of the buffer.
+
+      The payload logically starts at _offset in the buffer, i.e. it is sent
+      right before the buffer contents that start at that offset.
+   */
+   struct ReferencedData
+      {
+      uint32_t _offset;
+      const char *_data;
+      uint32_t _size;
+      };
+
+   // Payloads smaller than this are always copied into the buffer
+   static const uint32_t MIN_REFERENCED_DATA_SIZE = 65536;
+
    MessageBuffer();
 
    ~MessageBuffer()
@@ -119,6 +142,36 @@ public:
    */
    uint32_t writeData(const void *dataStart, uint32_t dataSize, uint8_t paddingSize);
 
+   /**
+      @brief Add a given number of bytes to the buffer without copying them.
+
+      Records a reference to the data, which must stay valid until the message
+      has been sent. To keep the offsets of the buffer and of the message on the
+      wire equal modulo 8, only a multiple of 8 bytes is referenced; the rest
+      of the data and the padding are copied into the buffer.
+
+      @param dataStart pointer to the beginning of the data to be referenced
+      @param dataSize number of bytes of real data to be referenced
+      @param paddingSize number of bytes of padding
+
+      @return offset to the beginning of referenced data inside the buffer
+   */
+   uint32_t referenceData(const void *dataStart, uint32_t dataSize, uint8_t paddingSize);
+
+   /**
+      @brief Copy all referenced data into the buffer, making it contiguous.
+
+      @return pointer to the beginning of the buffer, which might have been reallocated
+   */
+   char *gatherReferencedData();
+
+   const std::vector<ReferencedData> &getReferencedData() const { return _referencedData; }
+
+   /**
+      @brief Get the total number of bytes referenced outside of the buffer.
+   */
+   uint32_t referencedDataSize() const { return _referencedDataSize; }
+
    /**
       @brief Reserve memory for a value of type T.
 
@@ -166,7 +219,12 @@ public:
       return offset(data); // Return offset before the advance
       }
 
-   void clear() { _curPtr = _storage; }
+   void clear()
+      {
+      _curPtr = _storage;
+      _referencedData.clear();
+      _referencedDataSize = 0;
+      }
 
    /**
       @brief Check to see if the current pointer in the MessageBuffer is 64-bit aligned.
@@ -216,6 +274,8 @@ private:
    char *_storage;
    char *_curPtr;
    TR::PersistentAllocator &_allocator;
+   std::vector<ReferencedData> _referencedData; // Sorted by offset
+   uint32_t _referencedDataSize;
    };
 };
 #endif
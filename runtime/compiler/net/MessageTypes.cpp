@@ -79,6 +79,7 @@ const char *messageNames[] =
    "ResolvedMethod_stringConstant",
    "ResolvedMethod_getResolvedVirtualMethod",
    "ResolvedMethod_getMultipleResolvedMethods",
+   "ResolvedMethod_getResolutionBatch",
 #if defined(J9VM_OPT_METHOD_HANDLE)
    "ResolvedMethod_varHandleMethodTypeTableEntryAddress",
    "ResolvedMethod_isUnresolvedVarHandleMethodTypeTableEntry",
@@ -172,7 +173,6 @@ const char *messageNames[] =
    "VM_getCellSizeForSizeClass",
    "VM_getObjectSizeClass",
    "VM_stackWalkerMaySkipFramesSVM",
-   "VM_getFields",
    "VM_increaseOSRGlobalBufferSize",
    "VM_methodOfDirectOrVirtualHandle",
    "VM_targetMethodFromMemberName",
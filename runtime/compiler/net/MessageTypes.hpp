@@ -85,6 +85,7 @@ enum MessageType : uint16_t
    ResolvedMethod_stringConstant,
    ResolvedMethod_getResolvedVirtualMethod,
    ResolvedMethod_getMultipleResolvedMethods,
+   ResolvedMethod_getResolutionBatch, // several independent queries answered in one round-trip
 #if defined(J9VM_OPT_METHOD_HANDLE)
    ResolvedMethod_varHandleMethodTypeTableEntryAddress,
    ResolvedMethod_isUnresolvedVarHandleMethodTypeTableEntry,
@@ -181,7 +182,6 @@ enum MessageType : uint16_t
    VM_getCellSizeForSizeClass,
    VM_getObjectSizeClass,
    VM_stackWalkerMaySkipFramesSVM,
-   VM_getFields,
    VM_increaseOSRGlobalBufferSize,
    VM_methodOfDirectOrVirtualHandle,
    VM_targetMethodFromMemberName,
@@ -20,7 +20,9 @@
  * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
  *******************************************************************************/
 
+#include <poll.h>
 #include "ServerStream.hpp"
+#include "infra/Assert.hpp"
 
 namespace JITServer
 {
@@ -32,9 +34,33 @@ ServerStream::ServerStream(int connfd, BIO *ssl)
    {
    initStream(connfd, ssl);
    _numConnectionsOpened++;
+   _clientId = 0;
    _pClientSessionData = NULL;
    }
 
+void ServerStream::checkPendingRequests(ServerStream * const *streams, bool *ready, int numStreams)
+   {
+   TR_ASSERT_FATAL(numStreams <= MAX_STREAMS_PER_POLL, "Cannot check %d streams at once", numStreams);
+   struct pollfd pfds[MAX_STREAMS_PER_POLL];
+   for (int i = 0; i < numStreams; ++i)
+      {
+      BIO *ssl = streams[i]->_ssl;
+      // Data that SSL has already read from the socket is not reported by poll()
+      ready[i] = ssl && ((*OBIO_ctrl)(ssl, BIO_CTRL_PENDING, 0, NULL) > 0);
+      pfds[i].fd = ready[i] ? -1 : streams[i]->_connfd; // poll() skips negative descriptors
+      pfds[i].events = POLLIN;
+      pfds[i].revents = 0;
+      }
+   if (poll(pfds, numStreams, 0) > 0)
+      {
+      for (int i = 0; i < numStreams; ++i)
+         {
+         if (pfds[i].revents)
+            ready[i] = true;
+         }
+      }
+   }
+
 static bool handleCreateSSLContextError(SSL_CTX *&ctx, const char *errMsg)
    {
    perror(errMsg);
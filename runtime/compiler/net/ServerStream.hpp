@@ -97,6 +97,8 @@ public:
          }
 
       _sMsg.setType(type);
+      // Tell the client which optional features the server enabled
+      _sMsg.getMetaData()->_config = OPTIONAL_FEATURES;
       setArgsRaw<Args...>(_sMsg, args...);
       writeMessage(_sMsg);
       }
@@ -159,9 +161,12 @@ public:
    std::tuple<T...> readCompileRequest()
       {
       readMessage(_cMsg);
-      if (_cMsg.fullVersion() != 0 && _cMsg.fullVersion() != getJITServerFullVersion())
+      if (_cMsg.fullVersion() != 0)
          {
-         throw StreamVersionIncompatible(showFullVersionIncompatibility(getJITServerFullVersion(), _cMsg.fullVersion()));
+         uint64_t clientFullVersion = getRequiredFullVersion(_cMsg.fullVersion());
+         if (clientFullVersion != getJITServerFullVersion())
+            throw StreamVersionIncompatible(showFullVersionIncompatibility(getJITServerFullVersion(), clientFullVersion));
+         setRemoteOptionalFeatures(_cMsg.getMetaData()->_config);
          }
 
       switch (_cMsg.type())
@@ -262,6 +267,21 @@ public:
       return _clientId;
       }
 
+   /**
+      @brief Check, without blocking, which streams have data from their client that was not read yet
+
+      Connections are queued again as soon as their previous request is done, so a queued
+      connection does not necessarily carry a request. All the streams are checked with a
+      single poll(). A connection that was closed or is in error is also reported as ready,
+      since reading from it fails right away.
+
+      @param [in] streams Streams to check; at most MAX_STREAMS_PER_POLL
+      @param [out] ready Set to true for the streams that have pending data
+      @param [in] numStreams Number of streams to check
+   */
+   static void checkPendingRequests(ServerStream * const *streams, bool *ready, int numStreams);
+   static const int MAX_STREAMS_PER_POLL = 64;
+
    void setClientData(ClientSessionData *pClientData)
       {
       _pClientSessionData = pClientData;
@@ -2313,6 +2313,23 @@ bool TR_J9InlinerPolicy::_tryToGenerateILForMethod (TR::ResolvedMethodSymbol* ca
    bool success = false;
    TR::Node * callNode = calltarget->_myCallSite->_callNode;
 
+   // The JIT debug agent bisects the inlined call sites of a miscompiled method by only allowing the first few
+   // inlining attempts of its recompilations to succeed
+   int32_t inliningAttempt = comp()->incNumInliningAttempts();
+   int32_t maxInlinedCallSites = comp()->getOptions()->getDebugAgentMaxInlinedCallSites();
+   if (maxInlinedCallSites >= 0)
+      {
+      if (inliningAttempt >= maxInlinedCallSites)
+         {
+         if (comp()->trace(OMR::inlining))
+            traceMsg(comp(), "Debug agent suppressed inlining attempt %d of %s\n", inliningAttempt, tracer()->traceSignature(calleeSymbol));
+         return false;
+         }
+
+      if (comp()->getOutFile() != NULL)
+         traceMsg(comp(), "Debug agent allowed inlining attempt %d of %s at node n%dn\n", inliningAttempt, tracer()->traceSignature(calleeSymbol), callNode->getGlobalIndex());
+      }
+
    TR::IlGeneratorMethodDetails storage;
    TR::IlGeneratorMethodDetails & ilGenMethodDetails = TR::IlGeneratorMethodDetails::create(storage, calleeSymbol->getResolvedMethod());
    if (!comp()->getOption(TR_DisablePartialInlining) && calltarget->_partialInline)
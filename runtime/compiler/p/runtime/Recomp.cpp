@@ -207,7 +207,8 @@ void J9::Recompilation::methodCannotBeRecompiled(void *oldStartPC, TR_FrontEnd *
    if (bodyInfo->getUsesPreexistence()  // TODO: reconsider whether this is a race cond for info
        || methodInfo->hasBeenReplaced()
        || (linkageInfo->isSamplingMethodBody() && ! fej9->isAsyncCompilation()) // go interpreted for failed recomps in sync mode
-       || methodInfo->isExcludedPostRestore()) // go interpreted if method is excluded post restore
+       || methodInfo->isExcludedPostRestore() // go interpreted if method is excluded post restore
+       || methodInfo->isRevertedByDebugAgent()) // go interpreted if the JIT debug agent is reverting the method
       {
       // Patch the first instruction regardless of counting or sampling
       // TODO: We may need to cross-check with Invalidation to avoid racing cond
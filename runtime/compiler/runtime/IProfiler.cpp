@@ -4536,7 +4536,6 @@ TR_IPHashedCallSite::operator new (size_t size) throw()
    return alloc;
    }
 
-inline
 uintptr_t CallSiteProfileInfo::getClazz(int index)
    {
    if (TR::Compiler->om.compressObjectReferences())
@@ -4546,7 +4545,6 @@ uintptr_t CallSiteProfileInfo::getClazz(int index)
       return (uintptr_t)_clazz[index]; //things are just stored as regular pointers otherwise
    }
 
-inline
 void CallSiteProfileInfo::setClazz(int index, uintptr_t clazzPointer)
    {
    if (TR::Compiler->om.compressObjectReferences())
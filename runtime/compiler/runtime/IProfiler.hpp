@@ -185,6 +185,7 @@ enum TR_EntryStatusInfo
    };
 
 #define TR_IPBC_PERSISTENT_ENTRY_READ  0x1 // used to check if the persistent entry has been read, if so we want to avoid the overhead introduced by calculating sample counts
+#define TR_IPBC_AGGREGATED_ENTRY       0x2 // JITServer: the entry was filled in from the data of other clients, see JITServerSharedProfileCache
 
 // Hash table for bytecodes
 class TR_IPBytecodeHashTableEntry
@@ -227,6 +228,8 @@ public:
    void clearEntryFlags(){ _entryFlags = 0;};
    void setPersistentEntryRead(){ _entryFlags |= TR_IPBC_PERSISTENT_ENTRY_READ;};
    bool isPersistentEntryRead(){ return (_entryFlags & TR_IPBC_PERSISTENT_ENTRY_READ) != 0;};
+   void setAggregatedEntry(){ _entryFlags |= TR_IPBC_AGGREGATED_ENTRY;};
+   bool isAggregatedEntry() const { return (_entryFlags & TR_IPBC_AGGREGATED_ENTRY) != 0;};
 
    bool getCanPersistEntryFlag() const { return (_persistFlags & IPBC_ENTRY_CAN_PERSIST_FLAG) != 0; }
    void setDoNotPersist() { _persistFlags &= ~IPBC_ENTRY_CAN_PERSIST_FLAG; }
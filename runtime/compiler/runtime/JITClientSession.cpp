@@ -30,6 +30,7 @@
 #include "env/ut_j9jit.h"
 #include "env/VerboseLog.hpp"
 #include "net/ServerStream.hpp" // for JITServer::ServerStream
+#include "runtime/JITServerSharedProfileCache.hpp"
 #include "runtime/JITServerSharedROMClassCache.hpp"
 #include "runtime/RuntimeAssumptions.hpp" // for TR_AddressSet
 #include "control/CompilationController.hpp"
@@ -46,6 +47,7 @@ ClientSessionData::ClientSessionData(uint64_t clientUID, uint32_t seqNo, TR_Pers
    _classBySignatureMap(decltype(_classBySignatureMap)::allocator_type(persistentMemory->_persistentAllocator.get())),
    _classChainDataMap(decltype(_classChainDataMap)::allocator_type(persistentMemory->_persistentAllocator.get())),
    _constantPoolToClassMap(decltype(_constantPoolToClassMap)::allocator_type(persistentMemory->_persistentAllocator.get())),
+   _classByROMClassHashMap(decltype(_classByROMClassHashMap)::allocator_type(persistentMemory->_persistentAllocator.get())),
    _unloadedClassAddresses(NULL),
    _requestUnloadedClasses(true),
    _staticFinalDataMap(decltype(_staticFinalDataMap)::allocator_type(persistentMemory->_persistentAllocator.get())),
@@ -68,6 +70,13 @@ ClientSessionData::ClientSessionData(uint64_t clientUID, uint32_t seqNo, TR_Pers
    _cacheInitMonitor = TR::Monitor::create("JIT-JITServerCacheInitMonitor");
    _constantPoolMapMonitor = TR::Monitor::create("JIT-JITServerConstantPoolMonitor");
    _vmInfo = NULL;
+   _schedulingWeight = 1;
+   _schedulingDeficit = 0;
+   _schedulingMark = 0;
+   // Until this client has compiled something, assume that a request takes one scheduling quantum
+   _avgCompTimeUs = TR::Options::_jitserverFairSchedulingQuantum;
+   _avgQueueWaitTimeUs = 0;
+   _numQueuedConnections = 0;
    _staticMapMonitor = TR::Monitor::create("JIT-JITServerStaticMapMonitor");
    _markedForDeletion = false;
    _thunkSetMonitor = TR::Monitor::create("JIT-JITServerThunkSetMonitor");
@@ -134,6 +143,30 @@ ClientSessionData::updateTimeOfLastAccess()
    _timeOfLastAccess = j9time_current_time_millis();
    }
 
+// Weight of a new sample in the moving averages kept for scheduling is 1/2^SCHEDULING_SAMPLE_WEIGHT_SHIFT
+static const uint32_t SCHEDULING_SAMPLE_WEIGHT_SHIFT = 3;
+
+static uint64_t
+addSchedulingSample(uint64_t avg, uint64_t sample)
+   {
+   return avg - (avg >> SCHEDULING_SAMPLE_WEIGHT_SHIFT) + (sample >> SCHEDULING_SAMPLE_WEIGHT_SHIFT);
+   }
+
+// Must be called with the compilation monitor in hand
+void
+ClientSessionData::settleSchedulingCharge(uint64_t chargedUs, uint64_t compTimeUs)
+   {
+   _schedulingDeficit += (int64_t)chargedUs - (int64_t)compTimeUs;
+   _avgCompTimeUs = addSchedulingSample(_avgCompTimeUs, compTimeUs);
+   }
+
+// Must be called with the compilation monitor in hand
+void
+ClientSessionData::recordQueueWaitTime(uint64_t waitTimeUs)
+   {
+   _avgQueueWaitTimeUs = addSchedulingSample(_avgQueueWaitTimeUs, waitTimeUs);
+   }
+
 // This method is called within a critical section such that no two threads can enter it concurrently
 void
 ClientSessionData::initializeUnloadedClassAddrRanges(const std::vector<TR_AddressRange> &unloadedClassRanges, int32_t maxRanges)
@@ -244,6 +277,17 @@ ClientSessionData::processUnloadedClasses(const std::vector<TR_OpaqueClassBlock*
                _J9MethodMap.erase(j9method);
                }
             }
+         if (TR::CompilationInfo::get()->getJITServerSharedProfileCache())
+            {
+            // Classes that share their hash with other classes of this client are not in the map
+            auto hash = JITServerSharedProfileCache::getClassHash(romClass, it->second._numDimensions);
+            if (hash)
+               {
+               auto hashIt = _classByROMClassHashMap.find(*hash);
+               if ((hashIt != _classByROMClassHashMap.end()) && (hashIt->second == (J9Class *)clazz))
+                  _classByROMClassHashMap.erase(hashIt);
+               }
+            }
          it->second.freeClassInfo(_persistentMemory);
          _romClassMap.erase(it);
          }
@@ -447,6 +491,9 @@ ClientSessionData::getOrCacheVMInfo(JITServer::ServerStream *stream)
       _vmInfo = new (_persistentMemory->_persistentAllocator.get()) VMInfo(std::get<0>(recv));
       _vmInfo->_j9SharedClassCacheDescriptorList = reconstructJ9SharedClassCacheDescriptorList(std::get<1>(recv));
       _aotCacheName = std::get<2>(recv);
+      // Do not let a single client claim (almost) all the compilation time of the server
+      int32_t weight = _vmInfo->_schedulingWeight;
+      _schedulingWeight = (weight < 1) ? 1 : ((weight > MAX_SCHEDULING_WEIGHT) ? MAX_SCHEDULING_WEIGHT : weight);
       }
    return _vmInfo;
    }
@@ -541,6 +588,7 @@ ClientSessionData::clearCaches(bool locked)
       it.second.freeClassInfo(_persistentMemory);
 
    _romClassMap.clear();
+   _classByROMClassHashMap.clear();
 
    _classChainDataMap.clear();
    _constantPoolToClassMap.clear();
@@ -1282,6 +1330,15 @@ ClientSessionHT::findClientSession(uint64_t clientUID)
    return clientData;
    }
 
+// Search the clientSessionHashtable for the given clientUID and return the
+// data corresponding to the client without any side effects.
+// Must have compilation monitor in hand when calling this function.
+ClientSessionData *
+ClientSessionHT::peekClientSession(uint64_t clientUID) const
+   {
+   auto clientDataIt = _clientSessionMap.find(clientUID);
+   return (clientDataIt != _clientSessionMap.end()) ? clientDataIt->second : NULL;
+   }
 
 // Purge the old client session data from the hashtable and
 // update the timeOfLastPurge.
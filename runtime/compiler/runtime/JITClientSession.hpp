@@ -333,6 +333,8 @@ public:
       bool _isPortableRestoreMode;
       bool _isSnapshotModeEnabled;
       bool _isNonPortableRestoreMode;
+      // Share of the compilation time of the server requested by the client; see getSchedulingWeight()
+      int32_t _schedulingWeight;
       }; // struct VMInfo
 
    /**
@@ -368,6 +370,7 @@ public:
    PersistentUnorderedMap<ClassLoaderStringPair, TR_OpaqueClassBlock *> &getClassBySignatureMap() { return _classBySignatureMap; }
    PersistentUnorderedMap<J9Class *, ClassChainData> &getClassChainDataMap() { return _classChainDataMap; }
    PersistentUnorderedMap<J9ConstantPool *, TR_OpaqueClassBlock *> &getConstantPoolToClassMap() { return _constantPoolToClassMap; }
+   PersistentUnorderedMap<JITServerROMClassHash, J9Class *> &getClassByROMClassHashMap() { return _classByROMClassHashMap; }
    void initializeUnloadedClassAddrRanges(const std::vector<TR_AddressRange> &unloadedClassRanges, int32_t maxRanges);
    void processUnloadedClasses(const std::vector<TR_OpaqueClassBlock*> &classes, bool updateUnloadedClasses);
    void processIllegalFinalFieldModificationList(const std::vector<TR_OpaqueClassBlock*> &classes);
@@ -415,6 +418,25 @@ public:
    void decNumActiveThreads() { --_numActiveThreads; }
    void printStats();
 
+   // Fair scheduling of the requests of different clients, see TR::CompilationInfo::getNextOutOfProcessEntry()
+   // The following must be accessed with the compilation monitor in hand
+   static const int32_t MAX_SCHEDULING_WEIGHT = 100;
+   int32_t getSchedulingWeight() const { return _schedulingWeight; }
+   int64_t getSchedulingDeficit() const { return _schedulingDeficit; }
+   void setSchedulingDeficit(int64_t deficit) { _schedulingDeficit = deficit; }
+   uint64_t getSchedulingMark() const { return _schedulingMark; }
+   void setSchedulingMark(uint64_t mark) { _schedulingMark = mark; }
+   // Estimated cost of a request, charged to the deficit when the request is dequeued
+   uint64_t getAvgCompTimeUs() const { return _avgCompTimeUs; }
+   // Replace the estimated cost charged when the request was dequeued with the actual one
+   void settleSchedulingCharge(uint64_t chargedUs, uint64_t compTimeUs);
+   uint64_t getAvgQueueWaitTimeUs() const { return _avgQueueWaitTimeUs; }
+   void recordQueueWaitTime(uint64_t waitTimeUs);
+   // Connections of this client waiting in the compilation queue, whether or not they carry a request
+   uint32_t getNumQueuedConnections() const { return _numQueuedConnections; }
+   void incNumQueuedConnections() { ++_numQueuedConnections; }
+   void decNumQueuedConnections() { if (_numQueuedConnections > 0) --_numQueuedConnections; }
+
    void markForDeletion() { _markedForDeletion = true; }
    bool isMarkedForDeletion() const { return _markedForDeletion; }
 
@@ -529,6 +551,11 @@ private:
    PersistentUnorderedMap<J9Class *, ClassChainData> _classChainDataMap;
    //Constant pool to class map
    PersistentUnorderedMap<J9ConstantPool *, TR_OpaqueClassBlock *> _constantPoolToClassMap;
+   // Maps the ROMClass hashes to the classes of this client, for translating the IProfiler data
+   // aggregated across clients. Only populated when JITServerSharedProfileCache is used.
+   // A NULL value means that the client has several classes with the same ROMClass.
+   // Protected by _romMapMonitor.
+   PersistentUnorderedMap<JITServerROMClassHash, J9Class *> _classByROMClassHashMap;
    TR::Monitor *_romMapMonitor;
    TR::Monitor *_classMapMonitor;
    TR::Monitor *_classChainDataMapMonitor;
@@ -550,6 +577,12 @@ private:
                               // This is smaller or equal to _inUse because some threads
                               // could be just starting or waiting in _OOSequenceEntryList
    VMInfo *_vmInfo; // info specific to a client VM that does not change, NULL means not set
+   int32_t _schedulingWeight; // Copied from _vmInfo; 1 until the VMInfo is received
+   int64_t _schedulingDeficit; // us of compilation time this client can still use in the current round; can be negative
+   uint64_t _schedulingMark; // Last scheduling decision that looked at the queued requests of this client
+   uint64_t _avgCompTimeUs; // Moving average of the compilation time of the requests of this client
+   uint64_t _avgQueueWaitTimeUs; // Moving average of the time requests of this client waited in the compilation queue
+   uint32_t _numQueuedConnections; // Updated when the connections of this client are queued and dequeued
    bool _markedForDeletion; //Client Session is marked for deletion. When the inUse count will become zero this will be deleted.
    TR_AddressSet *_unloadedClassAddresses; // Per-client versions of the unloaded class and method addresses kept in J9PersistentInfo
    bool           _requestUnloadedClasses; // If true we need to request the current state of unloaded classes from the client
@@ -615,9 +648,11 @@ class ClientSessionHT
    ClientSessionData * findOrCreateClientSession(uint64_t clientUID, uint32_t seqNo, bool *newSessionWasCreated, J9JITConfig *jitConfig);
    bool deleteClientSession(uint64_t clientUID, bool forDeletion);
    ClientSessionData * findClientSession(uint64_t clientUID);
+   ClientSessionData * peekClientSession(uint64_t clientUID) const; // unlike findClientSession, does not mark the session in use
    void purgeOldDataIfNeeded();
    void printStats();
    uint32_t size() const { return _clientSessionMap.size(); }
+   const PersistentUnorderedMap<uint64_t, ClientSessionData*> &getClientSessionMap() const { return _clientSessionMap; }
 
    private:
    PersistentUnorderedMap<uint64_t, ClientSessionData*> _clientSessionMap;
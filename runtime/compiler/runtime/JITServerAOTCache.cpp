@@ -21,6 +21,10 @@
  *******************************************************************************/
 
 #include <cstdio> // for rename()
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "control/CompilationRuntime.hpp"
 #include "env/J9SegmentProvider.hpp"
 #include "env/StackMemoryRegion.hpp"
@@ -30,17 +34,21 @@
 #include "runtime/JITServerSharedROMClassCache.hpp"
 #include "net/CommunicationStream.hpp"
 
+// Maps the IDs of the records read from a snapshot to the records. It is kept for as long as
+// the snapshot is mapped, since cached AOT methods are read from the snapshot lazily.
 struct JITServerAOTCacheReadContext
    {
-   JITServerAOTCacheReadContext(const JITServerAOTCacheHeader &header, TR::StackMemoryRegion &stackMemoryRegion);
+   TR_PERSISTENT_ALLOC(TR_Memory::JITServerAOTCache)
 
-   Vector<AOTCacheClassLoaderRecord *> _classLoaderRecords;
-   Vector<AOTCacheClassRecord *> _classRecords;
-   Vector<AOTCacheMethodRecord *> _methodRecords;
-   Vector<AOTCacheClassChainRecord *> _classChainRecords;
-   Vector<AOTCacheWellKnownClassesRecord *> _wellKnownClassesRecords;
-   Vector<AOTCacheAOTHeaderRecord *> _aotHeaderRecords;
-   Vector<AOTCacheThunkRecord *> _thunkRecords;
+   JITServerAOTCacheReadContext(const JITServerAOTCacheHeader &header);
+
+   PersistentVector<AOTCacheClassLoaderRecord *> _classLoaderRecords;
+   PersistentVector<AOTCacheClassRecord *> _classRecords;
+   PersistentVector<AOTCacheMethodRecord *> _methodRecords;
+   PersistentVector<AOTCacheClassChainRecord *> _classChainRecords;
+   PersistentVector<AOTCacheWellKnownClassesRecord *> _wellKnownClassesRecords;
+   PersistentVector<AOTCacheAOTHeaderRecord *> _aotHeaderRecords;
+   PersistentVector<AOTCacheThunkRecord *> _thunkRecords;
    };
 
 size_t JITServerAOTCacheMap::_cacheMaxBytes = 300 * 1024 * 1024;
@@ -62,12 +70,16 @@ AOTCacheRecord::free(void *ptr)
    TR::Compiler->persistentGlobalMemory()->freePersistentMemory(ptr);
    }
 
-// Read a single AOT cache record R from a cache file
+// Total size of a serialized record, including its variable-length data
+static size_t recordSize(const AOTSerializationRecord &record) { return record.size(); }
+static size_t recordSize(const SerializedAOTMethod &record) { return record.size(); }
+
+// Read a single AOT cache record R from a cache snapshot in memory
 template<class R> R *
-AOTCacheRecord::readRecord(FILE *f, const JITServerAOTCacheReadContext &context)
+AOTCacheRecord::readRecord(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context)
    {
    typename R::SerializationRecord header;
-   if (1 != fread(&header, sizeof(header), 1, f))
+   if ((size_t)(end - cur) < sizeof(header))
       {
       if (TR::Options::getVerboseOption(TR_VerboseJITServer))
          TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Could not read %s record header", R::getRecordName());
@@ -81,21 +93,18 @@ AOTCacheRecord::readRecord(FILE *f, const JITServerAOTCacheReadContext &context)
       return NULL;
       }
 
-   R *record = new (AOTCacheRecord::allocate(R::size(header))) R(context, header);
-   memcpy((void *)record->dataAddr(), &header, sizeof(header));
-
-   size_t variableDataBytes = record->dataAddr()->size() - sizeof(header);
-   if (0 != variableDataBytes)
+   size_t size = recordSize(header);
+   if ((size < sizeof(header)) || (size > (size_t)(end - cur)) || (size > R::size(header)))
       {
-      if (1 != fread((uint8_t *)record->dataAddr() + sizeof(header), variableDataBytes, 1, f))
-         {
-         if (TR::Options::getVerboseOption(TR_VerboseJITServer))
-            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Unable to read variable part of %s record", R::getRecordName());
-         AOTCacheRecord::free(record);
-         return NULL;
-         }
+      if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+         TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Unable to read variable part of %s record", R::getRecordName());
+      return NULL;
       }
 
+   R *record = new (AOTCacheRecord::allocate(R::size(header))) R(context, header);
+   memcpy((void *)record->dataAddr(), cur, size);
+   cur += size;
+
    if (!record->setSubrecordPointers(context))
       {
       AOTCacheRecord::free(record);
@@ -263,7 +272,7 @@ AOTCacheListRecord<D, R, Args...>::subRecordsDo(const std::function<void(const A
    }
 
 template<class D, class R, typename... Args> bool
-AOTCacheListRecord<D, R, Args...>::setSubrecordPointers(const Vector<R *> &cacheRecords, const char *recordName, const char *subrecordName)
+AOTCacheListRecord<D, R, Args...>::setSubrecordPointers(const PersistentVector<R *> &cacheRecords, const char *recordName, const char *subrecordName)
    {
    for (size_t i = 0; i < data().list().length(); ++i)
       {
@@ -724,6 +733,12 @@ JITServerAOTCache::JITServerAOTCache(const std::string &name) :
    _cachedMethodHead(NULL),
    _cachedMethodTail(NULL),
    _cachedMethodMonitor(TR::Monitor::create("JIT-JITServerAOTCacheCachedMethodMonitor")),
+   _snapshot(NULL),
+   _snapshotSize(0),
+   _snapshotMethodsEnd(NULL),
+   _snapshotContext(NULL),
+   _snapshotMethodMap(decltype(_snapshotMethodMap)::allocator_type(TR::Compiler->persistentGlobalAllocator())),
+   _numMaterializedSnapshotMethods(0),
    _timePrevSaveOperation(0),
    _minNumAOTMethodsToSave(TR::Options::_aotCachePersistenceMinDeltaMethods),
    _saveOperationInProgress(false), // protected by the _cachedMethodMonitor
@@ -749,6 +764,14 @@ JITServerAOTCache::~JITServerAOTCache()
    freeMapValues(_thunkMap);
    freeMapValues(_cachedMethodMap);
 
+   if (_snapshotContext)
+      {
+      _snapshotContext->~JITServerAOTCacheReadContext();
+      TR::Compiler->persistentGlobalMemory()->freePersistentMemory(_snapshotContext);
+      }
+   if (_snapshot)
+      munmap((void *)_snapshot, _snapshotSize);
+
    TR::Monitor::destroy(_classMonitor);
    TR::Monitor::destroy(_classLoaderMonitor);
    TR::Monitor::destroy(_methodMonitor);
@@ -759,14 +782,15 @@ JITServerAOTCache::~JITServerAOTCache()
    TR::Monitor::destroy(_cachedMethodMonitor);
    }
 
-JITServerAOTCacheReadContext::JITServerAOTCacheReadContext(const JITServerAOTCacheHeader &header, TR::StackMemoryRegion &stackMemoryRegion) :
-   _classLoaderRecords(header._nextClassLoaderId, NULL, stackMemoryRegion),
-   _classRecords(header._nextClassId, NULL, stackMemoryRegion),
-   _methodRecords(header._nextMethodId, NULL, stackMemoryRegion),
-   _classChainRecords(header._nextClassChainId, NULL, stackMemoryRegion),
-   _wellKnownClassesRecords(header._nextWellKnownClassesId, NULL, stackMemoryRegion),
-   _aotHeaderRecords(header._nextAOTHeaderId, NULL, stackMemoryRegion),
-   _thunkRecords(header._nextThunkId, NULL, stackMemoryRegion)
+JITServerAOTCacheReadContext::JITServerAOTCacheReadContext(const JITServerAOTCacheHeader &header) :
+   _classLoaderRecords(header._nextClassLoaderId, NULL, decltype(_classLoaderRecords)::allocator_type(TR::Compiler->persistentGlobalAllocator())),
+   _classRecords(header._nextClassId, NULL, decltype(_classRecords)::allocator_type(TR::Compiler->persistentGlobalAllocator())),
+   _methodRecords(header._nextMethodId, NULL, decltype(_methodRecords)::allocator_type(TR::Compiler->persistentGlobalAllocator())),
+   _classChainRecords(header._nextClassChainId, NULL, decltype(_classChainRecords)::allocator_type(TR::Compiler->persistentGlobalAllocator())),
+   _wellKnownClassesRecords(header._nextWellKnownClassesId, NULL,
+                            decltype(_wellKnownClassesRecords)::allocator_type(TR::Compiler->persistentGlobalAllocator())),
+   _aotHeaderRecords(header._nextAOTHeaderId, NULL, decltype(_aotHeaderRecords)::allocator_type(TR::Compiler->persistentGlobalAllocator())),
+   _thunkRecords(header._nextThunkId, NULL, decltype(_thunkRecords)::allocator_type(TR::Compiler->persistentGlobalAllocator()))
    {
    }
 
@@ -1071,7 +1095,7 @@ JITServerAOTCache::storeMethod(const AOTCacheClassChainRecord *definingClassChai
       }
 
    auto it = _cachedMethodMap.find(key);
-   if (it != _cachedMethodMap.end())
+   if ((it != _cachedMethodMap.end()) || (_snapshotMethodMap.find(key) != _snapshotMethodMap.end()))
       {
       //NOTE: Current implementation keeps the first version of the method for this key in the cache.
       //      If we want to keep the most recent version instead, we will need to synchronize deleting
@@ -1108,14 +1132,66 @@ JITServerAOTCache::findMethod(const AOTCacheClassChainRecord *definingClassChain
    OMR::CriticalSection cs(_cachedMethodMonitor);
 
    auto it = _cachedMethodMap.find(key);
-   if (it == _cachedMethodMap.end())
+   if (it != _cachedMethodMap.end())
+      {
+      ++_numCacheHits;
+      return it->second;
+      }
+
+   // The method might be stored in the snapshot this cache was loaded from, but not read yet
+   auto snapshotIt = _snapshotMethodMap.find(key);
+   CachedAOTMethod *method = NULL;
+   if (snapshotIt != _snapshotMethodMap.end())
+      method = materializeSnapshotMethod(key, snapshotIt->second);
+   if (!method)
       {
       ++_numCacheMisses;
       return NULL;
       }
 
    ++_numCacheHits;
-   return it->second;
+   return method;
+   }
+
+CachedAOTMethod *
+JITServerAOTCache::materializeSnapshotMethod(const CachedMethodKey &key, const SnapshotMethod &snapshotMethod)
+   {
+   if (!JITServerAOTCacheMap::cacheHasSpace())
+      return NULL;
+
+   const uint8_t *cur = snapshotMethod._data;
+   CachedAOTMethod *method = AOTCacheRecord::readRecord<CachedAOTMethod>(cur, _snapshotMethodsEnd, *_snapshotContext);
+   if (!method)
+      return NULL;
+
+   // The method must match its entry in the index of the snapshot
+   if ((method->data().size() != snapshotMethod._size) ||
+       (method->definingClassChainRecord() != std::get<0>(key)) ||
+       (method->data().index() != std::get<1>(key)) ||
+       (method->data().optLevel() != std::get<2>(key)) ||
+       (_snapshotContext->_aotHeaderRecords[method->data().aotHeaderId()] != std::get<3>(key)))
+      {
+      if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+         TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache %s: Cached AOT method at offset %zu in the snapshot does not match its index entry",
+                                        _name.c_str(), (size_t)(snapshotMethod._data - _snapshot));
+      AOTCacheRecord::free(method);
+      return NULL;
+      }
+
+   // Materialized methods are not added to the traversal of the _cachedMethodMap,
+   // since they are written to the next snapshot from the mapped one
+   try
+      {
+      _cachedMethodMap.insert({ key, method });
+      }
+   catch (...)
+      {
+      AOTCacheRecord::free(method);
+      throw;
+      }
+   ++_numMaterializedSnapshotMethods;
+
+   return method;
    }
 
 
@@ -1173,7 +1249,7 @@ JITServerAOTCache::printStats(FILE *f) const
    {
    fprintf(f,
       "JITServer AOT cache %s statistics:\n"
-      "\tstored methods: %zu\n"
+      "\tstored methods: %zu (%zu in snapshot, %zu of them read)\n"
       "\tclass loader records: %zu\n"
       "\tclass records: %zu (%zu generated)\n"
       "\tmethod records: %zu\n"
@@ -1186,7 +1262,7 @@ JITServerAOTCache::printStats(FILE *f) const
       "\tdeserialized methods: %zu\n"
       "\tdeserialization failures: %zu\n",
       _name.c_str(),
-      _cachedMethodMap.size(),
+      numCachedMethods(), _snapshotMethodMap.size(), _numMaterializedSnapshotMethods,
       _classLoaderMap.size(),
       _classMap.size(), _numGeneratedClasses,
       _methodMap.size(),
@@ -1247,6 +1323,33 @@ writeCachedMethodList(FILE *f, const CachedAOTMethod *head, size_t numRecordsToW
    return true;
    }
 
+// Write the index entries of at most numRecordsToWrite methods from the linked list starting at head,
+// assuming that the methods were written to the stream in that order starting at the given offset.
+static bool
+writeCachedMethodIndex(FILE *f, const CachedAOTMethod *head, size_t numRecordsToWrite, size_t &offset)
+   {
+   const CachedAOTMethod *current = head;
+   size_t recordsWritten = 0;
+   while (current && (recordsWritten < numRecordsToWrite))
+      {
+      const SerializedAOTMethod &record = current->data();
+      JITServerAOTCacheMethodIndexEntry entry = { record.definingClassChainId(), record.aotHeaderId(), record.index(),
+                                                  (uint32_t)record.optLevel(), offset, record.size() };
+      if (1 != fwrite(&entry, sizeof(entry), 1, f))
+         {
+         if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Unable to write method index entry to cache file");
+         return false;
+         }
+      offset += record.size();
+      ++recordsWritten;
+      current = current->getNextRecord();
+      }
+   TR_ASSERT(recordsWritten == numRecordsToWrite, "Expected to write %zu records, wrote %zu", numRecordsToWrite, recordsWritten);
+
+   return true;
+   }
+
 static void getCurrentAOTCacheVersion(JITServerAOTCacheVersion &version)
    {
    memcpy(version._eyeCatcher, JITSERVER_AOTCACHE_EYECATCHER, JITSERVER_AOTCACHE_EYECATCHER_LENGTH);
@@ -1259,7 +1362,8 @@ static void getCurrentAOTCacheVersion(JITServerAOTCacheVersion &version)
 // record traversal is written directly to the stream in sections, since the full AOT record
 // can be reconstructed from only this information. These sections are ordered so that, when
 // reading the snapshot, the dependencies of each record will already have been read by the
-// time we get to that record.
+// time we get to that record. The snapshot ends with an index of the cached AOT methods, so
+// that they do not have to be read until they are used (see mapCache()).
 // Return the number of AOT methods written to the snapshot or 0 on failure.
 size_t
 JITServerAOTCache::writeCache(FILE *f) const
@@ -1271,9 +1375,11 @@ JITServerAOTCache::writeCache(FILE *f) const
    // It is possible for a record and its dependencies to be added between .size() calls,
    // so we must reverse the order in which we read the map sizes (compared to their write order)
    // to ensure that those dependencies are not excluded from serialization.
+   size_t numNewCachedMethods = 0;
       {
       OMR::CriticalSection cs(_cachedMethodMonitor);
-      header._numCachedAOTMethods = _cachedMethodMap.size();
+      numNewCachedMethods = _cachedMethodMap.size() - _numMaterializedSnapshotMethods;
+      header._numCachedAOTMethods = numNewCachedMethods + _snapshotMethodMap.size();
       }
    if (header._numCachedAOTMethods == 0)
       {
@@ -1337,8 +1443,53 @@ JITServerAOTCache::writeCache(FILE *f) const
       return 0;
    if (!writeRecordList(f, _thunkHead, header._numThunkRecords))
       return 0;
-   if (!writeCachedMethodList(f, _cachedMethodHead, header._numCachedAOTMethods))
+
+   // The cached AOT methods of the snapshot this cache was loaded from are copied from the
+   // mapped snapshot, followed by the methods added to the cache since it was loaded
+   long methodsOffset = ftell(f);
+   if (methodsOffset < 0)
       return 0;
+   for (auto &kv : _snapshotMethodMap)
+      {
+      if (1 != fwrite(kv.second._data, kv.second._size, 1, f))
+         {
+         if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Unable to write record to cache file");
+         return 0;
+         }
+      }
+   if (!writeCachedMethodList(f, _cachedMethodHead, numNewCachedMethods))
+      return 0;
+
+   // Write the index of the cached AOT methods in the same order,
+   // then the header again now that the offset of the index is known
+   long indexOffset = ftell(f);
+   if (indexOffset < 0)
+      return 0;
+   header._cachedAOTMethodIndexOffset = indexOffset;
+
+   size_t offset = methodsOffset;
+   for (auto &kv : _snapshotMethodMap)
+      {
+      JITServerAOTCacheMethodIndexEntry entry = { std::get<0>(kv.first)->data().id(), std::get<3>(kv.first)->data().id(),
+                                                  std::get<1>(kv.first), (uint32_t)std::get<2>(kv.first), offset, kv.second._size };
+      if (1 != fwrite(&entry, sizeof(entry), 1, f))
+         {
+         if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Unable to write method index entry to cache file");
+         return 0;
+         }
+      offset += kv.second._size;
+      }
+   if (!writeCachedMethodIndex(f, _cachedMethodHead, numNewCachedMethods, offset))
+      return 0;
+
+   if ((0 != fseek(f, 0, SEEK_SET)) || (1 != fwrite(&header, sizeof(JITServerAOTCacheHeader), 1, f)))
+      {
+      if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+         TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Unable to write cache file header");
+      return 0;
+      }
 
    return header._numCachedAOTMethods;
    }
@@ -1355,26 +1506,51 @@ isCompatibleSnapshotVersion(const JITServerAOTCacheVersion &version)
           (version._jitserverVersion == currentVersion._jitserverVersion);
    }
 
-// Read an AOT cache snapshot, returning NULL if the cache is ill-formed or
-// incompatible with the running server.
+// Map an AOT cache snapshot into memory and load it, returning NULL if the cache is ill-formed
+// or incompatible with the running server. The snapshot stays mapped for the lifetime of
+// the cache. Note that the snapshot file is never modified in place: newer snapshots are
+// written to a temporary file which is then renamed, so the mapping is not affected.
 JITServerAOTCache *
-JITServerAOTCache::readCache(FILE *f, const std::string &name, TR_Memory &trMemory)
+JITServerAOTCache::mapCache(const std::string &fileName, const std::string &name)
    {
    if (!JITServerAOTCacheMap::cacheHasSpace())
       return NULL;
 
-   JITServerAOTCacheHeader header = {0};
-   if (1 != fread(&header, sizeof(JITServerAOTCacheHeader), 1, f))
+   int fd = open(fileName.c_str(), O_RDONLY);
+   if (fd < 0)
+      {
+      if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+         TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Failed to open cache file %s: %s", fileName.c_str(), strerror(errno));
+      return NULL;
+      }
+
+   struct stat fileStat;
+   if ((0 != fstat(fd, &fileStat)) || (fileStat.st_size < (off_t)sizeof(JITServerAOTCacheHeader)))
       {
       if (TR::Options::getVerboseOption(TR_VerboseJITServer))
          TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Unable to read cache file header");
+      close(fd);
+      return NULL;
+      }
+
+   size_t snapshotSize = fileStat.st_size;
+   void *snapshot = mmap(NULL, snapshotSize, PROT_READ, MAP_PRIVATE, fd, 0);
+   if (MAP_FAILED == snapshot)
+      {
+      if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+         TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Failed to map cache file %s: %s", fileName.c_str(), strerror(errno));
+      close(fd);
       return NULL;
       }
+   close(fd); // The mapping stays valid after the file is closed
 
+   JITServerAOTCacheHeader header = {0};
+   memcpy(&header, snapshot, sizeof(JITServerAOTCacheHeader));
    if (!isCompatibleSnapshotVersion(header._version))
       {
       if (TR::Options::getVerboseOption(TR_VerboseJITServer))
          TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Cache file header incompatible with running server");
+      munmap(snapshot, snapshotSize);
       return NULL;
       }
 
@@ -1395,13 +1571,18 @@ JITServerAOTCache::readCache(FILE *f, const std::string &name, TR_Memory &trMemo
       {
       if (TR::Options::getVerboseOption(TR_VerboseJITServer))
          TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Unable to allocate new cache for reading");
+      munmap(snapshot, snapshotSize);
       return NULL;
       }
 
+   // From now on the snapshot is unmapped by the cache destructor
+   cache->_snapshot = (const uint8_t *)snapshot;
+   cache->_snapshotSize = snapshotSize;
+
    bool readSuccess = false;
    try
       {
-      readSuccess = cache->readCache(f, header, trMemory);
+      readSuccess = cache->readCache(header);
       }
    catch (const std::exception &e)
       {
@@ -1421,23 +1602,24 @@ JITServerAOTCache::readCache(FILE *f, const std::string &name, TR_Memory &trMemo
    return cache;
    }
 
-// Read numRecordsToRead records of an AOTSerializationRecord subclass V from a stream, also
-// updating the map, record traversal, and scratch Vector associated with V.
+// Read numRecordsToRead records of an AOTSerializationRecord subclass V from a snapshot in memory,
+// also updating the map, record traversal, and ID to record mapping associated with V.
 template<typename K, typename V, typename H> bool
-JITServerAOTCache::readRecords(FILE *f,
+JITServerAOTCache::readRecords(const uint8_t *&cur,
+                               const uint8_t *end,
                                JITServerAOTCacheReadContext &context,
                                size_t numRecordsToRead,
                                PersistentUnorderedMap<K, V *, H> &map,
                                V *&traversalHead,
                                V *&traversalTail,
-                               Vector<V *> &records)
+                               PersistentVector<V *> &records)
    {
    for (size_t i = 0; i < numRecordsToRead; ++i)
       {
       if (!JITServerAOTCacheMap::cacheHasSpace())
          return false;
 
-      V *record = AOTCacheRecord::readRecord<V>(f, context);
+      V *record = AOTCacheRecord::readRecord<V>(cur, end, context);
       if (!record)
          return false;
 
@@ -1459,7 +1641,7 @@ JITServerAOTCache::readRecords(FILE *f,
    }
 
 bool
-JITServerAOTCache::readCache(FILE *f, const JITServerAOTCacheHeader &header, TR_Memory &trMemory)
+JITServerAOTCache::readCache(const JITServerAOTCacheHeader &header)
    {
    _classLoaderMap.reserve(header._numClassLoaderRecords);
    _classMap.reserve(header._numClassRecords);
@@ -1468,7 +1650,7 @@ JITServerAOTCache::readCache(FILE *f, const JITServerAOTCacheHeader &header, TR_
    _wellKnownClassesMap.reserve(header._numWellKnownClassesRecords);
    _aotHeaderMap.reserve(header._numAOTHeaderRecords);
    _thunkMap.reserve(header._numThunkRecords);
-   _cachedMethodMap.reserve(header._numCachedAOTMethods);
+   _snapshotMethodMap.reserve(header._numCachedAOTMethods);
 
    _nextClassLoaderId = header._nextClassLoaderId;
    _nextClassId = header._nextClassId;
@@ -1478,42 +1660,69 @@ JITServerAOTCache::readCache(FILE *f, const JITServerAOTCacheHeader &header, TR_
    _nextAOTHeaderId = header._nextAOTHeaderId;
    _nextThunkId = header._nextThunkId;
 
-   TR::StackMemoryRegion stackMemoryRegion(trMemory);
-   JITServerAOTCacheReadContext context(header, stackMemoryRegion);
+   // The index of the cached AOT methods follows the methods, which follow all the other records
+   size_t indexOffset = header._cachedAOTMethodIndexOffset;
+   if ((indexOffset < sizeof(JITServerAOTCacheHeader)) || (indexOffset > _snapshotSize) ||
+       (0 != indexOffset % sizeof(size_t)) ||
+       (header._numCachedAOTMethods > (_snapshotSize - indexOffset) / sizeof(JITServerAOTCacheMethodIndexEntry)))
+      {
+      if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+         TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Invalid cached AOT method index in cache file");
+      return false;
+      }
+   _snapshotMethodsEnd = _snapshot + indexOffset;
 
-   if (!readRecords(f, context, header._numClassLoaderRecords, _classLoaderMap, _classLoaderHead, _classLoaderTail, context._classLoaderRecords))
+   _snapshotContext = new (TR::Compiler->persistentGlobalMemory()) JITServerAOTCacheReadContext(header);
+   JITServerAOTCacheReadContext &context = *_snapshotContext;
+
+   const uint8_t *cur = _snapshot + sizeof(JITServerAOTCacheHeader);
+   const uint8_t *end = _snapshotMethodsEnd;
+   if (!readRecords(cur, end, context, header._numClassLoaderRecords, _classLoaderMap, _classLoaderHead, _classLoaderTail, context._classLoaderRecords))
       return false;
-   if (!readRecords(f, context, header._numClassRecords, _classMap, _classHead, _classTail, context._classRecords))
+   if (!readRecords(cur, end, context, header._numClassRecords, _classMap, _classHead, _classTail, context._classRecords))
       return false;
-   if (!readRecords(f, context, header._numMethodRecords, _methodMap, _methodHead, _methodTail, context._methodRecords))
+   if (!readRecords(cur, end, context, header._numMethodRecords, _methodMap, _methodHead, _methodTail, context._methodRecords))
       return false;
-   if (!readRecords(f, context, header._numClassChainRecords, _classChainMap, _classChainHead, _classChainTail, context._classChainRecords))
+   if (!readRecords(cur, end, context, header._numClassChainRecords, _classChainMap, _classChainHead, _classChainTail, context._classChainRecords))
       return false;
-   if (!readRecords(f, context, header._numWellKnownClassesRecords, _wellKnownClassesMap, _wellKnownClassesHead,
+   if (!readRecords(cur, end, context, header._numWellKnownClassesRecords, _wellKnownClassesMap, _wellKnownClassesHead,
                     _wellKnownClassesTail, context._wellKnownClassesRecords))
       return false;
-   if (!readRecords(f, context, header._numAOTHeaderRecords, _aotHeaderMap, _aotHeaderHead, _aotHeaderTail, context._aotHeaderRecords))
+   if (!readRecords(cur, end, context, header._numAOTHeaderRecords, _aotHeaderMap, _aotHeaderHead, _aotHeaderTail, context._aotHeaderRecords))
       return false;
-   if (!readRecords(f, context, header._numThunkRecords, _thunkMap, _thunkHead, _thunkTail, context._thunkRecords))
+   if (!readRecords(cur, end, context, header._numThunkRecords, _thunkMap, _thunkHead, _thunkTail, context._thunkRecords))
       return false;
 
-   for (size_t i = 0; i < header._numCachedAOTMethods; ++i)
-      {
-      if (!JITServerAOTCacheMap::cacheHasSpace())
-         return false;
-
-      auto record = AOTCacheRecord::readRecord<CachedAOTMethod>(f, context);
-      if (!record)
+   // Only the index is read for the cached AOT methods; each method is read from the snapshot when first looked up
+   size_t methodsOffset = cur - _snapshot;
+   const uint8_t *indexEntry = _snapshotMethodsEnd;
+   for (size_t i = 0; i < header._numCachedAOTMethods; ++i, indexEntry += sizeof(JITServerAOTCacheMethodIndexEntry))
+      {
+      JITServerAOTCacheMethodIndexEntry entry;
+      memcpy(&entry, indexEntry, sizeof(entry));
+
+      if ((entry._offset < methodsOffset) || (entry._offset > indexOffset) ||
+          (entry._size < sizeof(SerializedAOTMethod)) || (entry._size > indexOffset - entry._offset) ||
+          (entry._optLevel >= (uint32_t)TR_Hotness::numHotnessLevels) ||
+          (entry._definingClassChainId >= context._classChainRecords.size()) ||
+          !context._classChainRecords[entry._definingClassChainId] ||
+          (entry._aotHeaderId >= context._aotHeaderRecords.size()) ||
+          !context._aotHeaderRecords[entry._aotHeaderId])
+         {
+         if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Invalid cached AOT method index entry %zu", i);
          return false;
+         }
 
-      CachedMethodKey key(record->definingClassChainRecord(),
-                          record->data().index(),
-                          record->data().optLevel(),
-                          context._aotHeaderRecords[record->data().aotHeaderId()]);
-
-      if (!addToMap(_cachedMethodMap, _cachedMethodHead, _cachedMethodTail, key, record))
+      CachedMethodKey key(context._classChainRecords[entry._definingClassChainId],
+                          entry._index,
+                          (TR_Hotness)entry._optLevel,
+                          context._aotHeaderRecords[entry._aotHeaderId]);
+      SnapshotMethod snapshotMethod = { _snapshot + entry._offset, entry._size };
+      if (!_snapshotMethodMap.insert({ key, snapshotMethod }).second)
          {
-         AOTCacheRecord::free(record);
+         if (TR::Options::getVerboseOption(TR_VerboseJITServer))
+            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Duplicate cached AOT method index entry %zu", i);
          return false;
          }
       }
@@ -1526,7 +1735,7 @@ size_t
 JITServerAOTCache::getNumCachedMethods() const
    {
    OMR::CriticalSection cs(_cachedMethodMonitor);
-   return _cachedMethodMap.size();
+   return numCachedMethods();
    }
 
 
@@ -1542,7 +1751,7 @@ JITServerAOTCache::triggerAOTCacheStoreToFileIfNeeded()
          return false;
 
       // Check whether enough new methods were added to the in-memory cache to be worth attempting a save operation
-      if (_cachedMethodMap.size() < _minNumAOTMethodsToSave)
+      if (numCachedMethods() < _minNumAOTMethodsToSave)
          return false;
 
       // Prevent saving to file too often; wait some time between consecutive saves
@@ -1855,7 +2064,7 @@ JITServerAOTCacheMap::saveNextQueuedAOTCacheToFile()
 
 
 void
-JITServerAOTCacheMap::loadNextQueuedAOTCacheFromFile(J9::J9SegmentProvider &scratchSegmentProvider)
+JITServerAOTCacheMap::loadNextQueuedAOTCacheFromFile()
    {
    std::string cacheName;
       {
@@ -1871,51 +2080,32 @@ JITServerAOTCacheMap::loadNextQueuedAOTCacheFromFile(J9::J9SegmentProvider &scra
       }
 
    JITServerAOTCache *cache = NULL;
-   FILE *cacheFile = NULL;
    try
       {
       TR::CompilationInfo *compInfo = TR::CompilationInfo::get();
       std::string cacheFileName = buildCacheFileName(compInfo->getPersistentInfo()->getJITServerAOTCacheDir(), cacheName);
 
-      // Open the AOT cache file and create a new JITServerAOTCache object
-      FILE *cacheFile = fopen(cacheFileName.c_str(), "rb");
-      if (cacheFile)
+      // Map the AOT cache file and create a new JITServerAOTCache object
+      cache = JITServerAOTCache::mapCache(cacheFileName, cacheName); // This should not throw
+      if (cache)
          {
          if (TR::Options::getVerboseOption(TR_VerboseJITServer))
-            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: t=%llu Opened file %s to load cache '%s' from file",
-                                           compInfo->getPersistentInfo()->getElapsedTime(), cacheFileName.c_str(), cacheName.c_str());
-         size_t segmentSize = scratchSegmentProvider.getPreferredSegmentSize();
-         if (!segmentSize)
-            segmentSize = 1 << 24/*16 MB*/;
-         TR::RawAllocator rawAllocator(compInfo->getJITConfig()->javaVM);
-         J9::SystemSegmentProvider segmentProvider(1 << 16/*64 KB*/, segmentSize, TR::Options::getScratchSpaceLimit(), scratchSegmentProvider, rawAllocator);
-         TR::Region region(segmentProvider, rawAllocator);
-         TR_Memory trMemory(*compInfo->persistentMemory(), region);
+            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: t=%llu Mapped file %s to load cache '%s' with %zu methods",
+                                           compInfo->getPersistentInfo()->getElapsedTime(), cacheFileName.c_str(), cacheName.c_str(),
+                                           cache->getNumCachedMethods());
 
-         cache = JITServerAOTCache::readCache(cacheFile, cacheName, trMemory); // This should not throw
-         fclose(cacheFile); // filestream not needed anymore
-         cacheFile = NULL;
+         // Update the number of AOT methods needed to be eligible for a save operation
+         // No monitor is needed because no other thread knows about this cache yet
+         cache->setMinNumAOTMethodsToSave(cache->getNumCachedMethods() + TR::Options::_aotCachePersistenceMinDeltaMethods);
 
-         if (cache)
-            {
-            // Update the number of AOT methods needed to be eligible for a save operation
-            // No monitor is needed because no other thread knows about this cache yet
-            cache->setMinNumAOTMethodsToSave(cache->getNumCachedMethods() + TR::Options::_aotCachePersistenceMinDeltaMethods);
-
-            // My JITServerAOTCache was created and populated; now, insert it into the map
-            OMR::CriticalSection cs(_monitor);
-            _map.insert(std::make_pair(cacheName, cache));
-            }
-         else // Failed to create the AOT cache from file
-            {
-            if (TR::Options::getVerboseOption(TR_VerboseJITServer))
-               TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Failed to create cache '%s' from file", cacheName.c_str());
-            }
+         // My JITServerAOTCache was created and populated; now, insert it into the map
+         OMR::CriticalSection cs(_monitor);
+         _map.insert(std::make_pair(cacheName, cache));
          }
-      else // Cannot open the AOT cache file
+      else // Failed to create the AOT cache from file
          {
          if (TR::Options::getVerboseOption(TR_VerboseJITServer))
-            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Failed to open cache file %s: %s", cacheFileName.c_str(), strerror(errno));
+            TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: Failed to create cache '%s' from file", cacheName.c_str());
          }
       }
    catch(const std::exception& e)
@@ -1924,11 +2114,6 @@ JITServerAOTCacheMap::loadNextQueuedAOTCacheFromFile(J9::J9SegmentProvider &scra
          {
          TR_VerboseLog::writeLineLocked(TR_Vlog_JITServer, "AOT cache: exception caught when trying to read-in cache '%s': %s", cacheName.c_str(), e.what());
          }
-      if (cacheFile)
-         {
-         fclose(cacheFile);
-         cacheFile = NULL;
-         }
       if (cache)
          {
          cache->~JITServerAOTCache();
@@ -30,7 +30,7 @@
 #include "env/SystemSegmentProvider.hpp"
 #include "runtime/JITServerAOTSerializationRecords.hpp"
 
-static const uint32_t JITSERVER_AOTCACHE_VERSION = 1;
+static const uint32_t JITSERVER_AOTCACHE_VERSION = 2;
 static const char JITSERVER_AOTCACHE_EYECATCHER[] = "AOTCACHE";
 // the eye-catcher is not null-terminated in the snapshot files
 static const size_t JITSERVER_AOTCACHE_EYECATCHER_LENGTH = sizeof(JITSERVER_AOTCACHE_EYECATCHER) - 1;
@@ -67,6 +67,20 @@ struct JITServerAOTCacheHeader
    size_t _nextWellKnownClassesId;
    size_t _nextAOTHeaderId;
    size_t _nextThunkId;
+   size_t _cachedAOTMethodIndexOffset; // Offset of the index of cached AOT methods in the snapshot
+   };
+
+// An entry of the index of cached AOT methods stored at the end of an AOT cache snapshot.
+// The index is all that is read from the snapshot for the cached AOT methods when it is
+// loaded; each method is only read from the (memory-mapped) snapshot when first looked up.
+struct JITServerAOTCacheMethodIndexEntry
+   {
+   uintptr_t _definingClassChainId;
+   uintptr_t _aotHeaderId;
+   uint32_t _index;
+   uint32_t _optLevel;
+   size_t _offset; // Offset of the SerializedAOTMethod in the snapshot
+   size_t _size;
    };
 
 struct AOTCacheClassLoaderRecord;
@@ -114,7 +128,8 @@ public:
    static void *allocate(size_t size);
    static void free(void *ptr);
 
-   template<class R> static R *readRecord(FILE *f, const JITServerAOTCacheReadContext &context);
+   // Read a single record R from a snapshot in memory, advancing cur past the record
+   template<class R> static R *readRecord(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context);
 
    AOTCacheRecord *getNextRecord() const { return _nextRecord; }
    void setNextRecord(AOTCacheRecord *record) { _nextRecord = record; }
@@ -143,7 +158,7 @@ public:
 private:
    using SerializationRecord = ClassLoaderSerializationRecord;
 
-   friend AOTCacheClassLoaderRecord *AOTCacheRecord::readRecord<>(FILE *f, const JITServerAOTCacheReadContext &context);
+   friend AOTCacheClassLoaderRecord *AOTCacheRecord::readRecord<>(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context);
 
    AOTCacheClassLoaderRecord(uintptr_t id, const uint8_t *name, size_t nameLength);
    AOTCacheClassLoaderRecord(const JITServerAOTCacheReadContext &context, const ClassLoaderSerializationRecord &header) {}
@@ -177,7 +192,7 @@ public:
 private:
    using SerializationRecord = ClassSerializationRecord;
 
-   friend AOTCacheClassRecord *AOTCacheRecord::readRecord<>(FILE *f, const JITServerAOTCacheReadContext &context);
+   friend AOTCacheClassRecord *AOTCacheRecord::readRecord<>(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context);
 
    AOTCacheClassRecord(uintptr_t id, const AOTCacheClassLoaderRecord *classLoaderRecord, const JITServerROMClassHash &hash,
                        uint32_t romClassSize, bool generated, const J9ROMClass *romClass,
@@ -210,7 +225,7 @@ public:
 private:
    using SerializationRecord = MethodSerializationRecord;
 
-   friend AOTCacheMethodRecord *AOTCacheRecord::readRecord<>(FILE *f, const JITServerAOTCacheReadContext &context);
+   friend AOTCacheMethodRecord *AOTCacheRecord::readRecord<>(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context);
 
    AOTCacheMethodRecord(uintptr_t id, const AOTCacheClassRecord *definingClassRecord, uint32_t index);
    AOTCacheMethodRecord(const JITServerAOTCacheReadContext &context, const MethodSerializationRecord &header);
@@ -248,7 +263,7 @@ protected:
 
    static size_t size(const D &header) { return size(header.list().length()); }
 
-   bool setSubrecordPointers(const Vector<R *> &cacheRecords, const char *recordName, const char *subrecordName);
+   bool setSubrecordPointers(const PersistentVector<R *> &cacheRecords, const char *recordName, const char *subrecordName);
 
    // Layout: struct D header, uintptr_t ids[length], const R *records[length]
    D _data;
@@ -267,7 +282,7 @@ public:
 private:
    using SerializationRecord = ClassChainSerializationRecord;
 
-   friend AOTCacheClassChainRecord *AOTCacheRecord::readRecord<>(FILE *f, const JITServerAOTCacheReadContext &context);
+   friend AOTCacheClassChainRecord *AOTCacheRecord::readRecord<>(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context);
 
    bool setSubrecordPointers(const JITServerAOTCacheReadContext &context) override;
 
@@ -286,7 +301,7 @@ public:
 private:
    using SerializationRecord = WellKnownClassesSerializationRecord;
 
-   friend AOTCacheWellKnownClassesRecord *AOTCacheRecord::readRecord<>(FILE *f, const JITServerAOTCacheReadContext &context);
+   friend AOTCacheWellKnownClassesRecord *AOTCacheRecord::readRecord<>(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context);
 
    bool setSubrecordPointers(const JITServerAOTCacheReadContext &context) override;
 
@@ -306,7 +321,7 @@ public:
 private:
    using SerializationRecord = AOTHeaderSerializationRecord;
 
-   friend AOTCacheAOTHeaderRecord *AOTCacheRecord::readRecord<>(FILE *f, const JITServerAOTCacheReadContext &context);
+   friend AOTCacheAOTHeaderRecord *AOTCacheRecord::readRecord<>(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context);
 
    AOTCacheAOTHeaderRecord(uintptr_t id, const TR_AOTHeader *header);
    AOTCacheAOTHeaderRecord(const JITServerAOTCacheReadContext &context, const AOTHeaderSerializationRecord &header) {}
@@ -329,7 +344,7 @@ public:
 private:
    using SerializationRecord = ThunkSerializationRecord;
 
-   friend AOTCacheThunkRecord *AOTCacheRecord::readRecord<>(FILE *f, const JITServerAOTCacheReadContext &context);
+   friend AOTCacheThunkRecord *AOTCacheRecord::readRecord<>(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context);
 
    AOTCacheThunkRecord(uintptr_t id, const uint8_t *signature, uint32_t signatureSize, const uint8_t *thunkStart, uint32_t thunkSize);
    AOTCacheThunkRecord(const JITServerAOTCacheReadContext &context, const ThunkSerializationRecord &header) {}
@@ -373,7 +388,7 @@ public:
 private:
    using SerializationRecord = SerializedAOTMethod;
 
-   friend CachedAOTMethod *AOTCacheRecord::readRecord<>(FILE *f, const JITServerAOTCacheReadContext &context);
+   friend CachedAOTMethod *AOTCacheRecord::readRecord<>(const uint8_t *&cur, const uint8_t *end, const JITServerAOTCacheReadContext &context);
 
    CachedAOTMethod(const AOTCacheClassChainRecord *definingClassChainRecord, uint32_t index,
                    TR_Hotness optLevel, const AOTCacheAOTHeaderRecord *aotHeaderRecord,
@@ -471,7 +486,8 @@ public:
    void printStats(FILE *f) const;
 
    size_t writeCache(FILE *f) const;
-   static JITServerAOTCache *readCache(FILE *f, const std::string &name, TR_Memory &trMemory);
+   // Load a cache from the snapshot in the given file, which stays mapped into memory for the lifetime of the cache
+   static JITServerAOTCache *mapCache(const std::string &fileName, const std::string &name);
    size_t getNumCachedMethods() const;
    void setMinNumAOTMethodsToSave(size_t num) { _minNumAOTMethodsToSave = num; }
 
@@ -576,12 +592,25 @@ private:
    // Helper method used in getSerializationRecords()
    void addRecord(const AOTCacheRecord *record, Vector<const AOTSerializationRecord *> &result,
                   UnorderedSet<const AOTCacheRecord *> &newRecords, const KnownIdSet &knownIds) const;
-   // Read a cache snapshot into an empty cache
-   bool readCache(FILE *f, const JITServerAOTCacheHeader &header, TR_Memory &trMemory);
+   // Read the cache snapshot mapped at _snapshot into an empty cache
+   bool readCache(const JITServerAOTCacheHeader &header);
 
    template<typename K, typename V, typename H>
-   static bool readRecords(FILE *f, JITServerAOTCacheReadContext &context, size_t numRecordsToRead,
-                           PersistentUnorderedMap<K, V *, H> &map, V *&traversalHead, V *&traversalTail, Vector<V *> &records);
+   static bool readRecords(const uint8_t *&cur, const uint8_t *end, JITServerAOTCacheReadContext &context, size_t numRecordsToRead,
+                           PersistentUnorderedMap<K, V *, H> &map, V *&traversalHead, V *&traversalTail, PersistentVector<V *> &records);
+
+   // A cached AOT method that is stored in the mapped snapshot and has not necessarily been read yet
+   struct SnapshotMethod
+      {
+      const uint8_t *_data;
+      size_t _size;
+      };
+
+   // Read a cached AOT method from the mapped snapshot. Must hold the _cachedMethodMonitor.
+   CachedAOTMethod *materializeSnapshotMethod(const CachedMethodKey &key, const SnapshotMethod &snapshotMethod);
+   // Number of cached AOT methods, including the ones not read from the snapshot yet. Must hold the _cachedMethodMonitor.
+   size_t numCachedMethods() const
+      { return _cachedMethodMap.size() - _numMaterializedSnapshotMethods + _snapshotMethodMap.size(); }
 
    const std::string _name;
 
@@ -635,6 +664,17 @@ private:
    CachedAOTMethod *_cachedMethodTail;
    TR::Monitor *const _cachedMethodMonitor;
 
+   // The snapshot this cache was loaded from, if any, stays mapped into memory. The cached AOT methods
+   // it contains are only read when first looked up, at which point they are added to the _cachedMethodMap
+   // (but not to its traversal, which only contains the methods added after the snapshot was loaded).
+   // The _snapshotMethodMap is not modified after the snapshot is loaded.
+   const uint8_t *_snapshot;
+   size_t _snapshotSize;
+   const uint8_t *_snapshotMethodsEnd;
+   JITServerAOTCacheReadContext *_snapshotContext; // Maps the IDs of the records in the snapshot to the records
+   PersistentUnorderedMap<CachedMethodKey, SnapshotMethod> _snapshotMethodMap;
+   size_t _numMaterializedSnapshotMethods;
+
    uint64_t _timePrevSaveOperation;   // Millis when this cache was last saved to file
    size_t _minNumAOTMethodsToSave;    // Minimum number of AOT methods present in the cache before considering a save operation
    bool _saveOperationInProgress;     // True if an AOTCache save operation is in progress
@@ -676,7 +716,7 @@ public:
       Any exceptions thrown by this method are caught and logged.
       This method acquires the AOTCacheMap monitor.
    */
-   void loadNextQueuedAOTCacheFromFile(J9::J9SegmentProvider &scratchSegmentProvider);
+   void loadNextQueuedAOTCacheFromFile();
 
    /**
       @brief Obtain a pointer to a named AOT cache. If it doesn't exist, attempt to create one.
@@ -25,6 +25,7 @@
 #include "control/JITServerCompilationThread.hpp"
 #include "env/j9methodServer.hpp"
 #include "runtime/JITClientSession.hpp"
+#include "runtime/JITServerSharedProfileCache.hpp"
 #include "infra/CriticalSection.hpp" // for OMR::CriticalSection
 #include "ilgen/J9ByteCode.hpp"
 #include "ilgen/J9ByteCodeIterator.hpp"
@@ -47,7 +48,8 @@ JITServerIProfiler::allocate(J9JITConfig *jitConfig)
 
 JITServerIProfiler::JITServerIProfiler(J9JITConfig *jitConfig)
    : TR_IProfiler(jitConfig), _statsIProfilerInfoFromCache(0), _statsIProfilerInfoMsgToClient(0),
-   _statsIProfilerInfoReqNotCacheable(0), _statsIProfilerInfoIsEmpty(0), _statsIProfilerInfoCachingFailures(0)
+   _statsIProfilerInfoReqNotCacheable(0), _statsIProfilerInfoIsEmpty(0), _statsIProfilerInfoCachingFailures(0),
+   _statsIProfilerInfoFromSharedProfileCache(0)
    {
    _useCaching = feGetEnv("TR_DisableIPCaching") ? false: true;
    }
@@ -216,7 +218,9 @@ JITServerIProfiler::profilingSample(TR_OpaqueMethodBlock *method, uint32_t byteC
          TR_IPBCDataStorageHeader *clientData = ipdata.empty() ? NULL : (TR_IPBCDataStorageHeader *)ipdata.data();
          bool isMethodBeingCompiled = (method == comp->getMethodBeingCompiled()->getPersistentIdentifier());
 
-         if (!clientData && entry)
+         // Entries filled in from the data aggregated across clients have no counterpart at the client
+         bool isAggregatedEntry = entry && entry->isAggregatedEntry();
+         if (!clientData && entry && !isAggregatedEntry)
             {
             uint8_t bytecode = *(uint8_t *)(methodStart + byteCodeIndex);
             fprintf(stderr, "Error cached IP data for method %p bcIndex %u bytecode=%x: ipdata is empty but we have a cached entry=%p\n",
@@ -233,7 +237,8 @@ JITServerIProfiler::profilingSample(TR_OpaqueMethodBlock *method, uint32_t byteC
                   isCompiledWhenProfiling = it->second._isCompiledWhenProfiling;
                   }
                }
-         validateCachedIPEntry(entry, clientData, methodStart, isMethodBeingCompiled, method, entryFromPerCompilationCache, isCompiledWhenProfiling);
+         if (!isAggregatedEntry)
+            validateCachedIPEntry(entry, clientData, methodStart, isMethodBeingCompiled, method, entryFromPerCompilationCache, isCompiledWhenProfiling);
 #endif /* defined(DEBUG) || defined(PROD_WITH_ASSUMES) */
          return entry; // could be NULL
          }
@@ -250,8 +255,21 @@ JITServerIProfiler::profilingSample(TR_OpaqueMethodBlock *method, uint32_t byteC
    _statsIProfilerInfoMsgToClient++;
 
    bool doCache = _useCaching && wholeMethod;
+   // Entries past this offset are appended from the data aggregated across clients
+   size_t clientDataSize = ipdata.size();
    if (!doCache)
+      {
       _statsIProfilerInfoReqNotCacheable++;
+      }
+   else if (auto sharedProfileCache = TR::CompilationInfo::get()->getJITServerSharedProfileCache())
+      {
+      // Only the data that is cached in persistent memory is sent once per method by each client,
+      // so it is the only one that can be merged without counting some clients more than others
+      if (usePersistentCache)
+         sharedProfileCache->addMethodProfile(clientSessionData, (J9Method *)method, ipdata);
+      // Bytecodes that this client has not profiled yet get the data of the other clients
+      _statsIProfilerInfoFromSharedProfileCache += sharedProfileCache->addMissingEntries(clientSessionData, (J9Method *)method, ipdata);
+      }
 
    if (ipdata.empty()) // client didn't send us anything
       {
@@ -286,6 +304,8 @@ JITServerIProfiler::profilingSample(TR_OpaqueMethodBlock *method, uint32_t byteC
             {
             // fill the new entry with data sent by client
             entry->deserialize(storage);
+            if ((size_t)(bufferPtr - &ipdata[0]) >= clientDataSize)
+               entry->setAggregatedEntry();
             // Add the entry to the cache if allowed
             // Note that it's possible that the method got unloaded since we last talked
             // to the client and the unload event was communicated through another compilation
@@ -403,6 +423,11 @@ JITServerIProfiler::printStats()
       j9tty_printf(PORTLIB, "IProfilerInfoCachingFailure: %6u\n", _statsIProfilerInfoCachingFailures);
       j9tty_printf(PORTLIB, "IProfilerInfoFromCache:   %6u\n", _statsIProfilerInfoFromCache);
       }
+   if (auto sharedProfileCache = TR::CompilationInfo::get()->getJITServerSharedProfileCache())
+      {
+      j9tty_printf(PORTLIB, "IProfilerInfoFromSharedProfileCache: %6u\n", _statsIProfilerInfoFromSharedProfileCache);
+      sharedProfileCache->printStats(stderr);
+      }
    }
 
 bool
@@ -117,6 +117,7 @@ private:
    uint32_t _statsIProfilerInfoReqNotCacheable; // info returned from client should not be cached
    uint32_t _statsIProfilerInfoIsEmpty; // client has no IP info for indicated PC
    uint32_t _statsIProfilerInfoCachingFailures;
+   uint32_t _statsIProfilerInfoFromSharedProfileCache; // entries aggregated from other clients for bytecodes this client has no data for
    };
 
 /**
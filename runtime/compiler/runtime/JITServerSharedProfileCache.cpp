@@ -0,0 +1,549 @@
+/*******************************************************************************
+ * Copyright IBM Corp. and others 2026
+ *
+ * This program and the accompanying materials are made available under
+ * the terms of the Eclipse Public License 2.0 which accompanies this
+ * distribution and is available at https://www.eclipse.org/legal/epl-2.0/
+ * or the Apache License, Version 2.0 which accompanies this distribution and
+ * is available at https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This Source Code may also be made available under the following
+ * Secondary Licenses when the conditions for such availability set
+ * forth in the Eclipse Public License, v. 2.0 are satisfied: GNU
+ * General Public License, version 2 with the GNU Classpath
+ * Exception [1] and GNU General Public License, version 2 with the
+ * OpenJDK Assembly Exception [2].
+ *
+ * [1] https://www.gnu.org/software/classpath/license.html
+ * [2] https://openjdk.org/legal/assembly-exception.html
+ *
+ * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
+ *******************************************************************************/
+#include "runtime/JITServerSharedProfileCache.hpp"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+#include "control/JITServerHelpers.hpp"
+#include "env/CompilerEnv.hpp"
+#include "infra/CriticalSection.hpp"
+#include "runtime/JITClientSession.hpp"
+#include "runtime/JITServerSharedROMClassCache.hpp"
+
+
+// Call graph weights recorded without a class (e.g. for direct calls) are aggregated under this hash
+static const JITServerROMClassHash NO_CLASS_HASH;
+
+// Counts in the IProfiler entries of a client are limited by the size of their fields
+static const uint64_t MAX_BRANCH_COUNT = 0xFFFF;
+static const uint64_t MAX_SWITCH_COUNT = 0xFFFFFFFE; // 0xFFFFFFFF marks a saturated counter
+static const uint64_t MAX_CALL_GRAPH_WEIGHT = 0xFFFF;
+static const uint64_t MAX_CALL_GRAPH_RESIDUE_WEIGHT = 0x7FFF;
+
+// Average count per contribution, rounded up so that a bytecode executed
+// by some client is not reported as never executed
+static uint64_t
+averageCount(uint64_t sum, uint32_t numContributions)
+   {
+   return (sum + numContributions - 1) / numContributions;
+   }
+
+// Smallest divisor that brings the count within the limit
+static uint64_t
+scaleDivisor(uint64_t count, uint64_t limit)
+   {
+   return std::max<uint64_t>(1, (count + limit - 1) / limit);
+   }
+
+static uint64_t
+scaleCount(uint64_t count, uint64_t divisor)
+   {
+   return (count + divisor - 1) / divisor;
+   }
+
+static size_t
+storageSize(uint32_t type)
+   {
+   switch (type)
+      {
+      case TR_IPBCD_FOUR_BYTES:
+         return sizeof(TR_IPBCDataFourBytesStorage);
+      case TR_IPBCD_EIGHT_WORDS:
+         return sizeof(TR_IPBCDataEightWordsStorage);
+      case TR_IPBCD_CALL_GRAPH:
+         return sizeof(TR_IPBCDataCallGraphStorage);
+      default:
+         return 0;
+      }
+   }
+
+
+JITServerSharedProfileCache::JITServerSharedProfileCache(size_t maxMemory) :
+   _methodMap(decltype(_methodMap)::allocator_type(TR::Compiler->persistentGlobalAllocator())),
+   _maxMemory(maxMemory),
+   _memoryUsed(0),
+   _monitor(TR::Monitor::create("JIT-JITServerSharedProfileCacheMonitor")),
+   _numContributions(0),
+   _numMissingEntriesAdded(0),
+   _numClassesNotTranslated(0),
+   _numMethodsRejected(0),
+   _numEntriesRejected(0),
+   _numCallTargetsRejected(0)
+   {
+   if (!_monitor)
+      throw std::bad_alloc();
+   }
+
+JITServerSharedProfileCache::~JITServerSharedProfileCache()
+   {
+   for (const auto &kv : _methodMap)
+      {
+      for (const auto &profile : kv.second)
+         {
+         if ((profile._type == TR_IPBCD_CALL_GRAPH) && profile._callGraph._targets)
+            TR::Compiler->persistentGlobalMemory()->freePersistentMemory(profile._callGraph._targets);
+         }
+      }
+   TR::Monitor::destroy(_monitor);
+   }
+
+
+const JITServerROMClassHash *
+JITServerSharedProfileCache::getClassHash(const J9ROMClass *romClass, int32_t numDimensions)
+   {
+   // All object array classes share the ROMClass of the "[L" class
+   if (numDimensions)
+      return NULL;
+   // Runtime-generated classes (e.g. lambdas) have names that vary across JVM instances
+   if (JITServerHelpers::getGeneratedClassNamePrefixLength(romClass))
+      return NULL;
+   return &JITServerSharedROMClassCache::getHash(romClass);
+   }
+
+bool
+JITServerSharedProfileCache::getMethodKey(ClientSessionData *clientData, J9Method *method, MethodKey &key)
+   {
+   auto &methodMap = clientData->getJ9MethodMap();
+   auto it = methodMap.find(method);
+   if (it == methodMap.end())
+      return false;
+
+   auto &classMap = clientData->getROMClassMap();
+   auto classIt = classMap.find((J9Class *)it->second._owningClass);
+   if (classIt == classMap.end())
+      return false;
+
+   const JITServerROMClassHash *hash = getClassHash(classIt->second._romClass, classIt->second._numDimensions);
+   if (!hash)
+      return false;
+
+   key._classHash = *hash;
+   key._methodIndex = it->second._index;
+   return true;
+   }
+
+const JITServerROMClassHash *
+JITServerSharedProfileCache::getProfiledClassHash(ClientSessionData *clientData, J9Class *clazz)
+   {
+   auto &classMap = clientData->getROMClassMap();
+   auto it = classMap.find(clazz);
+   if (it == classMap.end())
+      return NULL;
+   return getClassHash(it->second._romClass, it->second._numDimensions);
+   }
+
+J9Class *
+JITServerSharedProfileCache::getClass(ClientSessionData *clientData, const JITServerROMClassHash &hash)
+   {
+   auto &classByHashMap = clientData->getClassByROMClassHashMap();
+   auto it = classByHashMap.find(hash);
+   // NULL value means that the client has several classes with this ROMClass
+   return (it != classByHashMap.end()) ? it->second : NULL;
+   }
+
+
+bool
+JITServerSharedProfileCache::reserveMemory(size_t bytes)
+   {
+   if (_memoryUsed + bytes > _maxMemory)
+      return false;
+   _memoryUsed += bytes;
+   return true;
+   }
+
+
+void
+JITServerSharedProfileCache::addMethodProfile(ClientSessionData *clientData, J9Method *method, const std::string &ipdata)
+   {
+   if (ipdata.empty())
+      return;
+
+   OMR::CriticalSection romMapCS(clientData->getROMMapMonitor());
+   MethodKey key;
+   if (!getMethodKey(clientData, method, key))
+      return;
+
+   OMR::CriticalSection cs(_monitor);
+   auto it = _methodMap.find(key);
+   if (it == _methodMap.end())
+      {
+      if (!reserveMemory(METHOD_ENTRY_SIZE))
+         {
+         ++_numMethodsRejected;
+         return;
+         }
+      MethodProfile methodProfile(MethodProfile::allocator_type(TR::Compiler->persistentGlobalAllocator()));
+      it = _methodMap.insert({ key, methodProfile }).first;
+      }
+   MethodProfile &methodProfile = it->second;
+
+   const char *bufferPtr = ipdata.data();
+   TR_IPBCDataStorageHeader *storage = NULL;
+   do
+      {
+      storage = (TR_IPBCDataStorageHeader *)bufferPtr;
+      if (storageSize(storage->ID))
+         {
+         BytecodeProfile *profile = getBytecodeProfile(methodProfile, storage);
+         // The bytecodes of identical ROMClasses are identical, so the types can only differ if the data is corrupt
+         if (profile && (profile->_type == storage->ID))
+            merge(*profile, storage, clientData);
+         }
+      bufferPtr += storage->left;
+      } while (storage->left != 0);
+
+   ++_numContributions;
+   }
+
+JITServerSharedProfileCache::BytecodeProfile *
+JITServerSharedProfileCache::getBytecodeProfile(MethodProfile &methodProfile, TR_IPBCDataStorageHeader *storage)
+   {
+   auto it = std::lower_bound(methodProfile.begin(), methodProfile.end(), storage->pc,
+                              [](const BytecodeProfile &p, uint32_t bci) { return p._bci < bci; });
+   if ((it != methodProfile.end()) && (it->_bci == storage->pc))
+      return &*it;
+
+   // Grow the vector explicitly so that its storage is accounted for exactly
+   if (methodProfile.size() == methodProfile.capacity())
+      {
+      size_t capacity = std::max<size_t>(4, 2 * methodProfile.capacity());
+      if (!reserveMemory((capacity - methodProfile.capacity()) * sizeof(BytecodeProfile)))
+         {
+         ++_numEntriesRejected;
+         return NULL;
+         }
+      size_t index = it - methodProfile.begin();
+      methodProfile.reserve(capacity);
+      it = methodProfile.begin() + index;
+      }
+
+   BytecodeProfile profile;
+   memset(&profile, 0, sizeof(profile));
+   profile._bci = storage->pc;
+   profile._type = storage->ID;
+   return &*methodProfile.insert(it, profile);
+   }
+
+
+void
+JITServerSharedProfileCache::merge(BytecodeProfile &profile, TR_IPBCDataStorageHeader *storage, ClientSessionData *clientData)
+   {
+   ++profile._numContributions;
+   switch (profile._type)
+      {
+      case TR_IPBCD_FOUR_BYTES:
+         {
+         uint32_t data = ((TR_IPBCDataFourBytesStorage *)storage)->data;
+         profile._branch._taken += data >> 16;
+         profile._branch._notTaken += data & 0xFFFF;
+         }
+         break;
+      case TR_IPBCD_EIGHT_WORDS:
+         {
+         auto &switchProfile = profile._switch;
+         const uint64_t *data = ((TR_IPBCDataEightWordsStorage *)storage)->data;
+         for (size_t i = 0; i < SWITCH_DATA_COUNT - 1; ++i)
+            {
+            uint32_t target = (uint32_t)(data[i] >> 32);
+            uint32_t count = (uint32_t)data[i];
+            if (!target)
+               continue;
+
+            size_t slot = 0;
+            while ((slot < SWITCH_DATA_COUNT - 1) && switchProfile._targets[slot] && (switchProfile._targets[slot] != target))
+               ++slot;
+            if (slot < SWITCH_DATA_COUNT - 1)
+               {
+               switchProfile._targets[slot] = target;
+               switchProfile._counts[slot] += count;
+               }
+            else
+               {
+               switchProfile._counts[SWITCH_DATA_COUNT - 1] += count;
+               }
+            }
+         switchProfile._counts[SWITCH_DATA_COUNT - 1] += (uint32_t)data[SWITCH_DATA_COUNT - 1];
+         }
+         break;
+      case TR_IPBCD_CALL_GRAPH:
+         mergeCallGraph(profile._callGraph, (TR_IPBCDataCallGraphStorage *)storage, clientData);
+         break;
+      }
+   }
+
+void
+JITServerSharedProfileCache::mergeCallGraph(BytecodeProfile::CallGraph &callGraph, TR_IPBCDataCallGraphStorage *storage,
+                                            ClientSessionData *clientData)
+   {
+   CallSiteProfileInfo &csInfo = storage->_csInfo;
+   for (int32_t i = 0; i < NUM_CS_SLOTS; ++i)
+      {
+      uint16_t weight = csInfo._weight[i];
+      if (!weight)
+         continue;
+
+      J9Class *clazz = (J9Class *)csInfo.getClazz(i);
+      const JITServerROMClassHash *hash = clazz ? getProfiledClassHash(clientData, clazz) : &NO_CLASS_HASH;
+      if (!hash)
+         {
+         ++_numClassesNotTranslated;
+         callGraph._residueWeight += weight;
+         continue;
+         }
+
+      if (!callGraph._targets)
+         {
+         size_t size = MAX_CALL_TARGETS * sizeof(CallTarget);
+         if (!reserveMemory(size))
+            {
+            ++_numCallTargetsRejected;
+            callGraph._residueWeight += weight;
+            continue;
+            }
+         callGraph._targets = (CallTarget *)TR::Compiler->persistentGlobalMemory()->allocatePersistentMemory(size, TR_Memory::IProfiler);
+         if (!callGraph._targets)
+            throw std::bad_alloc();
+         }
+
+      uint32_t t = 0;
+      while ((t < callGraph._numTargets) && (callGraph._targets[t]._classHash != *hash))
+         ++t;
+      if (t < callGraph._numTargets)
+         {
+         callGraph._targets[t]._weight += weight;
+         }
+      else if (callGraph._numTargets < MAX_CALL_TARGETS)
+         {
+         callGraph._targets[t]._classHash = *hash;
+         callGraph._targets[t]._weight = weight;
+         ++callGraph._numTargets;
+         }
+      else
+         {
+         callGraph._residueWeight += weight;
+         }
+      }
+   callGraph._residueWeight += csInfo._residueWeight;
+   callGraph._tooBigToBeInlined = callGraph._tooBigToBeInlined || csInfo._tooBigToBeInlined;
+   }
+
+
+size_t
+JITServerSharedProfileCache::addMissingEntries(ClientSessionData *clientData, J9Method *method, std::string &ipdata)
+   {
+   OMR::CriticalSection romMapCS(clientData->getROMMapMonitor());
+   MethodKey key;
+   if (!getMethodKey(clientData, method, key))
+      return 0;
+
+   OMR::CriticalSection cs(_monitor);
+   auto it = _methodMap.find(key);
+   if (it == _methodMap.end())
+      return 0;
+   const MethodProfile &methodProfile = it->second;
+
+   // Find the bytecodes that the client has data for, and the last entry it sent
+   std::vector<uint32_t> clientBCIs;
+   size_t lastEntryOffset = std::string::npos;
+   if (!ipdata.empty())
+      {
+      size_t offset = 0;
+      TR_IPBCDataStorageHeader *storage = NULL;
+      do
+         {
+         storage = (TR_IPBCDataStorageHeader *)&ipdata[offset];
+         clientBCIs.push_back(storage->pc);
+         lastEntryOffset = offset;
+         offset += storage->left;
+         } while (storage->left != 0);
+      std::sort(clientBCIs.begin(), clientBCIs.end());
+      }
+
+   size_t numAdded = 0;
+   for (const auto &profile : methodProfile)
+      {
+      if (std::binary_search(clientBCIs.begin(), clientBCIs.end(), profile._bci))
+         continue;
+
+      size_t offset = ipdata.size();
+      ipdata.resize(offset + storageSize(profile._type));
+      size_t bytes = serialize(profile, (TR_IPBCDataStorageHeader *)&ipdata[offset], clientData);
+      ipdata.resize(offset + bytes);
+      if (!bytes)
+         continue;
+
+      // Link the previous last entry to the new one
+      if (lastEntryOffset != std::string::npos)
+         ((TR_IPBCDataStorageHeader *)&ipdata[lastEntryOffset])->left = offset - lastEntryOffset;
+      lastEntryOffset = offset;
+      ++numAdded;
+      }
+
+   _numMissingEntriesAdded += numAdded;
+   return numAdded;
+   }
+
+size_t
+JITServerSharedProfileCache::serialize(const BytecodeProfile &profile, TR_IPBCDataStorageHeader *storage,
+                                       ClientSessionData *clientData)
+   {
+   if (!profile._numContributions)
+      return 0;
+
+   storage->pc = profile._bci;
+   storage->left = 0;
+   storage->right = 0;
+   storage->ID = profile._type;
+
+   switch (profile._type)
+      {
+      case TR_IPBCD_FOUR_BYTES:
+         {
+         uint64_t taken = averageCount(profile._branch._taken, profile._numContributions);
+         uint64_t notTaken = averageCount(profile._branch._notTaken, profile._numContributions);
+         if (!taken && !notTaken)
+            return 0;
+
+         uint64_t divisor = std::max(scaleDivisor(taken, MAX_BRANCH_COUNT), scaleDivisor(notTaken, MAX_BRANCH_COUNT));
+         ((TR_IPBCDataFourBytesStorage *)storage)->data =
+            (uint32_t)(scaleCount(taken, divisor) << 16) | (uint32_t)scaleCount(notTaken, divisor);
+         return sizeof(TR_IPBCDataFourBytesStorage);
+         }
+      case TR_IPBCD_EIGHT_WORDS:
+         {
+         uint64_t counts[SWITCH_DATA_COUNT];
+         uint64_t divisor = 1;
+         bool executed = false;
+         for (size_t i = 0; i < SWITCH_DATA_COUNT; ++i)
+            {
+            counts[i] = averageCount(profile._switch._counts[i], profile._numContributions);
+            divisor = std::max(divisor, scaleDivisor(counts[i], MAX_SWITCH_COUNT));
+            executed = executed || counts[i];
+            }
+         if (!executed)
+            return 0;
+
+         uint64_t *data = ((TR_IPBCDataEightWordsStorage *)storage)->data;
+         for (size_t i = 0; i < SWITCH_DATA_COUNT; ++i)
+            {
+            uint64_t target = (i < SWITCH_DATA_COUNT - 1) ? profile._switch._targets[i] : 0;
+            data[i] = (target << 32) | scaleCount(counts[i], divisor);
+            }
+         return sizeof(TR_IPBCDataEightWordsStorage);
+         }
+      case TR_IPBCD_CALL_GRAPH:
+         return serializeCallGraph(profile, (TR_IPBCDataCallGraphStorage *)storage, clientData);
+      default:
+         return 0;
+      }
+   }
+
+size_t
+JITServerSharedProfileCache::serializeCallGraph(const BytecodeProfile &profile, TR_IPBCDataCallGraphStorage *storage,
+                                                ClientSessionData *clientData)
+   {
+   const BytecodeProfile::CallGraph &callGraph = profile._callGraph;
+
+   // Hand the heaviest targets that exist in the client to it; the others are counted as residue
+   uint32_t order[MAX_CALL_TARGETS];
+   for (uint32_t t = 0; t < callGraph._numTargets; ++t)
+      order[t] = t;
+   std::sort(order, order + callGraph._numTargets,
+             [&callGraph](uint32_t a, uint32_t b) { return callGraph._targets[a]._weight > callGraph._targets[b]._weight; });
+
+   J9Class *classes[NUM_CS_SLOTS];
+   uint64_t weights[NUM_CS_SLOTS];
+   int32_t numSlots = 0;
+   uint64_t residueWeight = callGraph._residueWeight;
+   for (uint32_t t = 0; t < callGraph._numTargets; ++t)
+      {
+      const CallTarget &target = callGraph._targets[order[t]];
+      if (numSlots < NUM_CS_SLOTS)
+         {
+         if (target._classHash == NO_CLASS_HASH)
+            {
+            classes[numSlots] = NULL;
+            weights[numSlots++] = target._weight;
+            continue;
+            }
+         if (J9Class *clazz = getClass(clientData, target._classHash))
+            {
+            classes[numSlots] = clazz;
+            weights[numSlots++] = target._weight;
+            continue;
+            }
+         ++_numClassesNotTranslated;
+         }
+      residueWeight += target._weight;
+      }
+
+   // Weights without any known class could make a monomorphic call site look polymorphic to the
+   // client, which is worse than having no data at all
+   if (!numSlots)
+      return 0;
+
+   uint64_t divisor = 1;
+   for (int32_t i = 0; i < numSlots; ++i)
+      {
+      weights[i] = averageCount(weights[i], profile._numContributions);
+      divisor = std::max(divisor, scaleDivisor(weights[i], MAX_CALL_GRAPH_WEIGHT));
+      }
+   residueWeight = averageCount(residueWeight, profile._numContributions);
+   divisor = std::max(divisor, scaleDivisor(residueWeight, MAX_CALL_GRAPH_RESIDUE_WEIGHT));
+
+   CallSiteProfileInfo &csInfo = storage->_csInfo;
+   csInfo.initialize();
+   for (int32_t i = 0; i < numSlots; ++i)
+      {
+      csInfo.setClazz(i, (uintptr_t)classes[i]);
+      csInfo._weight[i] = (uint16_t)scaleCount(weights[i], divisor);
+      }
+   csInfo._residueWeight = (uint16_t)scaleCount(residueWeight, divisor);
+   csInfo._tooBigToBeInlined = callGraph._tooBigToBeInlined;
+   return sizeof(TR_IPBCDataCallGraphStorage);
+   }
+
+
+void
+JITServerSharedProfileCache::printStats(FILE *f) const
+   {
+   fprintf(f,
+      "JITServer shared profile cache statistics:\n"
+      "\tmethods: %zu\n"
+      "\tmemory used: %zu of %zu bytes\n"
+      "\tmethods rejected: %zu\n"
+      "\tentries rejected: %zu\n"
+      "\tcall targets rejected: %zu\n"
+      "\tcontributions: %zu\n"
+      "\tentries added for clients: %zu\n"
+      "\tclasses not translated: %zu\n",
+      _methodMap.size(),
+      _memoryUsed, _maxMemory,
+      _numMethodsRejected,
+      _numEntriesRejected,
+      _numCallTargetsRejected,
+      _numContributions,
+      _numMissingEntriesAdded,
+      _numClassesNotTranslated
+   );
+   }
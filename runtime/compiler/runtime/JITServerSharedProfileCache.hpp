@@ -0,0 +1,172 @@
+/*******************************************************************************
+ * Copyright IBM Corp. and others 2026
+ *
+ * This program and the accompanying materials are made available under
+ * the terms of the Eclipse Public License 2.0 which accompanies this
+ * distribution and is available at https://www.eclipse.org/legal/epl-2.0/
+ * or the Apache License, Version 2.0 which accompanies this distribution and
+ * is available at https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This Source Code may also be made available under the following
+ * Secondary Licenses when the conditions for such availability set
+ * forth in the Eclipse Public License, v. 2.0 are satisfied: GNU
+ * General Public License, version 2 with the GNU Classpath
+ * Exception [1] and GNU General Public License, version 2 with the
+ * OpenJDK Assembly Exception [2].
+ *
+ * [1] https://www.gnu.org/software/classpath/license.html
+ * [2] https://openjdk.org/legal/assembly-exception.html
+ *
+ * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
+ *******************************************************************************/
+#ifndef JITSERVER_SHARED_PROFILE_CACHE_H
+#define JITSERVER_SHARED_PROFILE_CACHE_H
+
+#include <stdio.h>
+#include <string>
+#include <utility>
+#include "env/TRMemory.hpp"
+#include "env/PersistentCollections.hpp"
+#include "infra/Monitor.hpp"
+#include "runtime/IProfiler.hpp"
+#include "runtime/JITServerROMClassHash.hpp"
+
+class ClientSessionData;
+struct J9Method;
+
+
+// Stores the IProfiler data of the methods of identical classes loaded by different clients,
+// merged into a single profile per bytecode. A client that has not profiled a bytecode yet
+// (e.g. because it has just started) gets the aggregated profile of the other clients instead.
+//
+// Methods are identified by the ROMClass hash of their defining class and by their index in
+// that class, which requires ROMClass sharing. The classes recorded in call graph profiles are
+// identified by their ROMClass hashes as well, and are translated to the classes of a client
+// using the ClientSessionData::getClassByROMClassHashMap() of that client. Array classes and
+// runtime-generated classes do not have a hash that identifies them across clients; their
+// weights are counted as residue.
+//
+// The IProfiler data is exchanged in the format sent by the client for all the bytecodes of
+// a method: a sequence of TR_IPBCDataStorageHeader-based entries linked by their "left" fields.
+//
+// The memory used by the cache is bounded. Once the limit is reached, new methods and bytecodes
+// are not recorded, and the call graph weights of sites without a target array become residue.
+class JITServerSharedProfileCache
+   {
+public:
+   TR_PERSISTENT_ALLOC(TR_Memory::IProfiler)
+
+   JITServerSharedProfileCache(size_t maxMemory);
+   ~JITServerSharedProfileCache();
+
+   // Merges the IProfiler data sent by the client for all the bytecodes of the method.
+   // Must be called at most once per method for each client, so that no client counts twice.
+   void addMethodProfile(ClientSessionData *clientData, J9Method *method, const std::string &ipdata);
+
+   // Appends to the IProfiler data sent by the client for all the bytecodes of the method
+   // the aggregated entries for the bytecodes that the client has no data for.
+   // Returns the number of entries appended.
+   size_t addMissingEntries(ClientSessionData *clientData, J9Method *method, std::string &ipdata);
+
+   // Returns the hash that identifies a class cached by the server across clients,
+   // or NULL for array classes and runtime-generated classes
+   static const JITServerROMClassHash *getClassHash(const J9ROMClass *romClass, int32_t numDimensions);
+
+   void printStats(FILE *f) const;
+
+private:
+   // Maximum number of distinct classes recorded in the aggregated profile of a call site.
+   // Clients only record NUM_CS_SLOTS classes each, but not necessarily the same ones.
+   static const size_t MAX_CALL_TARGETS = 2 * NUM_CS_SLOTS;
+
+   struct MethodKey
+      {
+      bool operator==(const MethodKey &k) const
+         { return (_methodIndex == k._methodIndex) && (_classHash == k._classHash); }
+      struct Hash
+         {
+         size_t operator()(const MethodKey &k) const noexcept
+            { return std::hash<JITServerROMClassHash>()(k._classHash) ^ k._methodIndex; }
+         };
+
+      JITServerROMClassHash _classHash; // Hash of the ROMClass of the defining class
+      uint32_t _methodIndex; // Index of the method in its defining class
+      };
+
+   struct CallTarget
+      {
+      JITServerROMClassHash _classHash; // All zeros for the weight recorded without a class, e.g. for direct calls
+      uint64_t _weight;
+      };
+
+   // Aggregated profile of a bytecode. Counts are sums over all the contributions;
+   // they are averaged over the number of contributions when handed to a client.
+   struct BytecodeProfile
+      {
+      struct Branch
+         {
+         uint64_t _taken;
+         uint64_t _notTaken;
+         };
+      struct Switch
+         {
+         uint32_t _targets[SWITCH_DATA_COUNT - 1]; // 0 for an unused slot
+         uint64_t _counts[SWITCH_DATA_COUNT]; // The last one is for the targets that do not fit in a slot
+         };
+      struct CallGraph
+         {
+         CallTarget *_targets; // MAX_CALL_TARGETS entries
+         uint32_t _numTargets;
+         bool _tooBigToBeInlined;
+         uint64_t _residueWeight;
+         };
+
+      uint32_t _bci;
+      uint32_t _type; // TR_IPBCD_FOUR_BYTES, TR_IPBCD_EIGHT_WORDS or TR_IPBCD_CALL_GRAPH
+      uint32_t _numContributions;
+      union
+         {
+         Branch _branch;
+         Switch _switch;
+         CallGraph _callGraph;
+         };
+      };
+
+   using MethodProfile = PersistentVector<BytecodeProfile>; // Sorted by bytecode index
+
+   // Estimated memory used by an entry of the method map, excluding the storage of the bytecode profiles
+   static const size_t METHOD_ENTRY_SIZE = sizeof(std::pair<const MethodKey, MethodProfile>) + 2 * sizeof(void *);
+
+   // Must be called with the ROMClass map monitor of the client
+   static bool getMethodKey(ClientSessionData *clientData, J9Method *method, MethodKey &key);
+   static const JITServerROMClassHash *getProfiledClassHash(ClientSessionData *clientData, J9Class *clazz);
+   static J9Class *getClass(ClientSessionData *clientData, const JITServerROMClassHash &hash);
+
+   // Must be called with _monitor. Accounts for the bytes if they fit within the limit.
+   bool reserveMemory(size_t bytes);
+   // Must be called with _monitor. Returns NULL if the profile of a new bytecode does not fit within the limit.
+   BytecodeProfile *getBytecodeProfile(MethodProfile &methodProfile, TR_IPBCDataStorageHeader *storage);
+   // Must be called with _monitor
+   void merge(BytecodeProfile &profile, TR_IPBCDataStorageHeader *storage, ClientSessionData *clientData);
+   void mergeCallGraph(BytecodeProfile::CallGraph &callGraph, TR_IPBCDataCallGraphStorage *storage,
+                       ClientSessionData *clientData);
+   // Returns the number of bytes written to storage, or 0 if the profile has nothing to offer to the client
+   size_t serialize(const BytecodeProfile &profile, TR_IPBCDataStorageHeader *storage, ClientSessionData *clientData);
+   size_t serializeCallGraph(const BytecodeProfile &profile, TR_IPBCDataCallGraphStorage *storage,
+                             ClientSessionData *clientData);
+
+   PersistentUnorderedMap<MethodKey, MethodProfile, MethodKey::Hash> _methodMap;
+   const size_t _maxMemory; // Limit for the memory used by the method map, bytecode profiles and call targets
+   size_t _memoryUsed;
+   TR::Monitor *const _monitor;
+
+   // Statistics
+   size_t _numContributions; // Methods whose profile was merged
+   size_t _numMissingEntriesAdded; // Entries handed to a client that had no data for them
+   size_t _numClassesNotTranslated; // Profiled classes counted as residue because they could not be translated
+   size_t _numMethodsRejected; // Methods not added because the cache was full
+   size_t _numEntriesRejected; // Bytecode profiles not added because the cache was full
+   size_t _numCallTargetsRejected; // Call graph weights counted as residue because the cache was full
+   };
+
+#endif /* JITSERVER_SHARED_PROFILE_CACHE_H */
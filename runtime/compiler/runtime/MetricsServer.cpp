@@ -39,7 +39,9 @@
 #include "env/PersistentInfo.hpp"
 #include "env/VerboseLog.hpp"
 #include "env/VMJ9.h"
+#include "infra/CriticalSection.hpp"
 #include "net/ServerStream.hpp"
+#include "runtime/JITClientSession.hpp"
 #include "runtime/MetricsServer.hpp"
 
 bool MetricsServer::useSSL(TR::CompilationInfo *compInfo)
@@ -143,13 +145,46 @@ double ActiveThreadsMetric::computeValue(TR::CompilationInfo *compInfo)
    return getValue();
    }
 
+double ClientQueuedConnectionsMetric::computeValue(TR::CompilationInfo *compInfo)
+   {
+   clearClientValues();
+   uint32_t totalConnections = 0;
+   OMR::CriticalSection compilationMonitorLock(compInfo->getCompilationMonitor());
+   for (const auto &it : compInfo->getClientSessionHT()->getClientSessionMap())
+      {
+      uint32_t numConnections = it.second->getNumQueuedConnections();
+      addClientValue(it.first, numConnections);
+      totalConnections += numConnections;
+      }
+   setValue(totalConnections);
+   return getValue();
+   }
+
+double ClientQueueWaitTimeMetric::computeValue(TR::CompilationInfo *compInfo)
+   {
+   clearClientValues();
+   double maxWaitTimeMs = 0;
+   OMR::CriticalSection compilationMonitorLock(compInfo->getCompilationMonitor());
+   for (const auto &it : compInfo->getClientSessionHT()->getClientSessionMap())
+      {
+      double waitTimeMs = it.second->getAvgQueueWaitTimeUs() / 1000.0;
+      addClientValue(it.first, waitTimeMs);
+      if (waitTimeMs > maxWaitTimeMs)
+         maxWaitTimeMs = waitTimeMs;
+      }
+   setValue(maxWaitTimeMs);
+   return getValue();
+   }
+
 MetricsDatabase::MetricsDatabase(TR::CompilationInfo *compInfo) : _compInfo(compInfo)
    {
    _metrics[0] = new (PERSISTENT_NEW) CPUUtilMetric();
    _metrics[1] = new (PERSISTENT_NEW) AvailableMemoryMetric();
    _metrics[2] = new (PERSISTENT_NEW) ConnectedClientsMetric();
    _metrics[3] = new (PERSISTENT_NEW) ActiveThreadsMetric();
-   static_assert(3 == MAX_METRICS - 1);
+   _metrics[4] = new (PERSISTENT_NEW) ClientQueuedConnectionsMetric();
+   _metrics[5] = new (PERSISTENT_NEW) ClientQueueWaitTimeMetric();
+   static_assert(5 == MAX_METRICS - 1);
    }
 
 MetricsDatabase::~MetricsDatabase()
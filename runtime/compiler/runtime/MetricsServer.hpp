@@ -57,7 +57,7 @@ class PrometheusMetric
       @brief Build a std::string that encodes the value of the metric in a format understood by Prometheus
       @return Serialized value of the metric (as a std::string)
    */
-   std::string serialize()
+   virtual std::string serialize()
       {
       return "# HELP " + getName() + " " + getHelp() + "\n# TYPE " + getName() + " gauge\n" + getName() + " " + std::to_string(getValue()) + "\n";
       }
@@ -112,6 +112,58 @@ public:
    virtual double computeValue(TR::CompilationInfo *compInfo);
    }; // class ActiveThreadsMetric
 
+/**
+   @class PerClientPrometheusMetric
+   @brief Abstraction for a metric that has one value for each client connected to JITServer
+
+   The values are serialized as one sample per client, labeled with the UID of the client.
+   Derived classes call `addClientValue()` from their `computeValue()` implementation.
+ */
+class PerClientPrometheusMetric : public PrometheusMetric
+   {
+   public:
+   PerClientPrometheusMetric(const std::string &name, const std::string &help) : PrometheusMetric(name, help) {}
+   virtual std::string serialize()
+      {
+      return "# HELP " + getName() + " " + getHelp() + "\n# TYPE " + getName() + " gauge\n" + _clientValues;
+      }
+
+   protected:
+   void clearClientValues() { _clientValues.clear(); }
+   void addClientValue(uint64_t clientUID, double value)
+      {
+      _clientValues += getName() + "{client_uid=\"" + std::to_string(clientUID) + "\"} " + std::to_string(value) + "\n";
+      }
+
+   private:
+   std::string _clientValues; // Serialized samples of the last computeValue()
+   }; // class PerClientPrometheusMetric
+
+/**
+   @brief Class used to serialize the number of connections of each client waiting in the compilation queue, as a metric understood by Prometheus
+
+   Connections are queued again as soon as their previous request is done, so this counts the connections
+   of a client that are not being served, whether or not the client has sent a request on them.
+ */
+class ClientQueuedConnectionsMetric : public PerClientPrometheusMetric
+   {
+public:
+   ClientQueuedConnectionsMetric() : PerClientPrometheusMetric("jitserver_client_queued_connections", "Number of connections of the client waiting in the compilation queue, with or without a pending request")
+      {}
+   virtual double computeValue(TR::CompilationInfo *compInfo); // Returns the total over all clients
+   }; // class ClientQueuedConnectionsMetric
+
+/**
+   @brief Class used to serialize the average time compilation requests of each client wait in the queue, as a metric understood by Prometheus
+ */
+class ClientQueueWaitTimeMetric : public PerClientPrometheusMetric
+   {
+public:
+   ClientQueueWaitTimeMetric() : PerClientPrometheusMetric("jitserver_client_queue_wait_time_ms", "Moving average of the time compilation requests of the client wait in the queue (ms)")
+      {}
+   virtual double computeValue(TR::CompilationInfo *compInfo); // Returns the maximum over all clients
+   }; // class ClientQueueWaitTimeMetric
+
 
 /**
    @class MetricsDatabase
@@ -125,7 +177,7 @@ public:
 class MetricsDatabase
    {
    public:
-   static const size_t MAX_METRICS = 4; // Maximum number of metrics our database can hold
+   static const size_t MAX_METRICS = 6; // Maximum number of metrics our database can hold
    MetricsDatabase(TR::CompilationInfo *compInfo);
    ~MetricsDatabase();
 
@@ -296,7 +296,8 @@ void J9::Recompilation::methodCannotBeRecompiled(void *oldStartPC, TR_FrontEnd *
    if (bodyInfo->getUsesPreexistence()
        || methodInfo->hasBeenReplaced()
        || (usesSampling && ! fej9->isAsyncCompilation()) // go interpreted for failed recomps in sync mode
-       || methodInfo->isExcludedPostRestore()) // go interpreted if method is excluded post restore
+       || methodInfo->isExcludedPostRestore() // go interpreted if method is excluded post restore
+       || methodInfo->isRevertedByDebugAgent()) // go interpreted if the JIT debug agent is reverting the method
       {
       // We need to switch the method to interpreted.  Change the first instruction of the
       // method to jump back to the call to the interpreter dispatch
@@ -315,7 +315,8 @@ J9::Recompilation::methodCannotBeRecompiled(void * oldStartPC, TR_FrontEnd * fe)
    if (bodyInfo->getUsesPreexistence()
        || methodInfo->hasBeenReplaced()
        || (linkageInfo->isSamplingMethodBody() && ! fej9->isAsyncCompilation()) // go interpreted for failed recomps in sync mode
-       || methodInfo->isExcludedPostRestore()) // go interpreted if method is excluded post restore
+       || methodInfo->isExcludedPostRestore() // go interpreted if method is excluded post restore
+       || methodInfo->isRevertedByDebugAgent()) // go interpreted if the JIT debug agent is reverting the method
       {
       bool usesSampling = linkageInfo->isSamplingMethodBody();
       // We need to switch the method to interpreted.  Change the first instruction of the
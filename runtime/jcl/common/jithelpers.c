@@ -26,6 +26,8 @@
 #include "j9modifiers_api.h"
 #include "j9nongenerated.h"
 #include "jclprots.h"
+#include "j9argscan.h"
+#include "hashtable_api.h"
 
 /*
  * The following natives are called by the JITHelpers static initializer. They do not require special treatment by the JIT.
@@ -458,106 +460,2024 @@ Java_com_ibm_jit_JITHelpers_setForceUsePreexistence(JNIEnv* env, jclass ignored)
 	jitConfig->debugAgentSetForceUsePreexistence(vmThread);
 }
 
-void JNICALL		
-Java_com_ibm_jit_JITHelpers_debugAgentRun(JNIEnv *env, jclass ignored, jobject ma, jobject obj, jobjectArray args)
-{	
+#define DEBUG_AGENT_SEARCH_PROPERTY "com.ibm.jit.debugAgent.search"
+#define DEBUG_AGENT_MAX_RUNS_PROPERTY "com.ibm.jit.debugAgent.maxRuns"
+#define DEBUG_AGENT_FAILURE_RATE_PROPERTY "com.ibm.jit.debugAgent.failureRate"
+#define DEBUG_AGENT_PASSING_FAILURE_RATE_PROPERTY "com.ibm.jit.debugAgent.passingFailureRate"
+#define DEBUG_AGENT_CONFIDENCE_PROPERTY "com.ibm.jit.debugAgent.confidence"
+#define DEBUG_AGENT_TIMEOUT_PROPERTY "com.ibm.jit.debugAgent.timeout"
+#define DEBUG_AGENT_TIMEOUT_FACTOR_PROPERTY "com.ibm.jit.debugAgent.timeoutFactor"
+#define DEBUG_AGENT_CALIBRATION_TIMEOUT_PROPERTY "com.ibm.jit.debugAgent.calibrationTimeout"
+#define DEBUG_AGENT_REPORT_PROPERTY "com.ibm.jit.debugAgent.report"
+#define DEBUG_AGENT_STATE_PROPERTY "com.ibm.jit.debugAgent.state"
+
+/* Defaults for the sequential probability ratio test, rates are in percent */
+#define DEBUG_AGENT_DEFAULT_MAX_RUNS 1
+#define DEBUG_AGENT_DEFAULT_FAILURE_RATE 50
+#define DEBUG_AGENT_DEFAULT_PASSING_FAILURE_RATE 1
+#define DEBUG_AGENT_DEFAULT_CONFIDENCE 95
+
+/*
+ * Defaults for the watchdog, the time budget of a test run is calibrated from the first run unless a timeout is given.
+ * The first run is bounded by the calibration timeout so that a hang in it does not stall the investigation.
+ */
+#define DEBUG_AGENT_DEFAULT_TIMEOUT 0
+#define DEBUG_AGENT_DEFAULT_TIMEOUT_FACTOR 10
+#define DEBUG_AGENT_DEFAULT_CALIBRATION_TIMEOUT 600000
+#define DEBUG_AGENT_MIN_TIMEOUT 1000
+
+#define DEBUG_AGENT_WATCHDOG_RUNNING 0
+#define DEBUG_AGENT_WATCHDOG_STOPPING 1
+#define DEBUG_AGENT_WATCHDOG_STOPPED 2
+
+#define DEBUG_AGENT_TEST_PASSED 0
+#define DEBUG_AGENT_TEST_FAILED 1
+#define DEBUG_AGENT_TEST_ERROR 2
+
+/* Failures are told apart by their exception type and the JIT methods of their top JIT frames */
+#define DEBUG_AGENT_FINGERPRINT_FRAMES 3
+#define DEBUG_AGENT_FINGERPRINT_LENGTH 1024
+
+/* Optimization limit large enough to never stop the optimizer early */
+#define DEBUG_AGENT_MAX_OPT_INDEX 0x7FFFFFFF
+
+/* Where the defect of the problematic body comes from, as told apart by recompiling it as a JIT and as an AOT body */
+#define DEBUG_AGENT_ORIGIN_JIT_BODY "jitBody" /* not an AOT body */
+#define DEBUG_AGENT_ORIGIN_JIT_COMPILATION "jitCompilation" /* an AOT body, a fresh JIT body fails as well */
+#define DEBUG_AGENT_ORIGIN_AOT_COMPILATION "aotCompilation" /* an AOT body, only a fresh AOT body fails as well */
+#define DEBUG_AGENT_ORIGIN_SCC_LOAD "sharedClassCacheLoad" /* an AOT body, neither a fresh JIT nor AOT body fails */
+
+/*
+ * Watches over test runs and interrupts those which take longer than the time budget, since miscompiled code often
+ * loops forever rather than throwing an exception.
+ */
+typedef struct J9DebugAgentWatchdog {
+	J9JavaVM *vm;
+	J9VMThread *testThread;
+	omrthread_t thread;
+	omrthread_monitor_t monitor;
+	IDATA asyncEventKey;
+	jobject timeoutException; /* thrown into the test thread when a test run exceeds the time budget */
+	I_64 budget; /* maximum duration of a test run in milliseconds, the calibration timeout until calibrated */
+	UDATA budgetFactor; /* multiple of the duration of the first test run used as the time budget */
+	BOOLEAN calibrated; /* the time budget was given or has been calibrated from the first test run */
+	I_64 startTime; /* time the current test run started */
+	I_64 deadline; /* time by which the current test run must finish, 0 when no test run is bounded */
+	BOOLEAN timedOut; /* the current test run has exceeded the time budget */
+	UDATA state;
+} J9DebugAgentWatchdog;
+
+/*
+ * Where an investigation spends its time, written out as JSON to the file named by the report system property.
+ */
+typedef struct J9DebugAgentReport {
+	IDATA fd; /* -1 if no report is written */
+	UDATA eventCount;
+	I_64 startTime;
+	UDATA candidates;
+	UDATA nonRevertible; /* JIT methods excluded from the search because they cannot be reverted */
+	UDATA suspects;
+	UDATA reverts;
+	UDATA restores;
+	UDATA testRuns;
+	I_64 testRunTime; /* in nanoseconds */
+	UDATA recompilations;
+	UDATA compilationTime; /* in microseconds */
+	UDATA traceLogBytes;
+	const char *verdict;
+	J9JITExceptionTable *culprit;
+	IDATA culpritInliningAttempt;
+	IDATA culpritOptIndex;
+	IDATA culpritOptSubIndex;
+	const char *culpritOrigin; /* NULL if unknown */
+} J9DebugAgentReport;
+
+/*
+ * Progress of an investigation, saved after every probe to the file named by the state system property so a later JVM
+ * running the same test can pick up where an earlier one stopped. JIT methods are saved by signature since their
+ * addresses differ from one JVM to the next.
+ */
+typedef struct J9DebugAgentState {
+	const char *path; /* NULL if the investigation is not saved */
+	char *identity; /* the test method, as found on the stack trace of the failure */
+	J9JITExceptionTable **jitMethods;
+	UDATA jitMethodCount;
+	UDATA low; /* JIT methods in [low, high) are still candidates, the others have been cleared */
+	UDATA high;
+	J9JITExceptionTable *culprit;
+	BOOLEAN originSearched;
+	BOOLEAN inlinedCallSitesSearched;
+	BOOLEAN optimizationsSearched;
+	IDATA passingOptIndex; /* -1 until the lastOptIndex search has bracketed the culprit */
+	IDATA failingOptIndex;
+} J9DebugAgentState;
+
+/*
+ * Entry of the table of the JIT methods cleared by an earlier investigation, which is looked up by JIT method rather
+ * than by signature so that no signature has to be formatted for the lookup.
+ */
+typedef struct J9DebugAgentSignatureEntry {
+	const char *signature; /* signature read from the state file, NULL when looking up a JIT method */
+	J9JITExceptionTable *jitMethod; /* JIT method to look up, NULL for a signature read from the state file */
+} J9DebugAgentSignatureEntry;
+
+/*
+ * Everything needed to rerun the test which triggered the debug agent.
+ */
+typedef struct J9DebugAgentTest {
+	JNIEnv *env;
+	jobject ma;
+	jobject obj;
+	jobjectArray args;
+	jmethodID invoke;
+	jclass invocationTargetException;
+	UDATA maxRuns; /* runs of the test per probe, a single run disables the sequential probability ratio test */
+	double failureRate; /* expected failure rate of the test while the miscompiled code is executed */
+	double passingFailureRate; /* tolerated failure rate of the test once the miscompiled code is no longer executed */
+	double errorRate; /* probability of a wrong verdict for a probe */
+	UDATA bodyKind; /* kind of body recompilations produce, see J9_DEBUG_AGENT_RECOMPILE_SAME_KIND */
+	IDATA maxInlinedCallSites; /* inlining attempts allowed in recompilations, -1 for no limit */
+	IDATA *disabledOptimizations; /* optimizations disabled in recompilations */
+	UDATA disabledOptimizationCount;
+	J9DebugAgentWatchdog *watchdog; /* NULL if test runs are not bounded in time */
+	J9DebugAgentReport report;
+	J9DebugAgentState state;
+} J9DebugAgentTest;
+
+/**
+ * Read a non-negative integer system property.
+ *
+ * @param vm the Java VM
+ * @param name the name of the system property
+ * @param defaultValue the value to use if the property is not set or is invalid
+ * @return the value of the property
+ */
+static UDATA
+debugAgentGetUDATAProperty(J9JavaVM *vm, const char *name, UDATA defaultValue)
+{
+	J9VMSystemProperty *property = NULL;
+	UDATA value = defaultValue;
+
+	if (J9SYSPROP_ERROR_NONE == vm->internalVMFunctions->getSystemProperty(vm, name, &property)) {
+		char *scanStart = property->value;
+		if ((0 != scan_udata(&scanStart, &value)) || ('\0' != *scanStart)) {
+			fprintf(stderr, "Ignoring invalid value %s for %s\n", property->value, name);
+			value = defaultValue;
+		}
+	}
+
+	return value;
+}
+
+/**
+ * Initialize the rerun policy of the test from the debug agent system properties.
+ */
+static void
+debugAgentInitRerunPolicy(J9JavaVM *vm, J9DebugAgentTest *test)
+{
+	UDATA failureRate = debugAgentGetUDATAProperty(vm, DEBUG_AGENT_FAILURE_RATE_PROPERTY, DEBUG_AGENT_DEFAULT_FAILURE_RATE);
+	UDATA passingFailureRate = debugAgentGetUDATAProperty(vm, DEBUG_AGENT_PASSING_FAILURE_RATE_PROPERTY, DEBUG_AGENT_DEFAULT_PASSING_FAILURE_RATE);
+	UDATA confidence = debugAgentGetUDATAProperty(vm, DEBUG_AGENT_CONFIDENCE_PROPERTY, DEBUG_AGENT_DEFAULT_CONFIDENCE);
+
+	if ((0 == passingFailureRate) || (passingFailureRate >= failureRate) || (failureRate >= 100)) {
+		fprintf(stderr, "Ignoring invalid failure rates %d%% and %d%%\n", (int)failureRate, (int)passingFailureRate);
+		failureRate = DEBUG_AGENT_DEFAULT_FAILURE_RATE;
+		passingFailureRate = DEBUG_AGENT_DEFAULT_PASSING_FAILURE_RATE;
+	}
+
+	if ((confidence <= 50) || (confidence >= 100)) {
+		fprintf(stderr, "Ignoring invalid confidence %d%%\n", (int)confidence);
+		confidence = DEBUG_AGENT_DEFAULT_CONFIDENCE;
+	}
+
+	test->maxRuns = debugAgentGetUDATAProperty(vm, DEBUG_AGENT_MAX_RUNS_PROPERTY, DEBUG_AGENT_DEFAULT_MAX_RUNS);
+	test->failureRate = failureRate / 100.0;
+	test->passingFailureRate = passingFailureRate / 100.0;
+	test->errorRate = (100 - confidence) / 100.0;
+}
+
+/**
+ * Start the investigation report if the report system property names a file to write it to.
+ *
+ * @param vm the Java VM
+ * @param report the report to start
+ */
+static void
+debugAgentOpenReport(J9JavaVM *vm, J9DebugAgentReport *report)
+{
+	J9VMSystemProperty *reportProperty = NULL;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	memset(report, 0, sizeof(J9DebugAgentReport));
+	report->fd = -1;
+	report->startTime = j9time_nano_time();
+	report->verdict = "noCulpritFound";
+	report->culpritInliningAttempt = -1;
+	report->culpritOptIndex = -1;
+	report->culpritOptSubIndex = -1;
+
+	if (J9SYSPROP_ERROR_NONE == vm->internalVMFunctions->getSystemProperty(vm, DEBUG_AGENT_REPORT_PROPERTY, &reportProperty)) {
+		report->fd = j9file_open(reportProperty->value, EsOpenWrite | EsOpenCreate | EsOpenTruncate, 0666);
+		if (-1 == report->fd) {
+			fprintf(stderr, "Could not open report file %s\n", reportProperty->value);
+		} else {
+			j9file_printf(PORTLIB, report->fd, "{\n\t\"events\": [");
+		}
+	}
+}
+
+/**
+ * Append an event to the investigation report.
+ *
+ * @param vm the Java VM
+ * @param report the report
+ * @param format the format of the JSON members of the event
+ */
+static void
+debugAgentReportEvent(J9JavaVM *vm, J9DebugAgentReport *report, const char *format, ...)
+{
+	va_list args;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	if (-1 == report->fd) {
+		return;
+	}
+
+	j9file_printf(PORTLIB, report->fd, "%s\n\t\t{ ", (0 == report->eventCount) ? "" : ",");
+	va_start(args, format);
+	j9file_vprintf(report->fd, format, args);
+	va_end(args);
+	j9file_printf(PORTLIB, report->fd, " }");
+	report->eventCount += 1;
+}
+
+/**
+ * Write a UTF8 string to the investigation report as a JSON string.
+ */
+static void
+debugAgentReportString(J9PortLibrary *portLib, IDATA fd, J9UTF8 *utf8)
+{
+	U_16 i = 0;
+	PORT_ACCESS_FROM_PORT(portLib);
+
+	for (i = 0; i < J9UTF8_LENGTH(utf8); ++i) {
+		U_8 c = J9UTF8_DATA(utf8)[i];
+		if (('"' == c) || ('\\' == c)) {
+			j9file_printf(PORTLIB, fd, "\\%c", c);
+		} else if (c < 0x20) {
+			j9file_printf(PORTLIB, fd, "\\u%04x", (U_32)c);
+		} else {
+			j9file_printf(PORTLIB, fd, "%c", c);
+		}
+	}
+}
+
+/**
+ * Write the summary of the investigation and close the report.
+ *
+ * @param vm the Java VM
+ * @param report the report
+ */
+static void
+debugAgentCloseReport(J9JavaVM *vm, J9DebugAgentReport *report)
+{
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	if (-1 == report->fd) {
+		return;
+	}
+
+	j9file_printf(PORTLIB, report->fd, "\n\t],\n\t\"summary\": {\n");
+	j9file_printf(PORTLIB, report->fd, "\t\t\"candidates\": %zu,\n", report->candidates);
+	j9file_printf(PORTLIB, report->fd, "\t\t\"nonRevertible\": %zu,\n", report->nonRevertible);
+	j9file_printf(PORTLIB, report->fd, "\t\t\"suspects\": %zu,\n", report->suspects);
+	j9file_printf(PORTLIB, report->fd, "\t\t\"reverts\": %zu,\n", report->reverts);
+	j9file_printf(PORTLIB, report->fd, "\t\t\"restores\": %zu,\n", report->restores);
+	j9file_printf(PORTLIB, report->fd, "\t\t\"testRuns\": %zu,\n", report->testRuns);
+	j9file_printf(PORTLIB, report->fd, "\t\t\"testRunTimeUs\": %lld,\n", (long long)(report->testRunTime / 1000));
+	j9file_printf(PORTLIB, report->fd, "\t\t\"recompilations\": %zu,\n", report->recompilations);
+	j9file_printf(PORTLIB, report->fd, "\t\t\"compilationTimeUs\": %zu,\n", report->compilationTime);
+	j9file_printf(PORTLIB, report->fd, "\t\t\"traceLogBytes\": %zu,\n", report->traceLogBytes);
+	j9file_printf(PORTLIB, report->fd, "\t\t\"wallTimeUs\": %lld,\n", (long long)((j9time_nano_time() - report->startTime) / 1000));
+	if (NULL != report->culprit) {
+		J9Class *clazz = J9_CLASS_FROM_METHOD(report->culprit->ramMethod);
+		J9ROMMethod *romMethod = J9_ROM_METHOD_FROM_RAM_METHOD(report->culprit->ramMethod);
+
+		j9file_printf(PORTLIB, report->fd, "\t\t\"culprit\": \"");
+		debugAgentReportString(PORTLIB, report->fd, J9ROMCLASS_CLASSNAME(clazz->romClass));
+		j9file_printf(PORTLIB, report->fd, ".");
+		debugAgentReportString(PORTLIB, report->fd, J9ROMMETHOD_NAME(romMethod));
+		debugAgentReportString(PORTLIB, report->fd, J9ROMMETHOD_SIGNATURE(romMethod));
+		j9file_printf(PORTLIB, report->fd, "\",\n");
+		j9file_printf(PORTLIB, report->fd, "\t\t\"culpritInliningAttempt\": %zd,\n", report->culpritInliningAttempt);
+		j9file_printf(PORTLIB, report->fd, "\t\t\"culpritOptIndex\": %zd,\n", report->culpritOptIndex);
+		j9file_printf(PORTLIB, report->fd, "\t\t\"culpritOptSubIndex\": %zd,\n", report->culpritOptSubIndex);
+		if (NULL != report->culpritOrigin) {
+			j9file_printf(PORTLIB, report->fd, "\t\t\"culpritOrigin\": \"%s\",\n", report->culpritOrigin);
+		}
+	}
+	j9file_printf(PORTLIB, report->fd, "\t\t\"verdict\": \"%s\"\n\t}\n}\n", report->verdict);
+
+	j9file_close(report->fd);
+	report->fd = -1;
+}
+
+/**
+ * Decide whether a class belongs to the reflection machinery between the test method and JITHelpers.invoke.
+ */
+static BOOLEAN
+debugAgentIsReflectionClass(J9UTF8 *className)
+{
+	static const char * const prefixes[] = { "jdk/internal/reflect/", "sun/reflect/", "java/lang/reflect/", "java/lang/invoke/" };
+	UDATA i = 0;
+
+	for (i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); ++i) {
+		UDATA length = strlen(prefixes[i]);
+		if ((J9UTF8_LENGTH(className) >= length) && (0 == memcmp(J9UTF8_DATA(className), prefixes[i], length))) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+typedef struct J9DebugAgentTestFrame {
+	J9ROMClass *romClass;
+	J9ROMMethod *romMethod;
+} J9DebugAgentTestFrame;
+
+/**
+ * Stack trace iterator remembering the last frame outside of the reflection machinery, stopping at JITHelpers.invoke.
+ * That frame is the test method the debug agent reruns.
+ *
+ * @return FALSE once JITHelpers.invoke is reached, TRUE to keep iterating
+ */
+static UDATA
+debugAgentFindTestFrame(J9VMThread *vmThread, void *userData, UDATA bytecodeOffset, J9ROMClass *romClass, J9ROMMethod *romMethod, J9UTF8 *fileName, UDATA lineNumber, J9ClassLoader *classLoader, J9Class *ramClass)
+{
+	J9DebugAgentTestFrame *testFrame = (J9DebugAgentTestFrame *)userData;
+
+	if ((NULL == romClass) || (NULL == romMethod)) {
+		return TRUE;
+	}
+	if (J9UTF8_LITERAL_EQUALS(J9UTF8_DATA(J9ROMCLASS_CLASSNAME(romClass)), J9UTF8_LENGTH(J9ROMCLASS_CLASSNAME(romClass)), "com/ibm/jit/JITHelpers")) {
+		return FALSE;
+	}
+	if (!debugAgentIsReflectionClass(J9ROMCLASS_CLASSNAME(romClass))) {
+		testFrame->romClass = romClass;
+		testFrame->romMethod = romMethod;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Write the signature JIT methods are saved by to the state file.
+ */
+static void
+debugAgentWriteSignature(J9PortLibrary *portLib, IDATA fd, J9Method *ramMethod)
+{
+	J9UTF8 *className = J9ROMCLASS_CLASSNAME(J9_CLASS_FROM_METHOD(ramMethod)->romClass);
+	J9ROMMethod *romMethod = J9_ROM_METHOD_FROM_RAM_METHOD(ramMethod);
+	J9UTF8 *name = J9ROMMETHOD_NAME(romMethod);
+	J9UTF8 *signature = J9ROMMETHOD_SIGNATURE(romMethod);
+	PORT_ACCESS_FROM_PORT(portLib);
+
+	j9file_printf(PORTLIB, fd, "%.*s.%.*s%.*s",
+		(int)J9UTF8_LENGTH(className), J9UTF8_DATA(className),
+		(int)J9UTF8_LENGTH(name), J9UTF8_DATA(name),
+		(int)J9UTF8_LENGTH(signature), J9UTF8_DATA(signature));
+}
+
+/**
+ * Compare a string against a UTF8, returning the rest of the string if it starts with the UTF8 or NULL otherwise.
+ */
+static const char *
+debugAgentMatchUTF8(const char *string, J9UTF8 *utf8)
+{
+	if ((NULL != string) && (0 == strncmp(string, (const char *)J9UTF8_DATA(utf8), J9UTF8_LENGTH(utf8)))) {
+		return string + J9UTF8_LENGTH(utf8);
+	}
+	return NULL;
+}
+
+/**
+ * Decide whether a signature read from the state file is the signature of the given JIT method.
+ */
+static BOOLEAN
+debugAgentMatchesSignature(J9JITExceptionTable *jitMethod, const char *signature)
+{
+	J9ROMMethod *romMethod = J9_ROM_METHOD_FROM_RAM_METHOD(jitMethod->ramMethod);
+
+	signature = debugAgentMatchUTF8(signature, J9ROMCLASS_CLASSNAME(J9_CLASS_FROM_METHOD(jitMethod->ramMethod)->romClass));
+	if ((NULL == signature) || ('.' != *signature)) {
+		return FALSE;
+	}
+	signature = debugAgentMatchUTF8(signature + 1, J9ROMMETHOD_NAME(romMethod));
+	signature = debugAgentMatchUTF8(signature, J9ROMMETHOD_SIGNATURE(romMethod));
+
+	return (NULL != signature) && ('\0' == *signature);
+}
+
+/**
+ * Continue hashing a signature with the given bytes.
+ */
+static UDATA
+debugAgentHashSignatureBytes(UDATA hash, const U_8 *data, UDATA length)
+{
+	UDATA i = 0;
+
+	for (i = 0; i < length; ++i) {
+		hash = (hash * 31) + data[i];
+	}
+	return hash;
+}
+
+/**
+ * Hash a signature read from the state file, or the signature of a JIT method as it would be written to the state file.
+ */
+static UDATA
+debugAgentSignatureHashFn(void *item, void *userData)
+{
+	J9DebugAgentSignatureEntry *entry = (J9DebugAgentSignatureEntry *)item;
+	J9ROMMethod *romMethod = NULL;
+	J9UTF8 *className = NULL;
+	UDATA hash = 0;
+
+	if (NULL != entry->signature) {
+		return debugAgentHashSignatureBytes(0, (const U_8 *)entry->signature, strlen(entry->signature));
+	}
+
+	romMethod = J9_ROM_METHOD_FROM_RAM_METHOD(entry->jitMethod->ramMethod);
+	className = J9ROMCLASS_CLASSNAME(J9_CLASS_FROM_METHOD(entry->jitMethod->ramMethod)->romClass);
+	hash = debugAgentHashSignatureBytes(hash, J9UTF8_DATA(className), J9UTF8_LENGTH(className));
+	hash = debugAgentHashSignatureBytes(hash, (const U_8 *)".", 1);
+	hash = debugAgentHashSignatureBytes(hash, J9UTF8_DATA(J9ROMMETHOD_NAME(romMethod)), J9UTF8_LENGTH(J9ROMMETHOD_NAME(romMethod)));
+	return debugAgentHashSignatureBytes(hash, J9UTF8_DATA(J9ROMMETHOD_SIGNATURE(romMethod)), J9UTF8_LENGTH(J9ROMMETHOD_SIGNATURE(romMethod)));
+}
+
+/**
+ * Compare signatures read from the state file and signatures of JIT methods with each other.
+ */
+static UDATA
+debugAgentSignatureHashEqualFn(void *left, void *right, void *userData)
+{
+	J9DebugAgentSignatureEntry *leftEntry = (J9DebugAgentSignatureEntry *)left;
+	J9DebugAgentSignatureEntry *rightEntry = (J9DebugAgentSignatureEntry *)right;
+
+	if ((NULL != leftEntry->signature) && (NULL != rightEntry->signature)) {
+		return 0 == strcmp(leftEntry->signature, rightEntry->signature);
+	} else if (NULL != leftEntry->signature) {
+		return debugAgentMatchesSignature(rightEntry->jitMethod, leftEntry->signature);
+	} else if (NULL != rightEntry->signature) {
+		return debugAgentMatchesSignature(leftEntry->jitMethod, rightEntry->signature);
+	}
+	return leftEntry->jitMethod == rightEntry->jitMethod;
+}
+
+/**
+ * Find the test method on the stack trace of the failure and prepare to save the investigation if the state system
+ * property names a file to save it to.
+ *
+ * @param test the test the investigation is for
+ * @param failure the exception which triggered the debug agent, or NULL if unknown
+ */
+static void
+debugAgentOpenState(J9DebugAgentTest *test, jthrowable failure)
+{
+	J9VMThread *vmThread = (J9VMThread *)test->env;
+	J9JavaVM *vm = vmThread->javaVM;
+	J9DebugAgentState *state = &test->state;
+	J9VMSystemProperty *stateProperty = NULL;
+	J9DebugAgentTestFrame testFrame = { NULL, NULL };
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	memset(state, 0, sizeof(J9DebugAgentState));
+	state->passingOptIndex = -1;
+	state->failingOptIndex = -1;
+
+	if (J9SYSPROP_ERROR_NONE != vm->internalVMFunctions->getSystemProperty(vm, DEBUG_AGENT_STATE_PROPERTY, &stateProperty)) {
+		return;
+	}
+
+	if (NULL != failure) {
+		vm->internalVMFunctions->internalEnterVMFromJNI(vmThread);
+		vm->internalVMFunctions->iterateStackTrace(vmThread, (j9object_t *)failure, debugAgentFindTestFrame, &testFrame, FALSE, TRUE);
+		vm->internalVMFunctions->internalExitVMToJNI(vmThread);
+	}
+
+	if (NULL == testFrame.romMethod) {
+		fprintf(stderr, "Could not find the test method on the stack trace, the investigation is not saved\n");
+		return;
+	} else {
+		J9UTF8 *className = J9ROMCLASS_CLASSNAME(testFrame.romClass);
+		J9UTF8 *name = J9ROMMETHOD_NAME(testFrame.romMethod);
+		J9UTF8 *signature = J9ROMMETHOD_SIGNATURE(testFrame.romMethod);
+		UDATA length = J9UTF8_LENGTH(className) + J9UTF8_LENGTH(name) + J9UTF8_LENGTH(signature) + 2;
+
+		state->identity = j9mem_allocate_memory(length, J9MEM_CATEGORY_VM_JCL);
+		if (NULL == state->identity) {
+			fprintf(stderr, "Could not allocate memory for the test identity\n");
+			return;
+		}
+		j9str_printf(PORTLIB, state->identity, length, "%.*s.%.*s%.*s",
+			(int)J9UTF8_LENGTH(className), J9UTF8_DATA(className),
+			(int)J9UTF8_LENGTH(name), J9UTF8_DATA(name),
+			(int)J9UTF8_LENGTH(signature), J9UTF8_DATA(signature));
+	}
+
+	state->path = stateProperty->value;
+}
+
+/**
+ * Save the progress of the investigation, replacing the state file only once the new state is completely written so
+ * that a JVM which dies while saving leaves the previous state behind.
+ *
+ * @param test the test the investigation is for
+ */
+static void
+debugAgentSaveState(J9DebugAgentTest *test)
+{
+	J9JavaVM *vm = ((J9VMThread *)test->env)->javaVM;
+	J9DebugAgentState *state = &test->state;
+	char *tmpPath = NULL;
+	UDATA tmpPathLength = 0;
+	IDATA fd = -1;
+	UDATA i = 0;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	if (NULL == state->path) {
+		return;
+	}
+
+	tmpPathLength = strlen(state->path) + sizeof(".tmp");
+	tmpPath = j9mem_allocate_memory(tmpPathLength, J9MEM_CATEGORY_VM_JCL);
+	if (NULL == tmpPath) {
+		fprintf(stderr, "Could not allocate memory to save the state\n");
+		return;
+	}
+	j9str_printf(PORTLIB, tmpPath, tmpPathLength, "%s.tmp", state->path);
+
+	fd = j9file_open(tmpPath, EsOpenWrite | EsOpenCreate | EsOpenTruncate, 0666);
+	if (-1 == fd) {
+		fprintf(stderr, "Could not open state file %s\n", tmpPath);
+		j9mem_free_memory(tmpPath);
+		return;
+	}
+
+	j9file_printf(PORTLIB, fd, "identity %s\n", state->identity);
+	for (i = 0; i < state->jitMethodCount; ++i) {
+		J9JITExceptionTable *jitMethod = state->jitMethods[i];
+		BOOLEAN candidate = (NULL != state->culprit) ? (jitMethod == state->culprit) : ((i >= state->low) && (i < state->high));
+
+		j9file_printf(PORTLIB, fd, "%s ", candidate ? "candidate" : "cleared");
+		debugAgentWriteSignature(PORTLIB, fd, jitMethod->ramMethod);
+		j9file_printf(PORTLIB, fd, "\n");
+	}
+	if (NULL != state->culprit) {
+		j9file_printf(PORTLIB, fd, "culprit ");
+		debugAgentWriteSignature(PORTLIB, fd, state->culprit->ramMethod);
+		j9file_printf(PORTLIB, fd, "\n");
+	}
+	if (state->originSearched) {
+		j9file_printf(PORTLIB, fd, "origin %s\n", (NULL != test->report.culpritOrigin) ? test->report.culpritOrigin : "unknown");
+	}
+	if (state->inlinedCallSitesSearched) {
+		j9file_printf(PORTLIB, fd, "maxInlinedCallSites %zd\n", test->maxInlinedCallSites);
+	}
+	if (state->optimizationsSearched) {
+		j9file_printf(PORTLIB, fd, "disabledOptimizations %zu", test->disabledOptimizationCount);
+		for (i = 0; i < test->disabledOptimizationCount; ++i) {
+			j9file_printf(PORTLIB, fd, " %zd", test->disabledOptimizations[i]);
+		}
+		j9file_printf(PORTLIB, fd, "\n");
+	}
+	if (state->failingOptIndex >= 0) {
+		j9file_printf(PORTLIB, fd, "optIndex %zd %zd\n", state->passingOptIndex, state->failingOptIndex);
+	}
+	j9file_close(fd);
+
+	j9file_unlink(state->path);
+	if (0 != j9file_move(tmpPath, state->path)) {
+		fprintf(stderr, "Could not save state file %s\n", state->path);
+	}
+	j9mem_free_memory(tmpPath);
+}
+
+/**
+ * Record the JIT methods in [low, high) as the remaining candidates of the method search and save the state.
+ */
+static void
+debugAgentSaveCandidates(J9DebugAgentTest *test, UDATA low, UDATA high)
+{
+	test->state.low = low;
+	test->state.high = high;
+	debugAgentSaveState(test);
+}
+
+/**
+ * Record the interval the lastOptIndex search has narrowed the culprit optimization down to and save the state.
+ */
+static void
+debugAgentSaveOptIndexInterval(J9DebugAgentTest *test, IDATA passingOptIndex, IDATA failingOptIndex)
+{
+	test->state.passingOptIndex = passingOptIndex;
+	test->state.failingOptIndex = failingOptIndex;
+	debugAgentSaveState(test);
+}
+
+/**
+ * Read a non-negative integer, or -1, preceded by a space from a line of the state file.
+ *
+ * @return TRUE if an integer was read, FALSE otherwise
+ */
+static BOOLEAN
+debugAgentScanStateValue(char **scanStart, IDATA *value)
+{
+	if (' ' != **scanStart) {
+		return FALSE;
+	}
+	*scanStart += 1;
+	return 0 == scan_idata(scanStart, value);
+}
+
+/**
+ * Load the state saved by an earlier JVM which investigated the same test. JIT methods cleared by that investigation
+ * are moved behind the remaining candidates, and the outcomes of the searches it completed are restored. JIT methods
+ * compiled by this JVM only are kept as candidates.
+ *
+ * @param test the test the investigation is for
+ * @param jitMethods the JIT methods
+ * @param jitMethodCount the number of JIT methods
+ * @return the number of candidates at the front of the JIT methods
+ */
+static UDATA
+debugAgentResumeState(J9DebugAgentTest *test, J9JITExceptionTable **jitMethods, UDATA jitMethodCount)
+{
+	J9JavaVM *vm = ((J9VMThread *)test->env)->javaVM;
+	J9DebugAgentState *state = &test->state;
+	J9JITExceptionTable **clearedMethods = NULL;
+	J9HashTable *clearedSignatures = NULL;
+	UDATA clearedCount = 0;
+	UDATA candidateCount = 0;
+	I_64 fileLength = 0;
+	IDATA length = 0;
+	IDATA fd = -1;
+	char *buffer = NULL;
+	char *end = NULL;
+	char *line = NULL;
+	const char *culpritSignature = NULL;
+	UDATA i = 0;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	state->jitMethods = jitMethods;
+	state->jitMethodCount = jitMethodCount;
+	state->low = 0;
+	state->high = jitMethodCount;
+
+	if (NULL == state->path) {
+		return jitMethodCount;
+	}
+
+	fileLength = j9file_length(state->path);
+	if ((fileLength <= 0) || (fileLength > J9CONST64(0x7FFFFFFF))) {
+		fprintf(stderr, "Saving the investigation to %s\n", state->path);
+		return jitMethodCount;
+	}
+	length = (IDATA)fileLength;
+
+	buffer = j9mem_allocate_memory(length + 1, J9MEM_CATEGORY_VM_JCL);
+	clearedMethods = j9mem_allocate_memory((jitMethodCount + 1) * sizeof(J9JITExceptionTable *), J9MEM_CATEGORY_VM_JCL);
+	if ((NULL == buffer) || (NULL == clearedMethods)) {
+		fprintf(stderr, "Could not allocate memory to load state file %s\n", state->path);
+		goto done;
+	}
+
+	fd = j9file_open(state->path, EsOpenRead, 0);
+	if ((-1 == fd) || (length != j9file_read(fd, buffer, length))) {
+		fprintf(stderr, "Could not read state file %s\n", state->path);
+		goto done;
+	}
+
+	/* Split the file into NUL terminated lines */
+	buffer[length] = '\0';
+	end = buffer + length;
+	for (line = buffer; line < end; ++line) {
+		if ('\n' == *line) {
+			*line = '\0';
+		}
+	}
+
+	if ((0 != strncmp(buffer, "identity ", sizeof("identity ") - 1)) || (0 != strcmp(buffer + sizeof("identity ") - 1, state->identity))) {
+		fprintf(stderr, "State file %s is for another test, starting a new investigation\n", state->path);
+		goto done;
+	}
+
+	/* Index the signatures of the cleared JIT methods so that each JIT method is looked up once */
+	clearedSignatures = hashTableNew(OMRPORT_FROM_J9PORT(PORTLIB), J9_GET_CALLSITE(), 0, sizeof(J9DebugAgentSignatureEntry), sizeof(char *), 0,
+		J9MEM_CATEGORY_VM_JCL, debugAgentSignatureHashFn, debugAgentSignatureHashEqualFn, NULL, NULL);
+	if (NULL == clearedSignatures) {
+		fprintf(stderr, "Could not allocate memory to load state file %s\n", state->path);
+		goto done;
+	}
+	for (line = buffer; line < end; line += strlen(line) + 1) {
+		if (0 == strncmp(line, "cleared ", sizeof("cleared ") - 1)) {
+			J9DebugAgentSignatureEntry entry;
+
+			entry.signature = line + sizeof("cleared ") - 1;
+			entry.jitMethod = NULL;
+			if (NULL == hashTableAdd(clearedSignatures, &entry)) {
+				fprintf(stderr, "Could not allocate memory to load state file %s\n", state->path);
+				goto done;
+			}
+		}
+	}
+
+	/* Move the cleared JIT methods behind the candidates, keeping the order of both */
+	for (i = 0; i < jitMethodCount; ++i) {
+		J9JITExceptionTable *jitMethod = jitMethods[i];
+		J9DebugAgentSignatureEntry query;
+
+		query.signature = NULL;
+		query.jitMethod = jitMethod;
+		if (NULL != hashTableFind(clearedSignatures, &query)) {
+			clearedMethods[clearedCount++] = jitMethod;
+		} else {
+			jitMethods[candidateCount++] = jitMethod;
+		}
+	}
+	memcpy(jitMethods + candidateCount, clearedMethods, clearedCount * sizeof(J9JITExceptionTable *));
+	state->high = candidateCount;
+
+	for (line = buffer; line < end; line += strlen(line) + 1) {
+		if (0 == strncmp(line, "culprit ", sizeof("culprit ") - 1)) {
+			culpritSignature = line + sizeof("culprit ") - 1;
+			for (i = 0; (i < candidateCount) && (NULL == state->culprit); ++i) {
+				if (debugAgentMatchesSignature(jitMethods[i], culpritSignature)) {
+					state->culprit = jitMethods[i];
+				}
+			}
+		}
+	}
+
+	if ((NULL != culpritSignature) && (NULL == state->culprit)) {
+		fprintf(stderr, "Culprit %s is not compiled in this run, searching the remaining candidates again\n", culpritSignature);
+	}
+
+	/* The outcomes of the later searches are only meaningful for the culprit they were found for */
+	for (line = buffer; (NULL != state->culprit) && (line < end); line += strlen(line) + 1) {
+		char *scanStart = NULL;
+		IDATA value = 0;
+
+		if (0 == strncmp(line, "origin ", sizeof("origin ") - 1)) {
+			static const char * const origins[] = {
+				DEBUG_AGENT_ORIGIN_JIT_BODY, DEBUG_AGENT_ORIGIN_JIT_COMPILATION, DEBUG_AGENT_ORIGIN_AOT_COMPILATION, DEBUG_AGENT_ORIGIN_SCC_LOAD
+			};
+			const char *origin = line + sizeof("origin ") - 1;
+
+			for (i = 0; i < sizeof(origins) / sizeof(origins[0]); ++i) {
+				if (0 == strcmp(origin, origins[i])) {
+					test->report.culpritOrigin = origins[i];
+				}
+			}
+			if (test->report.culpritOrigin == DEBUG_AGENT_ORIGIN_JIT_COMPILATION) {
+				test->bodyKind = J9_DEBUG_AGENT_RECOMPILE_JIT;
+			} else if (test->report.culpritOrigin == DEBUG_AGENT_ORIGIN_AOT_COMPILATION) {
+				test->bodyKind = J9_DEBUG_AGENT_RECOMPILE_AOT;
+			}
+			state->originSearched = TRUE;
+		} else if (0 == strncmp(line, "maxInlinedCallSites", sizeof("maxInlinedCallSites") - 1)) {
+			scanStart = line + sizeof("maxInlinedCallSites") - 1;
+			if (debugAgentScanStateValue(&scanStart, &value)) {
+				test->maxInlinedCallSites = value;
+				state->inlinedCallSitesSearched = TRUE;
+			}
+		} else if (0 == strncmp(line, "disabledOptimizations", sizeof("disabledOptimizations") - 1)) {
+			scanStart = line + sizeof("disabledOptimizations") - 1;
+			if (debugAgentScanStateValue(&scanStart, &value) && (value >= 0)) {
+				test->disabledOptimizations = j9mem_allocate_memory(OMR_MAX(value, 1) * sizeof(IDATA), J9MEM_CATEGORY_VM_JCL);
+				if (NULL != test->disabledOptimizations) {
+					test->disabledOptimizationCount = 0;
+					while (((IDATA)test->disabledOptimizationCount < value)
+						&& debugAgentScanStateValue(&scanStart, &test->disabledOptimizations[test->disabledOptimizationCount])
+					) {
+						test->disabledOptimizationCount += 1;
+					}
+					state->optimizationsSearched = ((IDATA)test->disabledOptimizationCount == value);
+					if (!state->optimizationsSearched) {
+						test->disabledOptimizationCount = 0;
+					}
+				}
+			}
+		} else if (0 == strncmp(line, "optIndex", sizeof("optIndex") - 1)) {
+			IDATA failingOptIndex = 0;
+
+			scanStart = line + sizeof("optIndex") - 1;
+			if (debugAgentScanStateValue(&scanStart, &value) && debugAgentScanStateValue(&scanStart, &failingOptIndex)) {
+				state->passingOptIndex = value;
+				state->failingOptIndex = failingOptIndex;
+			}
+		}
+	}
+
+	fprintf(stderr, "Resuming the investigation saved to %s with %d of %d JIT methods left as candidates\n",
+		state->path, (int)candidateCount, (int)jitMethodCount);
+	debugAgentReportEvent(vm, &test->report, "\"event\": \"resumed\", \"candidates\": %zu, \"culpritKnown\": %s",
+		candidateCount, (NULL != state->culprit) ? "true" : "false");
+
+done:
+	if (-1 != fd) {
+		j9file_close(fd);
+	}
+	if (NULL != clearedSignatures) {
+		hashTableFree(clearedSignatures);
+	}
+	j9mem_free_memory(buffer);
+	j9mem_free_memory(clearedMethods);
+
+	return state->high;
+}
+
+/**
+ * Async event handler which throws the timeout exception into the test thread once its test run has exceeded the time
+ * budget. The exception is thrown the same way Thread.stop() throws, right after the async event is handled.
+ *
+ * @param currentThread the current thread
+ * @param handlerKey the async event key
+ * @param userData the watchdog
+ */
+static void
+debugAgentWatchdogAsyncHandler(J9VMThread *currentThread, IDATA handlerKey, void *userData)
+{
+	J9DebugAgentWatchdog *watchdog = (J9DebugAgentWatchdog *)userData;
+
+	omrthread_monitor_enter(watchdog->monitor);
+	/* The test run may have finished between the async event being signaled and handled */
+	if (watchdog->timedOut && (currentThread == watchdog->testThread)) {
+		omrthread_monitor_enter(currentThread->publicFlagsMutex);
+		currentThread->stopThrowable = J9_JNI_UNWRAP_REFERENCE(watchdog->timeoutException);
+		currentThread->javaVM->internalVMFunctions->setHaltFlag(currentThread, J9_PUBLIC_FLAGS_STOP);
+		omrthread_monitor_exit(currentThread->publicFlagsMutex);
+	}
+	omrthread_monitor_exit(watchdog->monitor);
+}
+
+static int J9THREAD_PROC
+debugAgentWatchdogThreadProc(void *entryArg)
+{
+	J9DebugAgentWatchdog *watchdog = (J9DebugAgentWatchdog *)entryArg;
+	J9JavaVM *vm = watchdog->vm;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	omrthread_monitor_enter(watchdog->monitor);
+	while (DEBUG_AGENT_WATCHDOG_RUNNING == watchdog->state) {
+		if ((0 == watchdog->deadline) || (0 == watchdog->budget)) {
+			omrthread_monitor_wait(watchdog->monitor);
+		} else {
+			I_64 now = j9time_current_time_millis();
+			if (now < watchdog->deadline) {
+				omrthread_monitor_wait_timed(watchdog->monitor, watchdog->deadline - now, 0);
+			} else {
+				fprintf(stderr, "Test exceeded its time budget of %d ms, interrupting it\n", (int)watchdog->budget);
+				watchdog->deadline = 0;
+				watchdog->timedOut = TRUE;
+				vm->internalVMFunctions->J9SignalAsyncEvent(vm, watchdog->testThread, watchdog->asyncEventKey);
+			}
+		}
+	}
+
+	watchdog->state = DEBUG_AGENT_WATCHDOG_STOPPED;
+	omrthread_monitor_notify_all(watchdog->monitor);
+	omrthread_exit(watchdog->monitor);
+	return 0;
+}
+
+/**
+ * Start the time budget of a test run. The first run is bounded by the calibration timeout since the time budget is
+ * calibrated from it.
+ *
+ * @param watchdog the watchdog
+ */
+static void
+debugAgentArmWatchdog(J9DebugAgentWatchdog *watchdog)
+{
+	PORT_ACCESS_FROM_JAVAVM(watchdog->vm);
+
+	omrthread_monitor_enter(watchdog->monitor);
+	watchdog->timedOut = FALSE;
+	watchdog->startTime = j9time_current_time_millis();
+	if (0 != watchdog->budget) {
+		watchdog->deadline = watchdog->startTime + watchdog->budget;
+		omrthread_monitor_notify_all(watchdog->monitor);
+	}
+	omrthread_monitor_exit(watchdog->monitor);
+}
+
+/**
+ * End the time budget of a test run, calibrating the time budget if this was the first run.
+ *
+ * @param watchdog the watchdog
+ * @return TRUE if the test run exceeded its time budget, FALSE otherwise
+ */
+static BOOLEAN
+debugAgentDisarmWatchdog(J9DebugAgentWatchdog *watchdog)
+{
+	BOOLEAN timedOut = FALSE;
+	PORT_ACCESS_FROM_JAVAVM(watchdog->vm);
+
+	omrthread_monitor_enter(watchdog->monitor);
+	if (!watchdog->calibrated) {
+		/* A first run which timed out tells nothing about the duration of a test run, keep the calibration timeout */
+		if (!watchdog->timedOut) {
+			I_64 duration = j9time_current_time_millis() - watchdog->startTime;
+			watchdog->budget = OMR_MAX(duration * (I_64)watchdog->budgetFactor, DEBUG_AGENT_MIN_TIMEOUT);
+			fprintf(stderr, "Test ran for %d ms, setting the time budget of each test run to %d ms\n", (int)duration, (int)watchdog->budget);
+		}
+		watchdog->calibrated = TRUE;
+	}
+	timedOut = watchdog->timedOut;
+	watchdog->timedOut = FALSE;
+	watchdog->deadline = 0;
+	omrthread_monitor_exit(watchdog->monitor);
+
+	return timedOut;
+}
+
+/**
+ * Start a watchdog which interrupts test runs exceeding their time budget. The time budget is given in milliseconds by
+ * the timeout system property, or calibrated as a multiple of the duration of the first test run. Until then test runs
+ * are bounded by the calibration timeout system property.
+ *
+ * @param test the test to watch over
+ * @return the watchdog, or NULL if test runs are not bounded in time
+ */
+static J9DebugAgentWatchdog *
+debugAgentStartWatchdog(J9DebugAgentTest *test)
+{
+	JNIEnv *env = test->env;
 	J9VMThread *vmThread = (J9VMThread *)env;
+	J9JavaVM *vm = vmThread->javaVM;
+	J9DebugAgentWatchdog *watchdog = NULL;
+	UDATA timeout = debugAgentGetUDATAProperty(vm, DEBUG_AGENT_TIMEOUT_PROPERTY, DEBUG_AGENT_DEFAULT_TIMEOUT);
+	UDATA timeoutFactor = debugAgentGetUDATAProperty(vm, DEBUG_AGENT_TIMEOUT_FACTOR_PROPERTY, DEBUG_AGENT_DEFAULT_TIMEOUT_FACTOR);
+	UDATA calibrationTimeout = debugAgentGetUDATAProperty(vm, DEBUG_AGENT_CALIBRATION_TIMEOUT_PROPERTY, DEBUG_AGENT_DEFAULT_CALIBRATION_TIMEOUT);
+	jclass timeoutExceptionClass = NULL;
+	jmethodID timeoutExceptionInit = NULL;
+	jstring timeoutMessage = NULL;
+	jobject timeoutException = NULL;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	if ((0 == timeout) && (0 == timeoutFactor)) {
+		return NULL;
+	}
+
+	watchdog = j9mem_allocate_memory(sizeof(J9DebugAgentWatchdog), J9MEM_CATEGORY_VM_JCL);
+	if (NULL == watchdog) {
+		fprintf(stderr, "Could not allocate memory for the watchdog\n");
+		return NULL;
+	}
+	memset(watchdog, 0, sizeof(J9DebugAgentWatchdog));
+	watchdog->vm = vm;
+	watchdog->testThread = vmThread;
+	watchdog->calibrated = (0 != timeout);
+	watchdog->budget = watchdog->calibrated ? (I_64)timeout : (I_64)calibrationTimeout;
+	watchdog->budgetFactor = timeoutFactor;
+	watchdog->asyncEventKey = -1;
+	watchdog->state = DEBUG_AGENT_WATCHDOG_RUNNING;
+
+	timeoutExceptionClass = (*env)->FindClass(env, "java/util/concurrent/TimeoutException");
+	if (NULL != timeoutExceptionClass) {
+		timeoutExceptionInit = (*env)->GetMethodID(env, timeoutExceptionClass, "<init>", "(Ljava/lang/String;)V");
+		timeoutMessage = (*env)->NewStringUTF(env, "JIT debug agent test run exceeded its time budget");
+	}
+	if ((NULL != timeoutExceptionInit) && (NULL != timeoutMessage)) {
+		timeoutException = (*env)->NewObject(env, timeoutExceptionClass, timeoutExceptionInit, timeoutMessage);
+	}
+	if (NULL != timeoutException) {
+		watchdog->timeoutException = (*env)->NewGlobalRef(env, timeoutException);
+	}
+	(*env)->ExceptionClear(env);
+	(*env)->DeleteLocalRef(env, timeoutException);
+	(*env)->DeleteLocalRef(env, timeoutMessage);
+	(*env)->DeleteLocalRef(env, timeoutExceptionClass);
+	if (NULL == watchdog->timeoutException) {
+		fprintf(stderr, "Could not create the watchdog timeout exception\n");
+		goto fail;
+	}
+
+	watchdog->asyncEventKey = vm->internalVMFunctions->J9RegisterAsyncEvent(vm, debugAgentWatchdogAsyncHandler, watchdog);
+	if (watchdog->asyncEventKey < 0) {
+		fprintf(stderr, "Could not register the watchdog async event\n");
+		goto fail;
+	}
+
+	if (0 != omrthread_monitor_init_with_name(&watchdog->monitor, 0, "JIT debug agent watchdog")) {
+		fprintf(stderr, "Could not create the watchdog monitor\n");
+		goto fail;
+	}
+
+	if (0 != omrthread_create(&watchdog->thread, vm->defaultOSStackSize, J9THREAD_PRIORITY_NORMAL, FALSE, debugAgentWatchdogThreadProc, watchdog)) {
+		fprintf(stderr, "Could not start the watchdog thread\n");
+		omrthread_monitor_destroy(watchdog->monitor);
+		goto fail;
+	}
+
+	return watchdog;
+
+fail:
+	if (watchdog->asyncEventKey >= 0) {
+		vm->internalVMFunctions->J9UnregisterAsyncEvent(vm, watchdog->asyncEventKey);
+	}
+	if (NULL != watchdog->timeoutException) {
+		(*env)->DeleteGlobalRef(env, watchdog->timeoutException);
+	}
+	j9mem_free_memory(watchdog);
+	return NULL;
+}
+
+/**
+ * Stop the watchdog of a test and wait for its thread to exit.
+ *
+ * @param test the test the watchdog watches over
+ */
+static void
+debugAgentStopWatchdog(J9DebugAgentTest *test)
+{
+	JNIEnv *env = test->env;
+	J9DebugAgentWatchdog *watchdog = test->watchdog;
+	J9JavaVM *vm = ((J9VMThread *)env)->javaVM;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	if (NULL == watchdog) {
+		return;
+	}
+
+	omrthread_monitor_enter(watchdog->monitor);
+	watchdog->state = DEBUG_AGENT_WATCHDOG_STOPPING;
+	omrthread_monitor_notify_all(watchdog->monitor);
+	while (DEBUG_AGENT_WATCHDOG_STOPPED != watchdog->state) {
+		omrthread_monitor_wait(watchdog->monitor);
+	}
+	omrthread_monitor_exit(watchdog->monitor);
+
+	vm->internalVMFunctions->J9UnregisterAsyncEvent(vm, watchdog->asyncEventKey);
+	omrthread_monitor_destroy(watchdog->monitor);
+	(*env)->DeleteGlobalRef(env, watchdog->timeoutException);
+	j9mem_free_memory(watchdog);
+	test->watchdog = NULL;
+}
+
+/**
+ * Invoke the test once through its MethodAccessor.
+ *
+ * @param test the test to run
+ * @return DEBUG_AGENT_TEST_PASSED if the test completed normally, DEBUG_AGENT_TEST_FAILED if it threw an
+ * InvocationTargetException or exceeded its time budget, or DEBUG_AGENT_TEST_ERROR if it threw anything else
+ */
+static UDATA
+debugAgentInvokeTest(J9DebugAgentTest *test)
+{
+	JNIEnv *env = test->env;
+	J9JavaVM *vm = ((J9VMThread *)env)->javaVM;
+	J9DebugAgentWatchdog *watchdog = test->watchdog;
+	UDATA result = DEBUG_AGENT_TEST_PASSED;
+	BOOLEAN timedOut = FALSE;
+	I_64 startTime = 0;
+	I_64 testRunTime = 0;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	if (NULL != watchdog) {
+		debugAgentArmWatchdog(watchdog);
+	}
+
+	startTime = j9time_nano_time();
+	(*env)->CallObjectMethod(env, test->ma, test->invoke, test->obj, test->args);
+	testRunTime = j9time_nano_time() - startTime;
+
+	if (NULL != watchdog) {
+		timedOut = debugAgentDisarmWatchdog(watchdog);
+	}
+
+	if ((*env)->ExceptionCheck(env)) {
+		jthrowable exceptionObject = (*env)->ExceptionOccurred(env);
+		(*env)->ExceptionClear(env);
+
+		/* The timeout exception may have been thrown outside of the test itself, it is a failure either way */
+		if (timedOut || (*env)->IsInstanceOf(env, exceptionObject, test->invocationTargetException)) {
+			result = DEBUG_AGENT_TEST_FAILED;
+		} else {
+			fprintf(stderr, "Unknown exception occured\n");
+			result = DEBUG_AGENT_TEST_ERROR;
+		}
+
+		(*env)->DeleteLocalRef(env, exceptionObject);
+	}
+
+	test->report.testRuns += 1;
+	test->report.testRunTime += testRunTime;
+	debugAgentReportEvent(vm, &test->report, "\"event\": \"testRun\", \"result\": \"%s\", \"timedOut\": %s, \"timeUs\": %lld",
+		(DEBUG_AGENT_TEST_PASSED == result) ? "passed" : ((DEBUG_AGENT_TEST_FAILED == result) ? "failed" : "error"),
+		timedOut ? "true" : "false", (long long)(testRunTime / 1000));
+
+	return result;
+}
+
+/**
+ * Decide whether the test passes or fails in the current configuration of the JIT methods. With a single run per probe
+ * the test is invoked once. Otherwise the test is rerun until a sequential probability ratio test accepts either the
+ * hypothesis that it fails at the expected failure rate, or that it fails at most at the tolerated passing failure
+ * rate, with the configured confidence. If neither is accepted within the maximum number of runs the likelier
+ * hypothesis wins.
+ *
+ * @param test the test to run
+ * @return DEBUG_AGENT_TEST_PASSED, DEBUG_AGENT_TEST_FAILED, or DEBUG_AGENT_TEST_ERROR if any run threw an unexpected
+ * exception
+ */
+static UDATA
+debugAgentRunTest(J9DebugAgentTest *test)
+{
+	double failureRatio = test->failureRate / test->passingFailureRate;
+	double passRatio = (1.0 - test->failureRate) / (1.0 - test->passingFailureRate);
+	double acceptFailure = (1.0 - test->errorRate) / test->errorRate;
+	double acceptPass = test->errorRate / (1.0 - test->errorRate);
+	double likelihoodRatio = 1.0;
+	BOOLEAN decided = FALSE;
+	UDATA runs = 0;
+	UDATA failures = 0;
+
+	if (test->maxRuns <= 1) {
+		return debugAgentInvokeTest(test);
+	}
+
+	while (!decided && (runs < test->maxRuns)) {
+		UDATA result = debugAgentInvokeTest(test);
+		if (DEBUG_AGENT_TEST_ERROR == result) {
+			return DEBUG_AGENT_TEST_ERROR;
+		}
+
+		runs += 1;
+		if (DEBUG_AGENT_TEST_FAILED == result) {
+			failures += 1;
+			likelihoodRatio *= failureRatio;
+		} else {
+			likelihoodRatio *= passRatio;
+		}
+
+		decided = (likelihoodRatio >= acceptFailure) || (likelihoodRatio <= acceptPass);
+	}
+
+	fprintf(stderr, "Test failed %d of %d runs, failure rate = %d%%%s\n", (int)failures, (int)runs, (int)((failures * 100) / runs),
+		decided ? "" : ", no verdict within the maximum number of runs");
+
+	return (likelihoodRatio >= 1.0) ? DEBUG_AGENT_TEST_FAILED : DEBUG_AGENT_TEST_PASSED;
+}
+
+/**
+ * Remove the JIT methods which cannot be reverted from the search, keeping the order of the others. Reverting them
+ * would leave their callers executing them, so they would look innocent even if they were the culprit.
+ *
+ * @return the number of JIT methods left
+ */
+static UDATA
+debugAgentExcludeNonRevertible(J9DebugAgentTest *test, J9JITExceptionTable **jitMethods, UDATA jitMethodCount)
+{
+	J9VMThread *vmThread = (J9VMThread *)test->env;
 	J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
-	jitConfig->debugAgentStart(vmThread);
+	UDATA revertibleCount = 0;
+	UDATA i = 0;
 
-	jclass java_lang_Long = (*env)->FindClass(env, "java/lang/Long");
-	jmethodID java_lang_Long_longValue = (*env)->GetMethodID(env, java_lang_Long, "longValue", "()J");
+	for (i = 0; i < jitMethodCount; ++i) {
+		if (jitConfig->debugAgentIsRevertible(vmThread, jitMethods[i])) {
+			jitMethods[revertibleCount++] = jitMethods[i];
+		}
+	}
+	test->report.nonRevertible = jitMethodCount - revertibleCount;
+	if (0 != test->report.nonRevertible) {
+		fprintf(stderr, "Excluding %d JIT methods without a switch to interpreter pre-prologue, they cannot be reverted\n",
+			(int)test->report.nonRevertible);
+	}
 
-	jclass java_util_HashSet = (*env)->FindClass(env, "java/util/HashSet");
-	jmethodID java_util_HashSet_init = (*env)->GetMethodID(env, java_util_HashSet, "<init>", "()V");
-	jmethodID java_util_HashSet_size = (*env)->GetMethodID(env, java_util_HashSet, "size", "()I");
-	jmethodID java_util_HashSet_toArray = (*env)->GetMethodID(env, java_util_HashSet, "toArray", "()[Ljava/lang/Object;");
-	
-	jclass jdk_internal_reflect_MethodAccessor = (*env)->FindClass(env, "jdk/internal/reflect/MethodAccessor");
-	jmethodID jdk_internal_reflect_MethodAccessor_invoke = (*env)->GetMethodID(env, jdk_internal_reflect_MethodAccessor, "invoke", "(Ljava/lang/Object;[Ljava/lang/Object;)Ljava/lang/Object;");
+	return revertibleCount;
+}
 
-	jclass java_lang_reflect_InvocationTargetException = (*env)->FindClass(env, "java/lang/reflect/InvocationTargetException");
+static void
+debugAgentRevertRange(J9DebugAgentTest *test, J9JITExceptionTable **jitMethods, UDATA start, UDATA end)
+{
+	J9VMThread *vmThread = (J9VMThread *)test->env;
+	J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
+	UDATA i = 0;
+
+	for (i = start; i < end; ++i) {
+		jitConfig->debugAgentRevertToInterpreter(vmThread, jitMethods[i]);
+	}
+	test->report.reverts += end - start;
+}
+
+static void
+debugAgentRestoreRange(J9DebugAgentTest *test, J9JITExceptionTable **jitMethods, UDATA start, UDATA end)
+{
+	J9VMThread *vmThread = (J9VMThread *)test->env;
+	J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
+	UDATA i = 0;
+
+	for (i = start; i < end; ++i) {
+		jitConfig->debugAgentRestoreJitMethod(vmThread, jitMethods[i]);
+	}
+	test->report.restores += end - start;
+}
+
+/**
+ * Move the JIT method matching either the given JIT body or the given RAM method from the remaining candidates to the
+ * end of the suspects at the front of the candidates, keeping the order of the other candidates.
+ *
+ * @return the new number of suspects
+ */
+static UDATA
+debugAgentPromoteSuspect(J9JITExceptionTable **jitMethods, UDATA jitMethodCount, UDATA suspectCount, J9JITExceptionTable *metaData, J9Method *ramMethod)
+{
+	UDATA i = 0;
+
+	for (i = suspectCount; i < jitMethodCount; ++i) {
+		J9JITExceptionTable *jitMethod = jitMethods[i];
+
+		if ((jitMethod == metaData) || ((NULL != ramMethod) && (jitMethod->ramMethod == ramMethod))) {
+			memmove(jitMethods + suspectCount + 1, jitMethods + suspectCount, (i - suspectCount) * sizeof(J9JITExceptionTable *));
+			jitMethods[suspectCount] = jitMethod;
+			return suspectCount + 1;
+		}
+	}
+
+	return suspectCount;
+}
+
+/**
+ * Move the JIT methods the failing exception was thrown through to the front of the candidates, in the order their
+ * frames appear on its stack trace. Each JIT frame is followed by the JIT bodies of the methods inlined along its call
+ * chain, which may carry the same defect when compiled on their own. The culprit is usually on or near the failing
+ * stack, so these suspects are tried first.
+ *
+ * @param vmThread the current thread
+ * @param failure the exception which triggered the debug agent, or NULL if unknown
+ * @param jitMethods the candidates
+ * @param jitMethodCount the number of candidates
+ * @return the number of suspects moved to the front of the candidates
+ */
+static UDATA
+debugAgentSeedSuspects(J9VMThread *vmThread, jthrowable failure, J9JITExceptionTable **jitMethods, UDATA jitMethodCount)
+{
+	J9JavaVM *vm = vmThread->javaVM;
+	J9JITConfig *jitConfig = vm->jitConfig;
+	UDATA suspectCount = 0;
+	j9object_t walkback = NULL;
+
+	if (NULL == failure) {
+		return 0;
+	}
+
+	vm->internalVMFunctions->internalEnterVMFromJNI(vmThread);
+	walkback = J9VMJAVALANGTHROWABLE_WALKBACK(vmThread, J9_JNI_UNWRAP_REFERENCE(failure));
+	if (NULL != walkback) {
+		U_32 arraySize = J9INDEXABLEOBJECT_SIZE(vmThread, walkback);
+		U_32 i = 0;
+
+		/* A zero terminates the stack trace */
+		for (i = 0; i < arraySize; ++i) {
+			UDATA pc = J9JAVAARRAYOFUDATA_LOAD(vmThread, walkback, i);
+			J9JITExceptionTable *metaData = NULL;
+
+			if (0 == pc) {
+				break;
+			}
+
+			/* Looks the PC up in the JIT artifact hash */
+			metaData = jitConfig->jitGetExceptionTableFromPC(vmThread, pc);
+			if (NULL != metaData) {
+				void *inlineMap = jitConfig->jitGetInlinerMapFromPC(vmThread, vm, metaData, pc);
+
+				suspectCount = debugAgentPromoteSuspect(jitMethods, jitMethodCount, suspectCount, metaData, NULL);
+				if (NULL != inlineMap) {
+					void *inlinedCallSite = jitConfig->getFirstInlinedCallSite(metaData, inlineMap);
 
-	jobject jitMethodSet = (*env)->NewObject(env, java_util_HashSet, java_util_HashSet_init);
-	jitConfig->debugAgentGetAllJitMethods(vmThread, jitMethodSet);
+					while (NULL != inlinedCallSite) {
+						J9Method *inlinedMethod = (J9Method *)jitConfig->getInlinedMethod(inlinedCallSite);
+
+						suspectCount = debugAgentPromoteSuspect(jitMethods, jitMethodCount, suspectCount, NULL, inlinedMethod);
+						inlinedCallSite = jitConfig->getNextInlinedCallSite(metaData, inlinedCallSite);
+					}
+				}
+			}
+		}
+	}
+	vm->internalVMFunctions->internalExitVMToJNI(vmThread);
 
-	fprintf(stderr, "Total number of JIT methods in HashSet = %d\n", (*env)->CallIntMethod(env, jitMethodSet, java_util_HashSet_size));
+	return suspectCount;
+}
 
-	jobjectArray jitMethodArray = (*env)->CallObjectMethod(env, jitMethodSet, java_util_HashSet_toArray);
-	jint jitMethodArrayLength = (*env)->GetArrayLength(env, jitMethodArray);
-	for (IDATA i = 0; i < jitMethodArrayLength; ++i) {
-		jobject jitMethodObject = (*env)->GetObjectArrayElement(env, jitMethodArray, i);
-		jlong jitMethod = (*env)->CallLongMethod(env, jitMethodObject, java_lang_Long_longValue);
-		(*env)->DeleteLocalRef(env, jitMethodObject);
+/**
+ * Revert JIT methods to the interpreter one at a time, keeping previously reverted methods interpreted, until the
+ * test passes.
+ *
+ * @return the JIT method whose revert made the test pass, or NULL if none did
+ */
+static J9JITExceptionTable *
+debugAgentLinearSearch(J9DebugAgentTest *test, J9JITExceptionTable **jitMethods, UDATA jitMethodCount)
+{
+	J9VMThread *vmThread = (J9VMThread *)test->env;
+	J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
+	UDATA i = 0;
 
-		jitConfig->debugAgentRevertToInterpreter(vmThread, (J9JITExceptionTable*)jitMethod);
+	for (i = 0; i < jitMethodCount; ++i) {
+		jitConfig->debugAgentRevertToInterpreter(vmThread, jitMethods[i]);
+		test->report.reverts += 1;
 
 		fprintf(stderr, "Rerunning test\n");
-		(*env)->CallObjectMethod(env, ma, jdk_internal_reflect_MethodAccessor_invoke, obj, args);
-		if ((*env)->ExceptionCheck(env)) {
-			(*env)->ExceptionClear(env);
+		switch (debugAgentRunTest(test)) {
+		case DEBUG_AGENT_TEST_PASSED:
+			return jitMethods[i];
+		case DEBUG_AGENT_TEST_FAILED:
+			fprintf(stderr, "Caught exception after invoking test\n");
+			debugAgentSaveCandidates(test, i + 1, jitMethodCount);
+			break;
+		default:
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Bisect the JIT methods by reverting half of the remaining candidates to the interpreter and recursing into the half
+ * which makes the test pass. Reverted halves are restored before the next probe so every probe differs from the
+ * original failing configuration only by the candidates under test. Assumes a single culprit. The suspects at the
+ * front of the candidates are probed on their own first.
+ *
+ * @return the JIT method whose revert made the test pass, or NULL if none did
+ */
+static J9JITExceptionTable *
+debugAgentBisectionSearch(J9DebugAgentTest *test, J9JITExceptionTable **jitMethods, UDATA jitMethodCount, UDATA suspectCount)
+{
+	J9VMThread *vmThread = (J9VMThread *)test->env;
+	J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
+	UDATA low = 0;
+	UDATA high = jitMethodCount;
+	UDATA result = DEBUG_AGENT_TEST_PASSED;
+
+	if (0 == jitMethodCount) {
+		return NULL;
+	}
+
+	debugAgentRevertRange(test, jitMethods, 0, jitMethodCount);
+	fprintf(stderr, "Rerunning test with all %d JIT methods reverted\n", (int)jitMethodCount);
+	result = debugAgentRunTest(test);
+	debugAgentRestoreRange(test, jitMethods, 0, jitMethodCount);
+	if (DEBUG_AGENT_TEST_PASSED != result) {
+		fprintf(stderr, "Test fails even with all JIT methods reverted\n");
+		return NULL;
+	}
+
+	if ((0 != suspectCount) && (suspectCount < jitMethodCount)) {
+		debugAgentRevertRange(test, jitMethods, 0, suspectCount);
+		fprintf(stderr, "Rerunning test with the %d JIT methods on the failing stack trace reverted\n", (int)suspectCount);
+		result = debugAgentRunTest(test);
+		debugAgentRestoreRange(test, jitMethods, 0, suspectCount);
+
+		if (DEBUG_AGENT_TEST_PASSED == result) {
+			high = suspectCount;
+		} else if (DEBUG_AGENT_TEST_FAILED == result) {
+			fprintf(stderr, "Culprit is not on the failing stack trace\n");
+			low = suspectCount;
+		} else {
+			return NULL;
+		}
+		debugAgentSaveCandidates(test, low, high);
+	}
+
+	while ((high - low) > 1) {
+		UDATA middle = low + ((high - low) / 2);
+
+		debugAgentRevertRange(test, jitMethods, low, middle);
+		fprintf(stderr, "Rerunning test with JIT methods [%d, %d) of [%d, %d) reverted\n", (int)low, (int)middle, (int)low, (int)high);
+		result = debugAgentRunTest(test);
+		debugAgentRestoreRange(test, jitMethods, low, middle);
+
+		if (DEBUG_AGENT_TEST_PASSED == result) {
+			high = middle;
+		} else if (DEBUG_AGENT_TEST_FAILED == result) {
 			fprintf(stderr, "Caught exception after invoking test\n");
+			low = middle;
+		} else {
+			return NULL;
+		}
+		debugAgentSaveCandidates(test, low, high);
+	}
+
+	/* Leave the culprit interpreted, as the linear search does, until it is recompiled */
+	jitConfig->debugAgentRevertToInterpreter(vmThread, jitMethods[low]);
+	test->report.reverts += 1;
+
+	return jitMethods[low];
+}
+
+/**
+ * Recompile the JIT method with the optimization and inlining limits of the test, recording the cost of the
+ * recompilation in the report.
+ *
+ * @return TRUE if the recompilation succeeded, FALSE otherwise
+ */
+static BOOLEAN
+debugAgentRecompileJitMethod(J9DebugAgentTest *test, J9JITExceptionTable *jitMethod, IDATA lastOptIndex, IDATA lastOptSubIndex, BOOLEAN enableTracing, BOOLEAN goodLog, J9DebugAgentRecompileResult *result)
+{
+	J9VMThread *vmThread = (J9VMThread *)test->env;
+	J9JavaVM *vm = vmThread->javaVM;
+
+	memset(result, 0, sizeof(J9DebugAgentRecompileResult));
+	vm->jitConfig->debugAgentRecompile(vmThread, jitMethod, lastOptIndex, lastOptSubIndex, test->maxInlinedCallSites, test->disabledOptimizations, test->disabledOptimizationCount, test->bodyKind, enableTracing, goodLog, result);
+
+	test->report.recompilations += 1;
+	test->report.compilationTime += result->compilationTime;
+	test->report.traceLogBytes += result->traceLogBytes;
+	debugAgentReportEvent(vm, &test->report,
+		"\"event\": \"recompilation\", \"lastOptIndex\": %zd, \"lastOptSubIndex\": %zd, \"maxInlinedCallSites\": %zd, "
+		"\"disabledOptimizations\": %zu, \"bodyKind\": %zu, \"tracing\": %s, \"succeeded\": %s, \"compilationTimeUs\": %zu, "
+		"\"codeSize\": %zu, \"traceLogBytes\": %zu",
+		lastOptIndex, lastOptSubIndex, test->maxInlinedCallSites, test->disabledOptimizationCount, test->bodyKind,
+		enableTracing ? "true" : "false", result->compilationSucceeded ? "true" : "false",
+		result->compilationTime, result->codeSize, result->traceLogBytes);
+
+	return result->compilationSucceeded;
+}
+
+/**
+ * Recompile the JIT method with the given optimization limits and rerun the test.
+ *
+ * @return the result of running the test, or DEBUG_AGENT_TEST_ERROR if the recompilation failed
+ */
+static UDATA
+debugAgentRecompileAndRunTest(J9DebugAgentTest *test, J9JITExceptionTable *jitMethod, IDATA lastOptIndex, IDATA lastOptSubIndex, J9DebugAgentRecompileResult *result)
+{
+	if (!debugAgentRecompileJitMethod(test, jitMethod, lastOptIndex, lastOptSubIndex, FALSE, FALSE, result)) {
+		fprintf(stderr, "Recompilation with lastOptIndex = %ld lastOptSubIndex = %ld failed\n", lastOptIndex, lastOptSubIndex);
+		return DEBUG_AGENT_TEST_ERROR;
+	}
+
+	fprintf(stderr, "Rerunning test\n");
+	return debugAgentRunTest(test);
+}
+
+/**
+ * Tell apart whether the problematic AOT body fails because of how the method compiles or because of the body loaded
+ * from the shared class cache, by recompiling it as a fresh JIT body and as a fresh AOT body which is relocated right
+ * away. The rest of the investigation recompiles the kind of body which reproduces the failure, preferring JIT bodies.
+ *
+ * @return FALSE if no recompilation reproduces the failure, TRUE otherwise
+ */
+static BOOLEAN
+debugAgentSearchOrigin(J9DebugAgentTest *test, J9JITExceptionTable *jitMethod)
+{
+	J9VMThread *vmThread = (J9VMThread *)test->env;
+	J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
+	J9DebugAgentRecompileResult result;
+	UDATA testResult = DEBUG_AGENT_TEST_PASSED;
+
+	test->bodyKind = J9_DEBUG_AGENT_RECOMPILE_SAME_KIND;
+	if (!jitConfig->debugAgentIsAotBody(vmThread, jitMethod)) {
+		test->report.culpritOrigin = DEBUG_AGENT_ORIGIN_JIT_BODY;
+		return TRUE;
+	}
+
+	fprintf(stderr, "Problematic method is an AOT body, recompiling it as a JIT body\n");
+	test->bodyKind = J9_DEBUG_AGENT_RECOMPILE_JIT;
+	testResult = debugAgentRecompileAndRunTest(test, jitMethod, DEBUG_AGENT_MAX_OPT_INDEX, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+	if (DEBUG_AGENT_TEST_FAILED == testResult) {
+		fprintf(stderr, "Test fails with a JIT body as well\n");
+		test->report.culpritOrigin = DEBUG_AGENT_ORIGIN_JIT_COMPILATION;
+		return TRUE;
+	}
 
-			jthrowable exceptionObject = (*env)->ExceptionOccurred(env);
-			if (!(*env)->IsInstanceOf(env, exceptionObject, java_lang_reflect_InvocationTargetException)) {
-				fprintf(stderr, "Unknown exception occured\n");
+	fprintf(stderr, "Recompiling it as an AOT body\n");
+	test->bodyKind = J9_DEBUG_AGENT_RECOMPILE_AOT;
+	testResult = debugAgentRecompileAndRunTest(test, jitMethod, DEBUG_AGENT_MAX_OPT_INDEX, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+	if (DEBUG_AGENT_TEST_FAILED == testResult) {
+		fprintf(stderr, "Test only fails with an AOT body\n");
+		test->report.culpritOrigin = DEBUG_AGENT_ORIGIN_AOT_COMPILATION;
+		return TRUE;
+	}
+
+	test->bodyKind = J9_DEBUG_AGENT_RECOMPILE_SAME_KIND;
+	if (DEBUG_AGENT_TEST_PASSED == testResult) {
+		fprintf(stderr, "Test passes with fresh JIT and AOT bodies, the defect is in the body loaded from the shared class cache\n");
+		test->report.culpritOrigin = DEBUG_AGENT_ORIGIN_SCC_LOAD;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Binary search for the inlined call site which makes the problematic JIT method fail. Recompilations only allow the
+ * first n inlining attempts to succeed, so when the test passes with n - 1 attempts and fails with n attempts the callee
+ * of the last attempt is the culprit. The limit is kept for the rest of the investigation so the optimization search
+ * and the trace logs only cover the method itself and the callees inlined up to and including the culprit.
+ */
+static void
+debugAgentSearchInlinedCallSites(J9DebugAgentTest *test, J9JITExceptionTable *jitMethod)
+{
+	J9DebugAgentRecompileResult result;
+	UDATA testResult = DEBUG_AGENT_TEST_PASSED;
+	IDATA passingCallSites = 0;
+	IDATA failingCallSites = 0;
+
+	/* Learn how many inlining attempts the compilation makes and make sure it still reproduces the failure */
+	test->maxInlinedCallSites = -1;
+	testResult = debugAgentRecompileAndRunTest(test, jitMethod, DEBUG_AGENT_MAX_OPT_INDEX, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+	if (DEBUG_AGENT_TEST_FAILED != testResult) {
+		fprintf(stderr, "Test did not fail after recompiling with all inlined call sites\n");
+		return;
+	}
+	failingCallSites = result.inliningAttempts;
+	if (failingCallSites <= 0) {
+		fprintf(stderr, "Method does not inline any call sites\n");
+		return;
+	}
+
+	test->maxInlinedCallSites = passingCallSites;
+	testResult = debugAgentRecompileAndRunTest(test, jitMethod, DEBUG_AGENT_MAX_OPT_INDEX, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+	if (DEBUG_AGENT_TEST_PASSED != testResult) {
+		if (DEBUG_AGENT_TEST_FAILED == testResult) {
+			fprintf(stderr, "Test fails even without inlining, the defect is in the method itself\n");
+		} else {
+			test->maxInlinedCallSites = -1;
+		}
+		return;
+	}
+
+	while ((failingCallSites - passingCallSites) > 1) {
+		IDATA maxInlinedCallSites = passingCallSites + ((failingCallSites - passingCallSites) / 2);
+
+		test->maxInlinedCallSites = maxInlinedCallSites;
+		testResult = debugAgentRecompileAndRunTest(test, jitMethod, DEBUG_AGENT_MAX_OPT_INDEX, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+		if (DEBUG_AGENT_TEST_PASSED == testResult) {
+			passingCallSites = maxInlinedCallSites;
+		} else if (DEBUG_AGENT_TEST_FAILED == testResult) {
+			fprintf(stderr, "Caught exception after invoking test with %ld inlined call sites\n", maxInlinedCallSites);
+			failingCallSites = maxInlinedCallSites;
+		} else {
+			test->maxInlinedCallSites = -1;
+			return;
+		}
+	}
+
+	fprintf(stderr, "Inlining attempt %ld is the potential culprit\n", failingCallSites - 1);
+	test->report.culpritInliningAttempt = failingCallSites - 1;
+	test->maxInlinedCallSites = failingCallSites;
+}
+
+/**
+ * Disable every optimization the compilation of the problematic JIT method performs except for the given ones in the
+ * recompilations which follow.
+ *
+ * @param test the test the recompilations are for
+ * @param optimizations the optimizations the compilation performs
+ * @param optimizationCount the number of optimizations the compilation performs
+ * @param enabledOptimizations the optimizations to leave enabled
+ * @param enabledOptimizationCount the number of optimizations to leave enabled
+ */
+static void
+debugAgentEnableOptimizations(J9DebugAgentTest *test, IDATA *optimizations, UDATA optimizationCount, IDATA *enabledOptimizations, UDATA enabledOptimizationCount)
+{
+	UDATA i = 0;
+	UDATA j = 0;
+
+	test->disabledOptimizationCount = 0;
+	for (i = 0; i < optimizationCount; ++i) {
+		for (j = 0; j < enabledOptimizationCount; ++j) {
+			if (optimizations[i] == enabledOptimizations[j]) {
 				break;
 			}
+		}
+		if (j == enabledOptimizationCount) {
+			test->disabledOptimizations[test->disabledOptimizationCount++] = optimizations[i];
+		}
+	}
+}
 
-			(*env)->DeleteLocalRef(env, exceptionObject);
-		} else {
-			fprintf(stderr, "Identified problematic method\n");
-
-			IDATA lastOptSubIndex = 1024;
-
-			for (IDATA lastOptIndex = 100; lastOptIndex >= 0; --lastOptIndex) {
-				jitConfig->debugAgentRecompile(vmThread, (J9JITExceptionTable*)jitMethod, lastOptIndex, lastOptSubIndex, 0, 0);
-
-				fprintf(stderr, "Rerunning test\n");
-				(*env)->CallObjectMethod(env, ma, jdk_internal_reflect_MethodAccessor_invoke, obj, args);
-				if ((*env)->ExceptionCheck(env)) {
-					(*env)->ExceptionClear(env);
-					fprintf(stderr, "Caught exception after invoking test with lastOptIndex = %ld\n", lastOptIndex);
-				} else {
-					fprintf(stderr, "LastOptIndex = %ld is the potential culprit\n", lastOptIndex + 1);
-
-					jitConfig->debugAgentRecompile(vmThread, (J9JITExceptionTable*)jitMethod, lastOptIndex, lastOptSubIndex, 1, 1);
-
-					fprintf(stderr, "Rerunning test expecting it to pass\n");
-					(*env)->CallObjectMethod(env, ma, jdk_internal_reflect_MethodAccessor_invoke, obj, args);
-					if ((*env)->ExceptionCheck(env)) {
-						(*env)->ExceptionClear(env);
-						fprintf(stderr, "Test failed\n");
-						break;
-					} else {
-						fprintf(stderr, "Test passed\n");
-					}
+/**
+ * Recompile the problematic JIT method with only the given optimizations enabled out of those its compilation performs,
+ * and run the test.
+ *
+ * @param test the test to run
+ * @param jitMethod the JIT method to recompile
+ * @param optimizations the optimizations the compilation performs
+ * @param optimizationCount the number of optimizations the compilation performs
+ * @param enabledOptimizations the optimizations to leave enabled
+ * @param enabledOptimizationCount the number of optimizations to leave enabled
+ * @return DEBUG_AGENT_TEST_PASSED, DEBUG_AGENT_TEST_FAILED, or DEBUG_AGENT_TEST_ERROR
+ */
+static UDATA
+debugAgentRecompileWithOptimizationsAndRunTest(J9DebugAgentTest *test, J9JITExceptionTable *jitMethod, IDATA *optimizations, UDATA optimizationCount, IDATA *enabledOptimizations, UDATA enabledOptimizationCount)
+{
+	J9DebugAgentRecompileResult result;
 
-					jitConfig->debugAgentRecompile(vmThread, (J9JITExceptionTable*)jitMethod, lastOptIndex + 1, lastOptSubIndex, 1, 0);
+	debugAgentEnableOptimizations(test, optimizations, optimizationCount, enabledOptimizations, enabledOptimizationCount);
+	fprintf(stderr, "Recompiling with %d of %d optimizations enabled\n", (int)enabledOptimizationCount, (int)optimizationCount);
+	return debugAgentRecompileAndRunTest(test, jitMethod, DEBUG_AGENT_MAX_OPT_INDEX, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+}
 
-					fprintf(stderr, "Rerunning test expecting it to fail\n");
-					(*env)->CallObjectMethod(env, ma, jdk_internal_reflect_MethodAccessor_invoke, obj, args);
-					if ((*env)->ExceptionCheck(env)) {
-						(*env)->ExceptionClear(env);
-						fprintf(stderr, "Test failed\n");
-					} else {
-						fprintf(stderr, "Test passed\n");
-					}
+/**
+ * Delta debugging over the optimizations the compilation of the problematic JIT method performs, looking for a minimal
+ * set of optimizations which still makes the test fail when every other one is disabled. Unlike the lastOptIndex search
+ * this also catches failures where an earlier optimization sets up the IL a later optimization miscompiles. The
+ * optimizations outside of the minimal set stay disabled for the rest of the investigation.
+ */
+static void
+debugAgentSearchOptimizations(J9DebugAgentTest *test, J9JITExceptionTable *jitMethod)
+{
+	J9VMThread *vmThread = (J9VMThread *)test->env;
+	J9JITConfig *jitConfig = vmThread->javaVM->jitConfig;
+	J9DebugAgentRecompileResult result;
+	UDATA testResult = DEBUG_AGENT_TEST_PASSED;
+	IDATA *optimizations = NULL;
+	UDATA optimizationCount = 0;
+	IDATA *failingOptimizations = NULL;
+	UDATA failingOptimizationCount = 0;
+	IDATA *candidateOptimizations = NULL;
+	UDATA candidateOptimizationCount = 0;
+	UDATA granularity = 2;
+	UDATA i = 0;
+	BOOLEAN found = FALSE;
+	PORT_ACCESS_FROM_VMC(vmThread);
+
+	/* Learn which optimizations the compilation performs and make sure it still reproduces the failure */
+	test->disabledOptimizationCount = 0;
+	testResult = debugAgentRecompileAndRunTest(test, jitMethod, DEBUG_AGENT_MAX_OPT_INDEX, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+	if (DEBUG_AGENT_TEST_FAILED != testResult) {
+		fprintf(stderr, "Test did not fail after recompiling with all optimizations\n");
+		return;
+	}
 
-					break;
-				}
+	if (!jitConfig->debugAgentGetPerformedOptimizations(vmThread, &optimizations, &optimizationCount) || (0 == optimizationCount)) {
+		fprintf(stderr, "Could not determine the optimizations performed\n");
+		goto done;
+	}
+
+	test->disabledOptimizations = j9mem_allocate_memory(optimizationCount * sizeof(IDATA), J9MEM_CATEGORY_VM_JCL);
+	failingOptimizations = j9mem_allocate_memory(optimizationCount * sizeof(IDATA), J9MEM_CATEGORY_VM_JCL);
+	candidateOptimizations = j9mem_allocate_memory(optimizationCount * sizeof(IDATA), J9MEM_CATEGORY_VM_JCL);
+	if ((NULL == test->disabledOptimizations) || (NULL == failingOptimizations) || (NULL == candidateOptimizations)) {
+		fprintf(stderr, "Could not allocate memory for %d optimizations\n", (int)optimizationCount);
+		goto done;
+	}
+
+	/* The failure may not depend on any optimization at all, in which case all of them can stay disabled */
+	testResult = debugAgentRecompileWithOptimizationsAndRunTest(test, jitMethod, optimizations, optimizationCount, NULL, 0);
+	if (DEBUG_AGENT_TEST_FAILED == testResult) {
+		fprintf(stderr, "Test fails even with all optimizations disabled\n");
+		found = TRUE;
+		goto done;
+	}
+
+	memcpy(failingOptimizations, optimizations, optimizationCount * sizeof(IDATA));
+	failingOptimizationCount = optimizationCount;
+
+	while (failingOptimizationCount > 1) {
+		BOOLEAN reduced = FALSE;
+
+		/* Try to reproduce the failure with a single chunk of the failing optimizations enabled */
+		for (i = 0; (i < granularity) && !reduced; ++i) {
+			UDATA start = (i * failingOptimizationCount) / granularity;
+			UDATA end = ((i + 1) * failingOptimizationCount) / granularity;
+
+			candidateOptimizationCount = end - start;
+			memcpy(candidateOptimizations, failingOptimizations + start, candidateOptimizationCount * sizeof(IDATA));
+			testResult = debugAgentRecompileWithOptimizationsAndRunTest(test, jitMethod, optimizations, optimizationCount, candidateOptimizations, candidateOptimizationCount);
+			if (DEBUG_AGENT_TEST_FAILED == testResult) {
+				granularity = 2;
+				reduced = TRUE;
+			}
+		}
+
+		/* Then with a single chunk of the failing optimizations disabled, which is the same as above for two chunks */
+		for (i = 0; (i < granularity) && (granularity > 2) && !reduced; ++i) {
+			UDATA start = (i * failingOptimizationCount) / granularity;
+			UDATA end = ((i + 1) * failingOptimizationCount) / granularity;
+
+			candidateOptimizationCount = failingOptimizationCount - (end - start);
+			memcpy(candidateOptimizations, failingOptimizations, start * sizeof(IDATA));
+			memcpy(candidateOptimizations + start, failingOptimizations + end, (failingOptimizationCount - end) * sizeof(IDATA));
+			testResult = debugAgentRecompileWithOptimizationsAndRunTest(test, jitMethod, optimizations, optimizationCount, candidateOptimizations, candidateOptimizationCount);
+			if (DEBUG_AGENT_TEST_FAILED == testResult) {
+				granularity -= 1;
+				reduced = TRUE;
 			}
+		}
 
+		if (reduced) {
+			memcpy(failingOptimizations, candidateOptimizations, candidateOptimizationCount * sizeof(IDATA));
+			failingOptimizationCount = candidateOptimizationCount;
+			fprintf(stderr, "Caught exception after invoking test with %d optimizations enabled\n", (int)failingOptimizationCount);
+		} else if (granularity < failingOptimizationCount) {
+			granularity = OMR_MIN(granularity * 2, failingOptimizationCount);
+		} else {
 			break;
 		}
 	}
 
-	(*env)->DeleteLocalRef(env, java_lang_Long);
-	(*env)->DeleteLocalRef(env, java_util_HashSet);
+	fprintf(stderr, "Minimal set of optimizations which reproduces the failure:\n");
+	for (i = 0; i < failingOptimizationCount; ++i) {
+		fprintf(stderr, "\t%s\n", jitConfig->debugAgentGetOptimizationName(failingOptimizations[i]));
+	}
+
+	/* Keep everything outside of the minimal set disabled so the remaining searches and logs only involve the culprits */
+	debugAgentEnableOptimizations(test, optimizations, optimizationCount, failingOptimizations, failingOptimizationCount);
+	found = TRUE;
+
+done:
+	if (!found) {
+		test->disabledOptimizationCount = 0;
+	}
+	j9mem_free_memory(optimizations);
+	j9mem_free_memory(failingOptimizations);
+	j9mem_free_memory(candidateOptimizations);
+}
+
+/**
+ * Binary search for the optimization, and the transformation within it, which makes the problematic JIT method fail.
+ * The search is bounded by the number of optimizations and transformations the compilation actually performed. Once
+ * found, a good and a bad trace log are collected with the culprit transformation excluded and included.
+ */
+static void
+debugAgentSearchLastOptIndex(J9DebugAgentTest *test, J9JITExceptionTable *jitMethod)
+{
+	J9DebugAgentRecompileResult result;
+	UDATA testResult = DEBUG_AGENT_TEST_PASSED;
+	IDATA passingOptIndex = 0;
+	IDATA failingOptIndex = 0;
+	IDATA passingOptSubIndex = 0;
+	IDATA failingOptSubIndex = DEBUG_AGENT_MAX_OPT_INDEX;
+
+	if (test->state.failingOptIndex >= 0) {
+		passingOptIndex = test->state.passingOptIndex;
+		failingOptIndex = test->state.failingOptIndex;
+		fprintf(stderr, "Resuming with lastOptIndex between %ld and %ld\n", passingOptIndex, failingOptIndex);
+	} else {
+		/* Learn how many optimizations the compilation performs and make sure it still reproduces the failure */
+		testResult = debugAgentRecompileAndRunTest(test, jitMethod, DEBUG_AGENT_MAX_OPT_INDEX, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+		if (DEBUG_AGENT_TEST_FAILED != testResult) {
+			fprintf(stderr, "Test did not fail after recompiling with all optimizations\n");
+			return;
+		}
+		failingOptIndex = result.lastPerformedOptIndex;
+		fprintf(stderr, "Caught exception after invoking test with lastOptIndex = %ld\n", failingOptIndex);
+
+		testResult = debugAgentRecompileAndRunTest(test, jitMethod, passingOptIndex, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+		if (DEBUG_AGENT_TEST_ERROR == testResult) {
+			return;
+		}
+		if (DEBUG_AGENT_TEST_PASSED != testResult) {
+			fprintf(stderr, "Test fails even with lastOptIndex = %ld, collecting the failing log only\n", passingOptIndex);
+			debugAgentRecompileJitMethod(test, jitMethod, passingOptIndex, DEBUG_AGENT_MAX_OPT_INDEX, TRUE, FALSE, &result);
+			return;
+		}
+		debugAgentSaveOptIndexInterval(test, passingOptIndex, failingOptIndex);
+	}
+
+	while ((failingOptIndex - passingOptIndex) > 1) {
+		IDATA lastOptIndex = passingOptIndex + ((failingOptIndex - passingOptIndex) / 2);
+
+		testResult = debugAgentRecompileAndRunTest(test, jitMethod, lastOptIndex, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+		if (DEBUG_AGENT_TEST_PASSED == testResult) {
+			passingOptIndex = lastOptIndex;
+		} else if (DEBUG_AGENT_TEST_FAILED == testResult) {
+			fprintf(stderr, "Caught exception after invoking test with lastOptIndex = %ld\n", lastOptIndex);
+			failingOptIndex = lastOptIndex;
+		} else {
+			return;
+		}
+		debugAgentSaveOptIndexInterval(test, passingOptIndex, failingOptIndex);
+	}
+
+	fprintf(stderr, "LastOptIndex = %ld is the potential culprit\n", failingOptIndex);
+	test->report.verdict = "culpritOptimizationFound";
+	test->report.culpritOptIndex = failingOptIndex;
+
+	/* The culprit optimization is the last one performed here, so the sub index reported is its transformation count */
+	testResult = debugAgentRecompileAndRunTest(test, jitMethod, failingOptIndex, DEBUG_AGENT_MAX_OPT_INDEX, &result);
+	if (DEBUG_AGENT_TEST_FAILED == testResult) {
+		failingOptSubIndex = result.lastPerformedOptSubIndex + 1;
+
+		while ((failingOptSubIndex - passingOptSubIndex) > 1) {
+			IDATA lastOptSubIndex = passingOptSubIndex + ((failingOptSubIndex - passingOptSubIndex) / 2);
+
+			testResult = debugAgentRecompileAndRunTest(test, jitMethod, failingOptIndex, lastOptSubIndex, &result);
+			if (DEBUG_AGENT_TEST_PASSED == testResult) {
+				passingOptSubIndex = lastOptSubIndex;
+			} else if (DEBUG_AGENT_TEST_FAILED == testResult) {
+				fprintf(stderr, "Caught exception after invoking test with lastOptSubIndex = %ld\n", lastOptSubIndex);
+				failingOptSubIndex = lastOptSubIndex;
+			} else {
+				return;
+			}
+		}
+
+		fprintf(stderr, "LastOptSubIndex = %ld is the potential culprit\n", failingOptSubIndex);
+		passingOptIndex = failingOptIndex;
+		test->report.culpritOptSubIndex = failingOptSubIndex;
+	} else {
+		/* The failure did not reproduce, fall back to bracketing the whole optimization */
+		passingOptSubIndex = DEBUG_AGENT_MAX_OPT_INDEX;
+		failingOptSubIndex = DEBUG_AGENT_MAX_OPT_INDEX;
+	}
+
+	debugAgentRecompileJitMethod(test, jitMethod, passingOptIndex, passingOptSubIndex, TRUE, TRUE, &result);
+
+	fprintf(stderr, "Rerunning test expecting it to pass\n");
+	if (DEBUG_AGENT_TEST_PASSED != debugAgentRunTest(test)) {
+		fprintf(stderr, "Test failed\n");
+		return;
+	} else {
+		fprintf(stderr, "Test passed\n");
+	}
+
+	debugAgentRecompileJitMethod(test, jitMethod, failingOptIndex, failingOptSubIndex, TRUE, FALSE, &result);
+
+	fprintf(stderr, "Rerunning test expecting it to fail\n");
+	if (DEBUG_AGENT_TEST_PASSED != debugAgentRunTest(test)) {
+		fprintf(stderr, "Test failed\n");
+	} else {
+		fprintf(stderr, "Test passed\n");
+	}
+}
+
+void JNICALL
+Java_com_ibm_jit_JITHelpers_debugAgentRun(JNIEnv *env, jclass ignored, jobject ma, jobject obj, jobjectArray args, jthrowable failure)
+{
+	J9VMThread *vmThread = (J9VMThread *)env;
+	J9JavaVM *vm = vmThread->javaVM;
+	J9JITConfig *jitConfig = vm->jitConfig;
+	J9VMSystemProperty *searchProperty = NULL;
+	BOOLEAN bisect = TRUE;
+	J9DebugAgentTest test;
+	J9JITExceptionTable **jitMethods = NULL;
+	J9JITExceptionTable *culprit = NULL;
+	UDATA jitMethodCount = 0;
+	UDATA candidateCount = 0;
+	UDATA suspectCount = 0;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	jitConfig->debugAgentStart(vmThread);
+
+	if ((J9SYSPROP_ERROR_NONE == vm->internalVMFunctions->getSystemProperty(vm, DEBUG_AGENT_SEARCH_PROPERTY, &searchProperty))
+		&& (0 == strcmp(searchProperty->value, "linear"))
+	) {
+		bisect = FALSE;
+	}
+
+	jclass jdk_internal_reflect_MethodAccessor = (*env)->FindClass(env, "jdk/internal/reflect/MethodAccessor");
+	jmethodID jdk_internal_reflect_MethodAccessor_invoke = (*env)->GetMethodID(env, jdk_internal_reflect_MethodAccessor, "invoke", "(Ljava/lang/Object;[Ljava/lang/Object;)Ljava/lang/Object;");
+
+	jclass java_lang_reflect_InvocationTargetException = (*env)->FindClass(env, "java/lang/reflect/InvocationTargetException");
+
+	test.env = env;
+	test.ma = ma;
+	test.obj = obj;
+	test.args = args;
+	test.invoke = jdk_internal_reflect_MethodAccessor_invoke;
+	test.invocationTargetException = java_lang_reflect_InvocationTargetException;
+	test.bodyKind = J9_DEBUG_AGENT_RECOMPILE_SAME_KIND;
+	test.maxInlinedCallSites = -1;
+	test.disabledOptimizations = NULL;
+	test.disabledOptimizationCount = 0;
+	test.watchdog = debugAgentStartWatchdog(&test);
+	debugAgentOpenReport(vm, &test.report);
+	debugAgentOpenState(&test, failure);
+	debugAgentInitRerunPolicy(vm, &test);
+
+	if (!jitConfig->debugAgentGetAllJitMethods(vmThread, &jitMethods, &jitMethodCount)) {
+		fprintf(stderr, "Could not enumerate JIT methods\n");
+		goto done;
+	}
+
+	fprintf(stderr, "Total number of JIT methods = %d\n", (int)jitMethodCount);
+	jitMethodCount = debugAgentExcludeNonRevertible(&test, jitMethods, jitMethodCount);
+	candidateCount = debugAgentResumeState(&test, jitMethods, jitMethodCount);
+	test.report.candidates = candidateCount;
+	culprit = test.state.culprit;
+
+	if (NULL == culprit) {
+		suspectCount = debugAgentSeedSuspects(vmThread, failure, jitMethods, candidateCount);
+		test.report.suspects = suspectCount;
+		fprintf(stderr, "Number of JIT methods on the failing stack trace = %d\n", (int)suspectCount);
+
+		if (bisect) {
+			culprit = debugAgentBisectionSearch(&test, jitMethods, candidateCount, suspectCount);
+		} else {
+			/* The linear search keeps the JIT methods it has cleared interpreted */
+			debugAgentRevertRange(&test, jitMethods, candidateCount, jitMethodCount);
+			culprit = debugAgentLinearSearch(&test, jitMethods, candidateCount);
+		}
+	}
+
+	if (NULL != culprit) {
+		fprintf(stderr, "Identified problematic method\n");
+		test.report.verdict = "culpritMethodFound";
+		test.report.culprit = culprit;
+		test.state.culprit = culprit;
+		debugAgentSaveState(&test);
+		if (!test.state.originSearched) {
+			debugAgentSearchOrigin(&test, culprit);
+			test.state.originSearched = TRUE;
+			debugAgentSaveState(&test);
+		}
+		/* Recompiling cannot reproduce a defect in the body loaded from the shared class cache */
+		if (test.report.culpritOrigin == DEBUG_AGENT_ORIGIN_SCC_LOAD) {
+			goto done;
+		}
+		if (!test.state.inlinedCallSitesSearched) {
+			debugAgentSearchInlinedCallSites(&test, culprit);
+			test.state.inlinedCallSitesSearched = TRUE;
+			debugAgentSaveState(&test);
+		}
+		if (!test.state.optimizationsSearched) {
+			debugAgentSearchOptimizations(&test, culprit);
+			test.state.optimizationsSearched = TRUE;
+			debugAgentSaveState(&test);
+		}
+		debugAgentSearchLastOptIndex(&test, culprit);
+	}
+
+done:
+	/* The JIT method array is allocated by the JIT through the port library and owned by us */
+	j9mem_free_memory(jitMethods);
+	j9mem_free_memory(test.disabledOptimizations);
+	j9mem_free_memory(test.state.identity);
+	debugAgentStopWatchdog(&test);
+	debugAgentCloseReport(vm, &test.report);
+
 	(*env)->DeleteLocalRef(env, jdk_internal_reflect_MethodAccessor);
 	(*env)->DeleteLocalRef(env, java_lang_reflect_InvocationTargetException);
-	(*env)->DeleteLocalRef(env, jitMethodSet);
-	(*env)->DeleteLocalRef(env, jitMethodArray);
 
 	jitConfig->debugAgentEnd(vmThread);
 }
+
+/**
+ * Fingerprint a failure by its exception type and the JIT methods of its top JIT frames, so that failures caught on
+ * several threads at once can share a single investigation.
+ *
+ * @param env the JNI environment
+ * @param ignored the JITHelpers class
+ * @param failure the exception which triggered the debug agent
+ * @return the fingerprint, or NULL if it could not be created
+ */
+jstring JNICALL
+Java_com_ibm_jit_JITHelpers_debugAgentFingerprint(JNIEnv *env, jclass ignored, jthrowable failure)
+{
+	J9VMThread *vmThread = (J9VMThread *)env;
+	J9JavaVM *vm = vmThread->javaVM;
+	J9JITConfig *jitConfig = vm->jitConfig;
+	char fingerprint[DEBUG_AGENT_FINGERPRINT_LENGTH];
+	UDATA length = 0;
+	j9object_t exception = NULL;
+	j9object_t walkback = NULL;
+	J9UTF8 *className = NULL;
+	PORT_ACCESS_FROM_JAVAVM(vm);
+
+	vm->internalVMFunctions->internalEnterVMFromJNI(vmThread);
+	exception = J9_JNI_UNWRAP_REFERENCE(failure);
+	className = J9ROMCLASS_CLASSNAME(J9OBJECT_CLAZZ(vmThread, exception)->romClass);
+	length = j9str_printf(PORTLIB, fingerprint, sizeof(fingerprint), "%.*s", (int)J9UTF8_LENGTH(className), J9UTF8_DATA(className));
+
+	walkback = J9VMJAVALANGTHROWABLE_WALKBACK(vmThread, exception);
+	if ((NULL != walkback) && (NULL != jitConfig)) {
+		U_32 arraySize = J9INDEXABLEOBJECT_SIZE(vmThread, walkback);
+		U_32 jitFrameCount = 0;
+		U_32 i = 0;
+
+		/* A zero terminates the stack trace */
+		for (i = 0; (i < arraySize) && (jitFrameCount < DEBUG_AGENT_FINGERPRINT_FRAMES); ++i) {
+			UDATA pc = J9JAVAARRAYOFUDATA_LOAD(vmThread, walkback, i);
+			J9JITExceptionTable *metaData = NULL;
+
+			if (0 == pc) {
+				break;
+			}
+
+			metaData = jitConfig->jitGetExceptionTableFromPC(vmThread, pc);
+			if (NULL != metaData) {
+				J9UTF8 *methodClassName = J9ROMCLASS_CLASSNAME(J9_CLASS_FROM_METHOD(metaData->ramMethod)->romClass);
+				J9ROMMethod *romMethod = J9_ROM_METHOD_FROM_RAM_METHOD(metaData->ramMethod);
+				J9UTF8 *name = J9ROMMETHOD_NAME(romMethod);
+				J9UTF8 *signature = J9ROMMETHOD_SIGNATURE(romMethod);
+
+				length += j9str_printf(PORTLIB, fingerprint + length, sizeof(fingerprint) - length, " %.*s.%.*s%.*s",
+					(int)J9UTF8_LENGTH(methodClassName), J9UTF8_DATA(methodClassName),
+					(int)J9UTF8_LENGTH(name), J9UTF8_DATA(name),
+					(int)J9UTF8_LENGTH(signature), J9UTF8_DATA(signature));
+				jitFrameCount += 1;
+			}
+		}
+	}
+	vm->internalVMFunctions->internalExitVMToJNI(vmThread);
+
+	return (*env)->NewStringUTF(env, fingerprint);
+}
@@ -141,6 +141,7 @@ omr_add_exports(jclse
 	Java_com_ibm_jit_JITHelpers_j9ThreadJ9JavaVMOffset
 	Java_com_ibm_jit_JITHelpers_javaLangClassJ9ClassOffset
 	Java_com_ibm_jit_JITHelpers_javaLangThreadJ9ThreadOffset
+	Java_com_ibm_jit_JITHelpers_debugAgentFingerprint
 	Java_com_ibm_jit_JITHelpers_debugAgentRun
 	Java_com_ibm_jit_JITHelpers_setForceUsePreexistence
 	Java_com_ibm_jvm_Dump_HeapDumpImpl
@@ -3924,6 +3924,22 @@ typedef struct J9ClassCastParms {
 	struct J9Class* castClass;
 } J9ClassCastParms;
 
+/* Outcome of a JIT debug agent recompilation, filled in by J9JITConfig.debugAgentRecompile */
+typedef struct J9DebugAgentRecompileResult {
+	BOOLEAN compilationSucceeded;
+	IDATA lastPerformedOptIndex;
+	IDATA lastPerformedOptSubIndex;
+	IDATA inliningAttempts;
+	UDATA compilationTime; /* in microseconds */
+	UDATA codeSize;
+	UDATA traceLogBytes;
+} J9DebugAgentRecompileResult;
+
+/* Kind of body a JIT debug agent recompilation produces */
+#define J9_DEBUG_AGENT_RECOMPILE_SAME_KIND 0 /* an AOT body for AOT bodies, a JIT body otherwise */
+#define J9_DEBUG_AGENT_RECOMPILE_JIT 1
+#define J9_DEBUG_AGENT_RECOMPILE_AOT 2 /* relocated right away, never stored in the shared class cache */
+
 /* @ddr_namespace: map_to_type=J9JITConfig */
 
 typedef struct J9JITConfig {
@@ -4261,9 +4277,14 @@ typedef struct J9JITConfig {
 	struct OMRProcessorDesc targetProcessor;
 	struct OMRProcessorDesc relocatableTargetProcessor;
 	BOOLEAN (*debugAgentStart)(struct J9VMThread *vmThread);
-	BOOLEAN (*debugAgentGetAllJitMethods)(struct J9VMThread *vmThread, jobject jitMethods);
+	BOOLEAN (*debugAgentGetAllJitMethods)(struct J9VMThread *vmThread, J9JITExceptionTable ***jitMethods, UDATA *jitMethodCount);
 	BOOLEAN (*debugAgentRevertToInterpreter)(struct J9VMThread *vmThread, J9JITExceptionTable *jitMethod);
-	BOOLEAN (*debugAgentRecompile)(struct J9VMThread *vmThread, J9JITExceptionTable *jitMethod, IDATA lastOptIndex, IDATA lastOptSubIndex, BOOLEAN enableTracing, BOOLEAN goodLog);
+	BOOLEAN (*debugAgentRestoreJitMethod)(struct J9VMThread *vmThread, J9JITExceptionTable *jitMethod);
+	BOOLEAN (*debugAgentRecompile)(struct J9VMThread *vmThread, J9JITExceptionTable *jitMethod, IDATA lastOptIndex, IDATA lastOptSubIndex, IDATA maxInlinedCallSites, IDATA *disabledOptimizations, UDATA disabledOptimizationCount, UDATA bodyKind, BOOLEAN enableTracing, BOOLEAN goodLog, J9DebugAgentRecompileResult *result);
+	BOOLEAN (*debugAgentIsAotBody)(struct J9VMThread *vmThread, J9JITExceptionTable *jitMethod);
+	BOOLEAN (*debugAgentIsRevertible)(struct J9VMThread *vmThread, J9JITExceptionTable *jitMethod);
+	BOOLEAN (*debugAgentGetPerformedOptimizations)(struct J9VMThread *vmThread, IDATA **optimizations, UDATA *optimizationCount);
+	const char * (*debugAgentGetOptimizationName)(IDATA optimization);
 	BOOLEAN (*debugAgentEnd)(struct J9VMThread *vmThread);
 	void 	  (*debugAgentSetForceUsePreexistence)(struct J9VMThread *vmThread);
 #if defined(J9VM_OPT_JITSERVER)
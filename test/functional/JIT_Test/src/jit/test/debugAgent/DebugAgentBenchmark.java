@@ -0,0 +1,134 @@
+/*
+ * Copyright IBM Corp. and others 2026
+ *
+ * This program and the accompanying materials are made available under
+ * the terms of the Eclipse Public License 2.0 which accompanies this
+ * distribution and is available at https://www.eclipse.org/legal/epl-2.0/
+ * or the Apache License, Version 2.0 which accompanies this distribution and
+ * is available at https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This Source Code may also be made available under the following
+ * Secondary Licenses when the conditions for such availability set
+ * forth in the Eclipse Public License, v. 2.0 are satisfied: GNU
+ * General Public License, version 2 with the GNU Classpath
+ * Exception [1] and GNU General Public License, version 2 with the
+ * OpenJDK Assembly Exception [2].
+ *
+ * [1] https://www.gnu.org/software/classpath/license.html
+ * [2] https://openjdk.org/legal/assembly-exception.html
+ *
+ * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
+ */
+package jit.test.debugAgent;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.concurrent.TimeUnit;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import org.testng.AssertJUnit;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+import org.testng.log4testng.Logger;
+
+/**
+ * Measures how quickly the JIT debug agent finds a known miscompilation. Every planted bug runs in its own JVM, where
+ * -Xjit:debugAgentFaultMethod and -Xjit:debugAgentFaultOptIndex corrupt the IL of one method at one optimization
+ * index. The investigation report of the debug agent must name both, and the test runs, recompilations and wall time
+ * the debug agent needed are logged so search strategies can be compared across variations.
+ */
+@Test(groups = { "level.extended", "component.jit" })
+public class DebugAgentBenchmark {
+	private static Logger logger = Logger.getLogger(DebugAgentBenchmark.class);
+
+	private static final int ITERATIONS = 1000;
+	private static final int INVESTIGATION_TIME_LIMIT_MINUTES = 30;
+	private static final String PLANTED_METHODS = "jit/test/debugAgent/PlantedMethods.*";
+
+	private static final String JAVA_EXE = System.getProperty("JAVA_EXE");
+	private static final String CHILD_OPTIONS = System.getProperty("CHILD_OPTIONS", "");
+	private static final String REPORT_DIR = System.getProperty("REPORT_DIR", System.getProperty("user.dir"));
+
+	private static final Pattern SUMMARY_MEMBER = Pattern.compile("\"(\\w+)\": (?:\"([^\"]*)\"|(-?\\d+))");
+
+	@DataProvider(name = "plantedBugs")
+	public static Object[][] plantedBugs() {
+		return new Object[][] {
+			{ "testSumOfSquares", "jit/test/debugAgent/PlantedMethods.sumOfSquares(I)I", 5 },
+			{ "testChecksum", "jit/test/debugAgent/PlantedMethods.checksum([I)I", 12 },
+			{ "testGcd", "jit/test/debugAgent/PlantedMethods.gcd(II)I", 20 },
+		};
+	}
+
+	@Test(dataProvider = "plantedBugs")
+	public void testTimeToCulprit(String test, String plantedMethod, int plantedOptIndex) throws IOException, InterruptedException {
+		AssertJUnit.assertNotNull("JAVA_EXE must name the java executable to run the planted bugs with", JAVA_EXE);
+
+		File report = new File(REPORT_DIR, "debugAgent_" + test + ".json");
+		File log = new File(REPORT_DIR, "debugAgent_" + test + ".log");
+		report.delete();
+
+		List<String> command = new ArrayList<String>();
+		command.add(JAVA_EXE);
+		for (String option : CHILD_OPTIONS.trim().split("\\s+")) {
+			if (!option.isEmpty()) {
+				command.add(option);
+			}
+		}
+		command.addAll(Arrays.asList(
+			"--add-opens=java.base/java.lang.reflect=ALL-UNNAMED",
+			"--add-exports=java.base/com.ibm.jit=ALL-UNNAMED",
+			"-Xdump:none",
+			"-Xjit:enableDebugAgentRevert,disableAsyncCompilation"
+				+ ",{" + PLANTED_METHODS + "}(count=10,optlevel=warm)"
+				+ ",dontInline={" + PLANTED_METHODS + "}"
+				+ ",debugAgentFaultMethod={" + plantedMethod.substring(0, plantedMethod.indexOf('(')) + "(*}"
+				+ ",debugAgentFaultOptIndex=" + plantedOptIndex,
+			"-Dcom.ibm.jit.debugAgent.report=" + report.getAbsolutePath(),
+			PlantedBugRunner.class.getName(),
+			test,
+			Integer.toString(ITERATIONS)));
+
+		logger.info("Running " + String.join(" ", command));
+		ProcessBuilder builder = new ProcessBuilder(command);
+		builder.redirectErrorStream(true);
+		builder.redirectOutput(log);
+		Process process = builder.start();
+		if (!process.waitFor(INVESTIGATION_TIME_LIMIT_MINUTES, TimeUnit.MINUTES)) {
+			process.destroyForcibly();
+			AssertJUnit.fail("The investigation of " + test + " did not finish within " + INVESTIGATION_TIME_LIMIT_MINUTES + " minutes, see " + log);
+		}
+
+		AssertJUnit.assertTrue("The debug agent did not write a report for " + test + ", see " + log, report.exists());
+		Map<String, String> summary = readSummary(report);
+
+		logger.info(String.format("%s: testRuns=%s recompilations=%s reverts=%s wallTimeUs=%s verdict=%s culprit=%s culpritOptIndex=%s",
+			test, summary.get("testRuns"), summary.get("recompilations"), summary.get("reverts"), summary.get("wallTimeUs"),
+			summary.get("verdict"), summary.get("culprit"), summary.get("culpritOptIndex")));
+
+		AssertJUnit.assertEquals("The debug agent blamed the wrong method for " + test, plantedMethod, summary.get("culprit"));
+		AssertJUnit.assertEquals("The debug agent blamed the wrong optimization index for " + test,
+			Integer.toString(plantedOptIndex), summary.get("culpritOptIndex"));
+	}
+
+	private static Map<String, String> readSummary(File report) throws IOException {
+		String contents = new String(Files.readAllBytes(report.toPath()), StandardCharsets.UTF_8);
+		int summaryStart = contents.indexOf("\"summary\"");
+		AssertJUnit.assertTrue("The report " + report + " has no summary", summaryStart >= 0);
+
+		Map<String, String> summary = new HashMap<String, String>();
+		Matcher matcher = SUMMARY_MEMBER.matcher(contents.substring(summaryStart));
+		while (matcher.find()) {
+			summary.put(matcher.group(1), (null != matcher.group(2)) ? matcher.group(2) : matcher.group(3));
+		}
+		return summary;
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright IBM Corp. and others 2026
+ *
+ * This program and the accompanying materials are made available under
+ * the terms of the Eclipse Public License 2.0 which accompanies this
+ * distribution and is available at https://www.eclipse.org/legal/epl-2.0/
+ * or the Apache License, Version 2.0 which accompanies this distribution and
+ * is available at https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This Source Code may also be made available under the following
+ * Secondary Licenses when the conditions for such availability set
+ * forth in the Eclipse Public License, v. 2.0 are satisfied: GNU
+ * General Public License, version 2 with the GNU Classpath
+ * Exception [1] and GNU General Public License, version 2 with the
+ * OpenJDK Assembly Exception [2].
+ *
+ * [1] https://www.gnu.org/software/classpath/license.html
+ * [2] https://openjdk.org/legal/assembly-exception.html
+ *
+ * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
+ */
+package jit.test.debugAgent;
+
+import java.lang.reflect.InvocationTargetException;
+import java.lang.reflect.Method;
+import java.math.BigInteger;
+
+/**
+ * Runs one of the tests of the planted bugs through com.ibm.jit.JITHelpers.invoke the way a hooked
+ * java.lang.reflect.Method.invoke would, so a planted fault triggers the JIT debug agent. The tests turn a wrong
+ * result into the NullPointerException JITHelpers.invoke triggers the debug agent on. The debug agent exits the JVM
+ * once its investigation is done.
+ *
+ * Usage: PlantedBugRunner &lt;test&gt; &lt;iterations&gt;
+ */
+public class PlantedBugRunner {
+	private static final Object PASS = new Object();
+
+	private static void check(int actual, int expected) {
+		Object result = (actual == expected) ? PASS : null;
+		result.hashCode();
+	}
+
+	public static void testSumOfSquares() {
+		for (int n = 0; n < 100; ++n) {
+			check(PlantedMethods.sumOfSquares(n), n * (n + 1) * (2 * n + 1) / 6);
+		}
+	}
+
+	public static void testChecksum() {
+		int[] data = new int[64];
+		for (int n = 0; n < data.length; ++n) {
+			data[n] = n * 31;
+			long a = 1;
+			long b = 0;
+			for (int i = 0; i <= n; ++i) {
+				a += data[i];
+				b += a;
+			}
+			int[] prefix = new int[n + 1];
+			System.arraycopy(data, 0, prefix, 0, n + 1);
+			check(PlantedMethods.checksum(prefix), (int)(((b % 65521) << 16) | (a % 65521)));
+		}
+	}
+
+	public static void testGcd() {
+		for (int a = 1; a < 40; ++a) {
+			for (int b = 1; b < 40; ++b) {
+				check(PlantedMethods.gcd(a, b), BigInteger.valueOf(a).gcd(BigInteger.valueOf(b)).intValue());
+			}
+		}
+	}
+
+	public static void main(String[] args) throws Throwable {
+		Method test = PlantedBugRunner.class.getMethod(args[0]);
+		int iterations = Integer.parseInt(args[1]);
+
+		Method acquireMethodAccessor = Method.class.getDeclaredMethod("acquireMethodAccessor");
+		acquireMethodAccessor.setAccessible(true);
+		Object methodAccessor = acquireMethodAccessor.invoke(test);
+		Method invoke = Class.forName("com.ibm.jit.JITHelpers").getMethod("invoke", acquireMethodAccessor.getReturnType(), Object.class, Object[].class);
+
+		for (int i = 0; i < iterations; ++i) {
+			try {
+				invoke.invoke(null, methodAccessor, null, new Object[0]);
+			} catch (InvocationTargetException e) {
+				throw e.getCause();
+			}
+		}
+
+		System.out.println("The planted fault was not triggered by " + args[0]);
+		System.exit(2);
+	}
+}
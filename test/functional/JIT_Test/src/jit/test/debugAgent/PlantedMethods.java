@@ -0,0 +1,56 @@
+/*
+ * Copyright IBM Corp. and others 2026
+ *
+ * This program and the accompanying materials are made available under
+ * the terms of the Eclipse Public License 2.0 which accompanies this
+ * distribution and is available at https://www.eclipse.org/legal/epl-2.0/
+ * or the Apache License, Version 2.0 which accompanies this distribution and
+ * is available at https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This Source Code may also be made available under the following
+ * Secondary Licenses when the conditions for such availability set
+ * forth in the Eclipse Public License, v. 2.0 are satisfied: GNU
+ * General Public License, version 2 with the GNU Classpath
+ * Exception [1] and GNU General Public License, version 2 with the
+ * OpenJDK Assembly Exception [2].
+ *
+ * [1] https://www.gnu.org/software/classpath/license.html
+ * [2] https://openjdk.org/legal/assembly-exception.html
+ *
+ * SPDX-License-Identifier: EPL-2.0 OR Apache-2.0 OR GPL-2.0-only WITH Classpath-exception-2.0 OR GPL-2.0-only WITH OpenJDK-assembly-exception-1.0
+ */
+package jit.test.debugAgent;
+
+/**
+ * Methods the debug agent benchmark plants faults into with -Xjit:debugAgentFaultMethod. A planted fault corrupts the
+ * value the method returns, see {@link PlantedBugRunner} for how the corruption is detected. The methods must not be
+ * inlined into their callers, otherwise the callers compute the correct value.
+ */
+public class PlantedMethods {
+	public static int sumOfSquares(int n) {
+		int sum = 0;
+		for (int i = 1; i <= n; ++i) {
+			sum += i * i;
+		}
+		return sum;
+	}
+
+	public static int checksum(int[] data) {
+		int a = 1;
+		int b = 0;
+		for (int i = 0; i < data.length; ++i) {
+			a = (a + data[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		return (b << 16) | a;
+	}
+
+	public static int gcd(int a, int b) {
+		while (b != 0) {
+			int t = a % b;
+			a = b;
+			b = t;
+		}
+		return a;
+	}
+}